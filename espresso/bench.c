@@ -0,0 +1,313 @@
+/*
+    bench.c -- espbench, the benchmark of espresso over the examples
+
+        espbench [-u] [-r runs] [-l secs] [-c pct] [-t pct] [-m pct]
+                 -b baseline espresso examples
+
+    Every example is minimized with each of the option profiles below,
+    and its final cost (cubes and literals, as printed by -s), CPU time
+    (user + system of the espresso process) and peak resident set size
+    are compared with the line of the baseline file for the example and
+    profile:
+
+        # profile example cubes literals cpu_ms maxrss_kb
+        default math/rd53 31 175 1 1536
+
+    A result is bad when it costs more cubes or literals than the
+    baseline (more than -c percent, 0 by default), takes more than -t
+    percent more time (50, with 20 ms of slack for the short runs) or
+    more than -m percent more memory (25, with 512 kB of slack), or does
+    not finish within -l seconds of CPU time (60).  With -r the time is
+    the best of that many runs.  The exit status is 1 when a result is
+    bad.  The baseline only says something about the times of the
+    machine it was made on; to start from a new one, -u minimizes every
+    example of the math, indust and random directories (the .pla files
+    of doc are text) and writes the results to the baseline file.  The
+    cases over the -l limit are left out of it.
+
+    "make bench" and "make bench-baseline" in the espresso directory
+    build espbench and run it on examples/bench.baseline.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+static struct {
+  char *name;
+  char *option;
+} profiles[] = {{"default", NULL},
+                {"exact", "-Dexact"},
+                {"so", "-Dso"},
+                {"simplify", "-Dsimplify"},
+                {NULL, NULL}};
+
+static char *dirs[] = {"math", "indust", "random", NULL};
+
+typedef struct {
+  int cubes, literals; /* the cost of the result */
+  long cpu;            /* ms */
+  long rss;            /* kB */
+} result_t;
+
+static char *espresso, *examples;
+static int runs = 1;
+static long limit = 60;
+static double cost_tol = 0, time_tol = 50, mem_tol = 25;
+
+/* run -- minimize the example file with profile p; FALSE if it failed */
+static int run(p, file, r) int p;
+char *file;
+result_t *r;
+{
+  char path[1024], line[1024], *argv[6], *s;
+  int fd[2], status, argc, ok;
+  struct rusage ru;
+  struct rlimit rl;
+  FILE *fp;
+  pid_t pid;
+
+  (void)sprintf(path, "%s/%s", examples, file);
+  argc = 0;
+  argv[argc++] = espresso;
+  argv[argc++] = "-s";
+  argv[argc++] = "-x";
+  if (profiles[p].option != NULL)
+    argv[argc++] = profiles[p].option;
+  argv[argc++] = path;
+  argv[argc] = NULL;
+
+  if (pipe(fd) != 0) {
+    perror("pipe");
+    return 0;
+  }
+  if ((pid = fork()) < 0) {
+    perror("fork");
+    return 0;
+  }
+  if (pid == 0) {
+    rl.rlim_cur = rl.rlim_max = limit;
+    (void)setrlimit(RLIMIT_CPU, &rl);
+    (void)dup2(fd[1], 1);
+    (void)close(fd[0]);
+    (void)close(fd[1]);
+    (void)freopen("/dev/null", "w", stderr);
+    (void)execv(espresso, argv);
+    _exit(127);
+  }
+  (void)close(fd[1]);
+
+  /* the last cost line of the summary is the cost of the result */
+  ok = 0;
+  fp = fdopen(fd[0], "r");
+  while (fgets(line, sizeof(line), fp) != NULL)
+    if ((s = strstr(line, "cost is c=")) != NULL) {
+      r->cubes = atoi(s + 10);
+      if ((s = strstr(s, "tot=")) != NULL) {
+        r->literals = atoi(s + 4);
+        ok = 1;
+      }
+    }
+  (void)fclose(fp);
+
+  if (wait4(pid, &status, 0, &ru) != pid)
+    return 0;
+  r->cpu = (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000L +
+           (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1000;
+  r->rss = ru.ru_maxrss;
+  return ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/* measure -- the best of the runs of an example */
+static int measure(p, file, r) int p;
+char *file;
+result_t *r;
+{
+  result_t next;
+  int i;
+
+  if (!run(p, file, r))
+    return 0;
+  for (i = 1; i < runs; i++) {
+    if (!run(p, file, &next))
+      return 0;
+    if (next.cpu < r->cpu)
+      r->cpu = next.cpu;
+    if (next.rss < r->rss)
+      r->rss = next.rss;
+  }
+  return 1;
+}
+
+static int worse(new, old, pct, slack) double new, old, pct, slack;
+{ return new > old * (1 + pct / 100) + slack; }
+
+/* compare -- run every case of the baseline file; the number of bad ones */
+static int compare(baseline) char *baseline;
+{
+  char line[1024], name[64], file[1024], *why;
+  result_t old, new;
+  int p, n, bad, cases;
+  FILE *fp;
+
+  if ((fp = fopen(baseline, "r")) == NULL) {
+    perror(baseline);
+    exit(2);
+  }
+  (void)printf("# %-8s %-22s %13s %13s %13s %15s\n", "profile", "example",
+               "cubes", "literals", "cpu_ms", "maxrss_kb");
+  bad = cases = 0;
+  for (n = 1; fgets(line, sizeof(line), fp) != NULL; n++) {
+    if (line[0] == '#' || line[0] == '\n')
+      continue;
+    if (sscanf(line, "%63s %1023s %d %d %ld %ld", name, file, &old.cubes,
+               &old.literals, &old.cpu, &old.rss) != 6) {
+      (void)fprintf(stderr, "%s:%d: bad line\n", baseline, n);
+      exit(2);
+    }
+    for (p = 0; profiles[p].name != NULL; p++)
+      if (strcmp(profiles[p].name, name) == 0)
+        break;
+    if (profiles[p].name == NULL) {
+      (void)fprintf(stderr, "%s:%d: no profile %s\n", baseline, n, name);
+      exit(2);
+    }
+
+    cases++;
+    why = NULL;
+    if (!measure(p, file, &new)) {
+      new.cubes = new.literals = 0;
+      why = "FAILED";
+    } else if (worse((double)new.cubes, (double)old.cubes, cost_tol, 0.) ||
+               worse((double)new.literals, (double)old.literals, cost_tol,
+                     0.))
+      why = "COST";
+    else if (worse((double)new.cpu, (double)old.cpu, time_tol, 20.))
+      why = "TIME";
+    else if (worse((double)new.rss, (double)old.rss, mem_tol, 512.))
+      why = "MEMORY";
+    if (why != NULL)
+      bad++;
+    (void)printf("%-10s %-22s %6d/%-6d %6d/%-6d %6ld/%-6ld %7ld/%-7ld %s\n",
+                 name, file, new.cubes, old.cubes, new.literals, old.literals,
+                 new.cpu, old.cpu, new.rss, old.rss, why ? why : "ok");
+    (void)fflush(stdout);
+  }
+  (void)fclose(fp);
+  (void)printf("# %d cases, %d bad\n", cases, bad);
+  return bad;
+}
+
+static int by_name(a, b) const void *a, *b;
+{ return strcmp(*(char **)a, *(char **)b); }
+
+/* update -- measure every example with every profile into the baseline */
+static void update(baseline) char *baseline;
+{
+  char path[1024], **files;
+  int i, d, p, nfiles, max;
+  struct dirent *de;
+  result_t r;
+  DIR *dp;
+  FILE *fp;
+
+  nfiles = 0;
+  files = (char **)malloc((max = 256) * sizeof(char *));
+  for (d = 0; dirs[d] != NULL; d++) {
+    (void)sprintf(path, "%s/%s", examples, dirs[d]);
+    if ((dp = opendir(path)) == NULL) {
+      perror(path);
+      exit(2);
+    }
+    while ((de = readdir(dp)) != NULL) {
+      if (de->d_name[0] == '.')
+        continue;
+      if (nfiles == max)
+        files = (char **)realloc(files, (max *= 2) * sizeof(char *));
+      files[nfiles] = malloc(strlen(dirs[d]) + strlen(de->d_name) + 2);
+      (void)sprintf(files[nfiles++], "%s/%s", dirs[d], de->d_name);
+    }
+    (void)closedir(dp);
+  }
+  qsort(files, nfiles, sizeof(char *), by_name);
+
+  if ((fp = fopen(baseline, "w")) == NULL) {
+    perror(baseline);
+    exit(2);
+  }
+  (void)fprintf(fp, "# espresso benchmark baseline, made by espbench -u\n");
+  (void)fprintf(fp, "# profile example cubes literals cpu_ms maxrss_kb\n");
+  for (p = 0; profiles[p].name != NULL; p++)
+    for (i = 0; i < nfiles; i++) {
+      if (measure(p, files[i], &r))
+        (void)fprintf(fp, "%s %s %d %d %ld %ld\n", profiles[p].name,
+                      files[i], r.cubes, r.literals, r.cpu, r.rss);
+      else
+        (void)fprintf(stderr, "%s %s: left out (failed, or over %ld s)\n",
+                      profiles[p].name, files[i], limit);
+    }
+  (void)fclose(fp);
+}
+
+static void usage(prog) char *prog;
+{
+  (void)fprintf(stderr,
+                "usage: %s [-u] [-r runs] [-l secs] [-c pct] [-t pct] "
+                "[-m pct] -b baseline espresso examples\n",
+                prog);
+  exit(2);
+}
+
+int main(argc, argv) int argc;
+char *argv[];
+{
+  char *baseline = NULL;
+  int c, do_update = 0;
+  extern char *optarg;
+  extern int optind;
+
+  while ((c = getopt(argc, argv, "b:c:l:m:r:t:u")) != EOF) {
+    switch (c) {
+    case 'b':
+      baseline = optarg;
+      break;
+    case 'c':
+      cost_tol = atof(optarg);
+      break;
+    case 'l':
+      limit = atol(optarg);
+      break;
+    case 'm':
+      mem_tol = atof(optarg);
+      break;
+    case 'r':
+      runs = atoi(optarg);
+      break;
+    case 't':
+      time_tol = atof(optarg);
+      break;
+    case 'u':
+      do_update = 1;
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+  if (baseline == NULL || argc - optind != 2 || runs < 1 || limit < 1)
+    usage(argv[0]);
+  espresso = argv[optind];
+  examples = argv[optind + 1];
+
+  if (do_update) {
+    update(baseline);
+    return 0;
+  }
+  return compare(baseline) != 0;
+}
@@ -26,6 +26,14 @@
     slow, especially for the recursive descent of the espresso
     routines.  Therefore, a special cofactor routine "scofactor" is
     provided which assumes the cofactor is only in a single variable.
+
+    Cube lists, together with their T[0] cube, are not malloc'ed: they
+    are carved from a stack of chunks private to the minimizer
+    (cdata.stack), as are the temporary cubes of the unate recursion
+    (new_temp_cube).  The recursion releases them in nearly LIFO order; a
+    block freed while blocks above it are still in use is only marked,
+    and its space comes back once everything above it is gone.  A list
+    must be released with free_cubelist(), never with FREE().
 */
 
 /* cofactor -- compute the cofactor of a cover with respect to a cube */
@@ -38,11 +46,11 @@ pcube *cofactor(IN pcube *T, IN register pcube c)
   listlen = CUBELISTSIZE(T) + 5;
 
   /* Allocate a new list of cube pointers (max size is previous size) */
-  Tc_save = Tc = ALLOC(pcube, listlen);
+  Tc_save = Tc = new_cubelist(listlen);
 
   /* pass on which variables have been cofactored against */
-  *Tc++ = set_or(new_cube(), T[0], set_diff(temp, cube.fullset, c));
-  Tc++;
+  (void)set_or(Tc[0], T[0], set_diff(temp, cube.fullset, c));
+  Tc += 2;
 
   /* Loop for each cube in the list, determine suitability, and save */
   for (T1 = T + 2; (p = *T1++) != NULL;) {
@@ -54,7 +62,7 @@ pcube *cofactor(IN pcube *T, IN register pcube c)
 #else
       {
         register int w, last;
-        register unsigned int x;
+        register set_word_t x;
         if ((last = cube.inword) != -1) {
           x = p[last] & c[last];
           if (~(x | x >> 1) & cube.inmask)
@@ -107,11 +115,11 @@ pcube *scofactor(IN pcube *T, IN pcube *c, IN int var){
   listlen = CUBELISTSIZE(T) + 5;
 
   /* Allocate a new list of cube pointers (max size is previous size) */
-  Tc_save = Tc = ALLOC(pcube, listlen);
+  Tc_save = Tc = new_cubelist(listlen);
 
   /* pass on which variables have been cofactored against */
-  *Tc++ = set_or(new_cube(), T[0], set_diff(mask, cube.fullset, c));
-  Tc++;
+  (void)set_or(Tc[0], T[0], set_diff(mask, cube.fullset, c));
+  Tc += 2;
 
   /* Setup for the quick distance check */
   (void)set_and(mask, cube.var_mask[var], c);
@@ -148,12 +156,22 @@ void massive_count(T) IN pcube *T;
   /* Count the number of zeros in each column */
   {
     register int i, *cnt;
-    register unsigned int val;
+    register set_word_t val;
     register pcube p, cof = T[0], full = cube.fullset;
     for (T1 = T + 2; (p = *T1++) != NULL;)
       for (i = LOOP(p); i > 0; i--)
         if (val = full[i] & ~(p[i] | cof[i])) {
           cnt = count + ((i - 1) << LOGBPI);
+#if BPI == 64
+          /* no unrolled form for 64-bit words; visit the set bits */
+          do
+#ifdef __GNUC__
+            cnt[__builtin_ctzll(val)]++;
+#else
+            cnt[bit_index(val)]++;
+#endif
+          while (val &= val - 1);
+#else
 #if BPI == 32
           if (val & 0xFF000000) {
             if (val & 0x80000000)
@@ -228,6 +246,7 @@ void massive_count(T) IN pcube *T;
             if (val & 0x0001)
               cnt[0]++;
           }
+#endif
         }
   }
 
@@ -326,9 +345,8 @@ pcube *cube1list(A) pcover A;
 {
   register pcube last, p, *plist, *list;
 
-  list = plist = ALLOC(pcube, A->count + 3);
-  *plist++ = new_cube();
-  plist++;
+  list = plist = new_cubelist(A->count + 3);
+  plist += 2;
   foreach_set(A, last, p) { *plist++ = p; }
   *plist++ = NULL; /* sentinel */
   list[1] = (pcube)plist;
@@ -339,9 +357,8 @@ pcube *cube2list(A, B) pcover A, B;
 {
   register pcube last, p, *plist, *list;
 
-  list = plist = ALLOC(pcube, A->count + B->count + 3);
-  *plist++ = new_cube();
-  plist++;
+  list = plist = new_cubelist(A->count + B->count + 3);
+  plist += 2;
   foreach_set(A, last, p) { *plist++ = p; }
   foreach_set(B, last, p) { *plist++ = p; }
   *plist++ = NULL;
@@ -353,10 +370,8 @@ pcube *cube3list(A, B, C) pcover A, B, C;
 {
   register pcube last, p, *plist, *list;
 
-  plist = ALLOC(pcube, A->count + B->count + C->count + 3);
-  list = plist;
-  *plist++ = new_cube();
-  plist++;
+  list = plist = new_cubelist(A->count + B->count + C->count + 3);
+  plist += 2;
   foreach_set(A, last, p) { *plist++ = p; }
   foreach_set(B, last, p) { *plist++ = p; }
   foreach_set(C, last, p) { *plist++ = p; }
@@ -401,3 +416,128 @@ simplify_cubelist(T) pcube *T;
   *Tdest++ = NULL;         /* sentinel */
   Tdest[1] = (pcube)Tdest; /* save pointer to last */
 }
+
+/* ---------------- the cube stack ---------------- */
+
+#define CS_CHUNK 65536 /* bytes in an ordinary chunk */
+#define CS_ROUND(n) (((n) + 7) & ~7L)
+
+typedef struct cs_chunk {
+  struct cs_chunk *prev; /* chunk below this one */
+  char *top;             /* first free byte */
+  char *end;             /* end of the chunk */
+} cs_chunk;
+
+typedef struct cs_block {
+  struct cs_block *below; /* block below this one on the stack */
+  cs_chunk *chunk;        /* chunk holding this block */
+  long freed;             /* released, waiting for the blocks above */
+} cs_block;
+
+struct cube_stack {
+  cs_chunk *chunk; /* chunk holding the top of the stack */
+  cs_chunk *spare; /* an emptied chunk kept for reuse */
+  cs_block *top;   /* most recent block (freed or not) */
+};
+
+#define CS_BASE(c) ((char *)(c) + CS_ROUND(sizeof(cs_chunk)))
+
+/* cs_alloc -- push a block of n bytes on the cube stack */
+static char *cs_alloc(n) long n;
+{
+  register struct cube_stack *s = cdata.stack;
+  register cs_chunk *c;
+  register cs_block *b;
+  long size;
+
+  if (s == NULL) {
+    s = cdata.stack = ALLOC(struct cube_stack, 1);
+    s->chunk = s->spare = NULL;
+    s->top = NULL;
+  }
+
+  n = CS_ROUND(n + sizeof(cs_block));
+  if ((c = s->chunk) == NULL || c->top + n > c->end) {
+    if ((c = s->spare) != NULL && CS_BASE(c) + n <= c->end) {
+      s->spare = NULL;
+    } else {
+      size = MAX(CS_CHUNK, CS_ROUND(sizeof(cs_chunk)) + n);
+      c = (cs_chunk *)ALLOC(char, size);
+      c->end = (char *)c + size;
+    }
+    c->top = CS_BASE(c);
+    c->prev = s->chunk;
+    s->chunk = c;
+  }
+
+  b = (cs_block *)c->top;
+  c->top += n;
+  b->below = s->top;
+  b->chunk = c;
+  b->freed = FALSE;
+  s->top = b;
+  return (char *)(b + 1);
+}
+
+/* cs_free -- release a block, and pop every released block on top */
+static void cs_free(p) char *p;
+{
+  register struct cube_stack *s = cdata.stack;
+  register cs_block *b = (cs_block *)p - 1;
+  register cs_chunk *c;
+
+  b->freed = TRUE;
+  while ((b = s->top) != NULL && b->freed) {
+    s->top = b->below;
+    c = b->chunk;
+    c->top = (char *)b;
+    if (c->top == CS_BASE(c) && c->prev != NULL) {
+      s->chunk = c->prev;
+      if (s->spare != NULL)
+        FREE(s->spare);
+      s->spare = c;
+    }
+  }
+}
+
+/* new_cubelist -- allocate a cube list of n entries with an empty T[0] */
+pcube *new_cubelist(n) int n;
+{
+  register pcube *T;
+
+  T = (pcube *)cs_alloc((long)n * sizeof(pcube) +
+                        SET_SIZE(cube.size) * sizeof(set_word_t));
+  T[0] = set_clear((pcube)(T + n), cube.size);
+  return T;
+}
+
+/* free_cubelist -- release a cube list (and its T[0]) */
+void free_cubelist(T) pcube *T;
+{ cs_free((char *)T); }
+
+/* new_temp_cube -- allocate an empty cube on the cube stack */
+pcube new_temp_cube() {
+  return set_clear((pcube)cs_alloc(SET_SIZE(cube.size) * sizeof(set_word_t)),
+                   cube.size);
+}
+
+/* free_temp_cube -- release a cube from new_temp_cube() */
+void free_temp_cube(p) pcube p;
+{ cs_free((char *)p); }
+
+/* free_cube_stack -- release the cube stack (and every block still on it) */
+void free_cube_stack() {
+  register struct cube_stack *s = cdata.stack;
+  register cs_chunk *c, *prev;
+
+  if (s == NULL)
+    return;
+  for (c = s->chunk; c != NULL; c = prev) {
+    prev = c->prev;
+    FREE(c);
+  }
+  if (s->spare != NULL)
+    FREE(s->spare);
+  FREE(s);
+  cdata.stack = NULL;
+}
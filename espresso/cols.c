@@ -10,13 +10,8 @@
 sm_col *sm_col_alloc() {
   register sm_col *pcol;
 
-#ifdef FAST_AND_LOOSE
-  if (sm_col_freelist == NIL(sm_col)) {
-    pcol = ALLOC(sm_col, 1);
-  } else {
-    pcol = sm_col_freelist;
-    sm_col_freelist = pcol->next_col;
-  }
+#ifndef SM_NO_POOL
+  sm_pool_get(sm_col, pcol, sm_col_freelist, next_col);
 #else
   pcol = ALLOC(sm_col, 1);
 #endif
@@ -31,30 +26,21 @@ sm_col *sm_col_alloc() {
 }
 
 /*
- *  free a col vector -- for FAST_AND_LOOSE, this is real cheap for cols;
- *  however, freeing a rowumn must still walk down the rowumn discarding
- *  the elements one-by-one; that is the only use for the extra '-DCOLS'
- *  compile flag ...
+ *  free a col vector
  */
 void sm_col_free(pcol) register sm_col *pcol;
 {
-#if defined(FAST_AND_LOOSE) && !defined(COLS)
-  if (pcol->first_row != NIL(sm_element)) {
-    /* Add the linked list of col items to the free list */
-    pcol->last_row->next_row = sm_element_freelist;
-    sm_element_freelist = pcol->first_row;
-  }
-
-  /* Add the col to the free list of cols */
-  pcol->next_col = sm_col_freelist;
-  sm_col_freelist = pcol;
-#else
   register sm_element *p, *pnext;
 
   for (p = pcol->first_row; p != 0; p = pnext) {
     pnext = p->next_row;
     sm_element_free(p);
   }
+#ifndef SM_NO_POOL
+  /* Add the col to the free list of cols */
+  pcol->next_col = sm_col_freelist;
+  sm_col_freelist = pcol;
+#else
   FREE(pcol);
 #endif
 }
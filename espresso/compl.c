@@ -41,6 +41,17 @@ static bool simp_comp_special_cases();
 
 static bool simplify_special_cases();
 
+/* one branch of complement(), possibly run by another thread */
+typedef struct {
+  pcube *T;      /* cube list being split */
+  pcube c;       /* cube to cofactor against */
+  int var;       /* the splitting variable */
+  pcover result; /* complement of the cofactor */
+} compl_branch_t;
+
+static void compl_branch(b) compl_branch_t *b;
+{ b->result = complement(scofactor(b->T, b->c, b->var)); }
+
 /* complement -- compute the complement of T */
 pcover complement(T) pcube *T; /* T will be disposed of */
 {
@@ -48,7 +59,11 @@ pcover complement(T) pcube *T; /* T will be disposed of */
   register int best;
   pcover Tbar, Tl, Tr;
   int lifting;
-  static int compl_level = 0;
+  compl_branch_t right;
+  task_t task;
+  static ESPRESSO_TLS int compl_level = 0;
+
+  PROFILE_IN(CUBELISTSIZE(T));
 
   if (debug & COMPL)
     debug_print(T, "COMPLEMENT", compl_level++);
@@ -56,13 +71,21 @@ pcover complement(T) pcube *T; /* T will be disposed of */
   if (compl_special_cases(T, &Tbar) == MAYBE) {
 
     /* Allocate space for the partition cubes */
-    cl = new_cube();
-    cr = new_cube();
+    cl = new_temp_cube();
+    cr = new_temp_cube();
     best = binate_split_select(T, cl, cr, COMPL);
 
     /* Complement the left and right halves */
-    Tl = complement(scofactor(T, cl, best));
-    Tr = complement(scofactor(T, cr, best));
+    if (task_active(CUBELISTSIZE(T))) {
+      right.T = T, right.c = cr, right.var = best;
+      task_spawn(&task, compl_branch, (char *)&right);
+      Tl = complement(scofactor(T, cl, best));
+      (void)task_join(&task, TRUE);
+      Tr = right.result;
+    } else {
+      Tl = complement(scofactor(T, cl, best));
+      Tr = complement(scofactor(T, cr, best));
+    }
 
     if (Tr->count * Tl->count > (Tr->count + Tl->count) * CUBELISTSIZE(T)) {
       lifting = USE_COMPL_LIFT_ONSET;
@@ -71,8 +94,8 @@ pcover complement(T) pcube *T; /* T will be disposed of */
     }
     Tbar = compl_merge(T, Tl, Tr, cl, cr, best, lifting);
 
-    free_cube(cl);
-    free_cube(cr);
+    free_temp_cube(cl);
+    free_temp_cube(cr);
     free_cubelist(T);
   }
 
@@ -112,18 +135,18 @@ pcover *Tbar;          /* returned only if answer determined */
   }
 
   /* Check for a column of all 0's which can be factored out */
-  ceil = set_save(cof);
+  ceil = set_copy(new_temp_cube(), cof);
   for (T1 = T + 2; (p = *T1++) != NULL;) {
     INLINEset_or(ceil, ceil, p);
   }
   if (!setp_equal(ceil, cube.fullset)) {
     ceil_compl = compl_cube(ceil);
     (void)set_or(cof, cof, set_diff(ceil, cube.fullset, ceil));
-    set_free(ceil);
+    free_temp_cube(ceil);
     *Tbar = sf_append(complement(T), ceil_compl);
     return TRUE;
   }
-  set_free(ceil);
+  free_temp_cube(ceil);
 
   /* Collect column counts, determine unate variables, etc. */
   massive_count(T);
@@ -415,7 +438,7 @@ pcover *Tbar;
   register int best;
   pcover Tl, Tr, Tlbar, Trbar;
   int lifting;
-  static int simplify_level = 0;
+  static ESPRESSO_TLS int simplify_level = 0;
 
   if (debug & COMPL)
     debug_print(T, "SIMPCOMP", simplify_level++);
@@ -423,8 +446,8 @@ pcover *Tbar;
   if (simp_comp_special_cases(T, Tnew, Tbar) == MAYBE) {
 
     /* Allocate space for the partition cubes */
-    cl = new_cube();
-    cr = new_cube();
+    cl = new_temp_cube();
+    cr = new_temp_cube();
     best = binate_split_select(T, cl, cr, COMPL);
 
     /* Complement the left and right halves */
@@ -443,8 +466,8 @@ pcover *Tbar;
       *Tnew = cubeunlist(T);
     }
 
-    free_cube(cl);
-    free_cube(cr);
+    free_temp_cube(cl);
+    free_temp_cube(cr);
     free_cubelist(T);
   }
 
@@ -492,15 +515,15 @@ pcover *Tbar;                /* returned only if answer determined */
   }
 
   /* Check for a column of all 0's which can be factored out */
-  ceil = set_save(cof);
+  ceil = set_copy(new_temp_cube(), cof);
   for (T1 = T + 2; (p = *T1++) != NULL;) {
     INLINEset_or(ceil, ceil, p);
   }
   if (!setp_equal(ceil, cube.fullset)) {
-    p = new_cube();
+    p = new_temp_cube();
     (void)set_diff(p, cube.fullset, ceil);
     (void)set_or(cof, cof, p);
-    set_free(p);
+    free_temp_cube(p);
     simp_comp(T, Tnew, Tbar);
 
     /* Adjust the ON-set */
@@ -509,10 +532,10 @@ pcover *Tbar;                /* returned only if answer determined */
 
     /* Compute the new complement */
     *Tbar = sf_append(*Tbar, compl_cube(ceil));
-    set_free(ceil);
+    free_temp_cube(ceil);
     return TRUE;
   }
-  set_free(ceil);
+  free_temp_cube(ceil);
 
   /* Collect column counts, determine unate variables, etc. */
   massive_count(T);
@@ -551,7 +574,9 @@ pcover simplify(T) pcube *T; /* T will be disposed of */
   register int best;
   pcover Tbar, Tl, Tr;
   int lifting;
-  static int simplify_level = 0;
+  static ESPRESSO_TLS int simplify_level = 0;
+
+  PROFILE_IN(CUBELISTSIZE(T));
 
   if (debug & COMPL) {
     debug_print(T, "SIMPLIFY", simplify_level++);
@@ -560,8 +585,8 @@ pcover simplify(T) pcube *T; /* T will be disposed of */
   if (simplify_special_cases(T, &Tbar) == MAYBE) {
 
     /* Allocate space for the partition cubes */
-    cl = new_cube();
-    cr = new_cube();
+    cl = new_temp_cube();
+    cr = new_temp_cube();
 
     best = binate_split_select(T, cl, cr, COMPL);
 
@@ -578,8 +603,8 @@ pcover simplify(T) pcube *T; /* T will be disposed of */
       Tbar = cubeunlist(T);
     }
 
-    free_cube(cl);
-    free_cube(cr);
+    free_temp_cube(cl);
+    free_temp_cube(cr);
     free_cubelist(T);
   }
 
@@ -621,23 +646,23 @@ pcover *Tnew;          /* returned only if answer determined */
   }
 
   /* Check for a column of all 0's which can be factored out */
-  ceil = set_save(cof);
+  ceil = set_copy(new_temp_cube(), cof);
   for (T1 = T + 2; (p = *T1++) != NULL;) {
     INLINEset_or(ceil, ceil, p);
   }
   if (!setp_equal(ceil, cube.fullset)) {
-    p = new_cube();
+    p = new_temp_cube();
     (void)set_diff(p, cube.fullset, ceil);
     (void)set_or(cof, cof, p);
-    free_cube(p);
+    free_temp_cube(p);
 
     A = simplify(T);
     foreach_set(A, last, p) { INLINEset_and(p, p, ceil); }
     *Tnew = A;
-    set_free(ceil);
+    free_temp_cube(ceil);
     return TRUE;
   }
-  set_free(ceil);
+  free_temp_cube(ceil);
 
   /* Collect column counts, determine unate variables, etc. */
   massive_count(T);
@@ -12,10 +12,25 @@
     comparing each cube to its neighbor.  Finally, because the cubes
     are sorted by size, we need only check cubes which are larger (or
     smaller) than a given cube for containment.
+
+    Large families (CONTAIN_BIG sets or more) take a faster road to the
+    same result: equal sets are dropped with a hash table, the others
+    are bucketed on their size and only each bucket is sorted, and the
+    containment sweep looks only at the sets filed under a compatible
+    signature key, comparing 64-bit signatures of a pair of sets before
+    the sets themselves (see rm_contain_sig()).
 */
 
 #include "espresso.h"
 
+#define CONTAIN_BIG 256
+#define CONTAIN_KEY 16 /* most signature bits in the key */
+
+typedef unsigned long long csig_t;
+
+static pset *sf_hash_sort();
+static int rm_contain_sig();
+
 /*
     sf_contain -- perform containment on a set family (delete sets which
     are contained by some larger set in the family).  No assumptions are
@@ -27,10 +42,17 @@ pset_family sf_contain(A) INOUT pset_family A; /* disposes of A */
   int cnt;
   pset *A1;
   pset_family R;
-
-  A1 = sf_sort(A, descend);           /* sort into descending order */
-  cnt = rm_equal(A1, descend);        /* remove duplicates */
-  cnt = rm_contain(A1);               /* remove contained sets */
+  csig_t *sig;
+
+  if (A->count >= CONTAIN_BIG) {
+    A1 = sf_hash_sort(A, descend, (pset)NULL, &sig);
+    cnt = rm_contain_sig(A1, sig, FALSE);
+    FREE(sig);
+  } else {
+    A1 = sf_sort(A, descend);    /* sort into descending order */
+    cnt = rm_equal(A1, descend); /* remove duplicates */
+    cnt = rm_contain(A1);        /* remove contained sets */
+  }
   R = sf_unlist(A1, cnt, A->sf_size); /* recreate the set family */
   sf_free(A);
   return R;
@@ -46,10 +68,17 @@ pset_family sf_rev_contain(A) INOUT pset_family A; /* disposes of A */
   int cnt;
   pset *A1;
   pset_family R;
-
-  A1 = sf_sort(A, ascend);            /* sort into ascending order */
-  cnt = rm_equal(A1, ascend);         /* remove duplicates */
-  cnt = rm_rev_contain(A1);           /* remove containing sets */
+  csig_t *sig;
+
+  if (A->count >= CONTAIN_BIG) {
+    A1 = sf_hash_sort(A, ascend, (pset)NULL, &sig);
+    cnt = rm_contain_sig(A1, sig, TRUE);
+    FREE(sig);
+  } else {
+    A1 = sf_sort(A, ascend);     /* sort into ascending order */
+    cnt = rm_equal(A1, ascend);  /* remove duplicates */
+    cnt = rm_rev_contain(A1);    /* remove containing sets */
+  }
   R = sf_unlist(A1, cnt, A->sf_size); /* recreate the set family */
   sf_free(A);
   return R;
@@ -85,8 +114,14 @@ pset_family sf_dupl(A) INOUT pset_family A; /* disposes of A */
   register pset *A1;
   pset_family R;
 
-  A1 = sf_sort(A, descend);           /* sort the set family */
-  cnt = rm_equal(A1, descend);        /* remove duplicates */
+  if (A->count >= CONTAIN_BIG) {
+    A1 = sf_hash_sort(A, descend, (pset)NULL, (csig_t **)NULL);
+    for (cnt = 0; A1[cnt] != NULL; cnt++)
+      ;
+  } else {
+    A1 = sf_sort(A, descend);    /* sort the set family */
+    cnt = rm_equal(A1, descend); /* remove duplicates */
+  }
   R = sf_unlist(A1, cnt, A->sf_size); /* recreate the set family */
   sf_free(A);
   return R;
@@ -126,8 +161,14 @@ IN pset mask; /* defines variables to mask out */
   pset_family R;
 
   (void)set_copy(cube.temp[0], mask);
-  A1 = sf_sort(A, d1_order);
-  cnt = d1_rm_equal(A1, d1_order);
+  if (A->count >= CONTAIN_BIG) {
+    A1 = sf_hash_sort(A, d1_order, mask, (csig_t **)NULL);
+    for (cnt = 0; A1[cnt] != NULL; cnt++)
+      ;
+  } else {
+    A1 = sf_sort(A, d1_order);
+    cnt = d1_rm_equal(A1, d1_order);
+  }
   R = sf_unlist(A1, cnt, A->sf_size);
   sf_free(A);
   return R;
@@ -287,6 +328,220 @@ IN pset *B1;                            /* unchanged */
   return pdest - A1; /* # elements in A1 */
 }
 
+/*
+    sf_hash_sort -- as sf_sort() followed by rm_equal() (or, when "mask"
+    is given, d1_rm_equal()) for a large family
+
+    Each set is looked up in a hash table of the sets seen so far; an
+    equal set replaces the one found (the sort kept the last of equal
+    sets) or, under a mask, is or-ed into it.  The remaining sets are
+    counted into buckets of equal size and each bucket is sorted on its
+    own.  If "psig" is given the signatures of the sets (see
+    rm_contain_sig()) are returned in it, in the order of the list.
+*/
+static pset *sf_hash_sort(A, compare, mask, psig) IN pset_family A;
+IN int (*compare)();
+IN pset mask;
+OUT csig_t **psig;
+{
+  register pset p, q, last;
+  register int i, h;
+  register unsigned int hash;
+  register set_word_t w;
+  pset *list, *A1;
+  int n, nslot, *slot, *start, size;
+  csig_t *sig, ones, zeros;
+
+  /* hash each set (under the mask) into a table at most half full */
+  for (nslot = 1024; nslot < 2 * A->count; nslot *= 2)
+    ;
+  slot = ALLOC(int, nslot);
+  for (h = 0; h < nslot; h++)
+    slot[h] = -1;
+  list = ALLOC(pset, A->count + 1);
+  n = 0;
+  foreach_set(A, last, p) {
+    PUTSIZE(p, set_ord(p)); /* compute the set size */
+    hash = 0;
+    for (i = LOOP(p); i > 0; i--) {
+      w = mask != NULL ? p[i] | mask[i] : p[i];
+      hash = hash * 0x9e3779b1U + (unsigned int)(w ^ (w >> 29));
+    }
+    for (h = (int)(hash & (unsigned int)(nslot - 1)); slot[h] >= 0;
+         h = (h + 1) & (nslot - 1)) {
+      q = list[slot[h]];
+      for (i = LOOP(p); i > 0; i--)
+        if (mask != NULL ? (p[i] | mask[i]) != (q[i] | mask[i]) : p[i] != q[i])
+          break;
+      if (i == 0)
+        break;
+    }
+    if (slot[h] < 0) {
+      slot[h] = n;
+      list[n++] = p;
+    } else if (mask == NULL) {
+      list[slot[h]] = p;
+    } else {
+      INLINEset_or(q, q, p);
+    }
+  }
+  FREE(slot);
+
+  if (mask != NULL) {
+    /* d1_order sorts on the masked sets only */
+    qsort((char *)list, n, sizeof(pset), compare);
+    list[n] = NULL;
+    A1 = list;
+  } else {
+    /* bucket the sets on their size, largest first for descend */
+    start = ALLOC(int, A->sf_size + 2);
+    for (size = 0; size <= A->sf_size + 1; size++)
+      start[size] = 0;
+    for (i = 0; i < n; i++) {
+      size = SIZE(list[i]);
+      start[compare == ascend ? size + 1 : A->sf_size - size + 1]++;
+    }
+    for (size = 1; size <= A->sf_size + 1; size++)
+      start[size] += start[size - 1];
+    A1 = ALLOC(pset, n + 1);
+    for (i = 0; i < n; i++) {
+      size = SIZE(list[i]);
+      A1[start[compare == ascend ? size : A->sf_size - size]++] = list[i];
+    }
+    A1[n] = NULL;
+    FREE(list);
+
+    /* start[k] now ends bucket k: sort each bucket */
+    for (size = 0, i = 0; size <= A->sf_size; i = start[size++])
+      if (start[size] - i > 1)
+        qsort((char *)(A1 + i), start[size] - i, sizeof(pset), compare);
+    FREE(start);
+  }
+
+  if (psig != NULL) {
+    *psig = sig = ALLOC(csig_t, 2 * n + 2);
+    for (i = 0; i < n; i++) {
+      p = A1[i];
+      ones = zeros = 0;
+      for (h = LOOP(p); h > 0; h--) {
+        ones |= (csig_t)p[h] << ((h * BPI) & 63);
+        zeros |= (csig_t)~p[h] << ((h * BPI) & 63);
+      }
+      sig[2 * i] = ones;
+      sig[2 * i + 1] = zeros;
+    }
+  }
+  return A1;
+}
+
+/*
+    rm_contain_sig -- rm_contain() (or, if "rev", rm_rev_contain()) over
+    the list of sf_hash_sort()
+
+    The signatures of a set or together its words, and its complemented
+    words, folded onto 64 bits; if a is contained in b, then so are the
+    ones of a in the ones of b, and the zeros of b in the zeros of a.
+    A few signature bits which split the family about evenly form a key,
+    and the kept sets are filed by key: a set need only be checked
+    against the files whose key is a subset of its own.
+*/
+typedef struct {
+  csig_t ones, zeros;
+  int index;
+} csig_entry_t;
+
+static int rm_contain_sig(A1, sig, rev) INOUT pset *A1; /* updated in place */
+IN csig_t *sig;
+IN bool rev;
+{
+  register pset a;
+  register csig_entry_t *e, *end;
+  register csig_t ones, zeros;
+  register int m;
+  int ia, n, k, i, j, best, key, check, dest = 0, last_size = -1;
+  int freq[64], bit[CONTAIN_KEY], *keys, *start, *fill;
+  bool used[64];
+  csig_entry_t *file;
+
+  /* the key is taken from the zeros (the ones for rev) of the sets */
+  for (n = 0; A1[n] != NULL; n++)
+    ;
+  for (i = 0; i < 64; i++)
+    freq[i] = 0, used[i] = FALSE;
+  for (ia = 0; ia < n; ia++)
+    for (ones = sig[2 * ia + (rev ? 0 : 1)], i = 0; ones != 0; ones >>= 1, i++)
+      freq[i] += (int)(ones & 1);
+  for (k = 0; k < CONTAIN_KEY && (n >> (k + 1)) > 0; k++) {
+    for (best = -1, i = 0; i < 64; i++)
+      if (!used[i] && freq[i] > n / 8 && freq[i] < n - n / 8 &&
+          (best < 0 || ABS(2 * freq[i] - n) < ABS(2 * freq[best] - n)))
+        best = i;
+    if (best < 0)
+      break;
+    used[best] = TRUE;
+    bit[k] = best;
+  }
+
+  /* one file per key, each with room for all the sets of that key */
+  keys = ALLOC(int, n);
+  start = ALLOC(int, (1 << k) + 1);
+  fill = ALLOC(int, 1 << k);
+  for (m = 0; m <= (1 << k); m++)
+    start[m] = 0;
+  for (ia = 0; ia < n; ia++) {
+    ones = sig[2 * ia + (rev ? 0 : 1)];
+    for (key = 0, j = 0; j < k; j++)
+      key |= (int)((ones >> bit[j]) & 1) << j;
+    keys[ia] = key;
+    start[key + 1]++;
+  }
+  for (m = 0; m < (1 << k); m++)
+    start[m + 1] += start[m];
+  for (m = 0; m < (1 << k); m++)
+    fill[m] = start[m];
+  file = ALLOC(csig_entry_t, MAX(n, 1));
+
+  for (ia = 0; (a = A1[ia]) != NULL; ia++) {
+    ones = sig[2 * ia];
+    zeros = sig[2 * ia + 1];
+    key = keys[ia];
+    /* Update the check pointer if the size has changed */
+    if (SIZE(a) != last_size)
+      last_size = SIZE(a), check = dest;
+    for (m = key;; m = (m - 1) & key) {
+      for (e = file + start[m], end = file + fill[m];
+           e < end && e->index < check; e++) {
+        if (rev) {
+          if ((e->ones & ~ones) != 0 || (zeros & ~e->zeros) != 0)
+            continue;
+          INLINEsetp_implies(A1[e->index], a, /* when_false => */ continue);
+        } else {
+          if ((ones & ~e->ones) != 0 || (e->zeros & ~zeros) != 0)
+            continue;
+          INLINEsetp_implies(a, A1[e->index], /* when_false => */ continue);
+        }
+        goto lnext1;
+      }
+      if (m == 0)
+        break;
+    }
+    /* set a was not contained by (did not contain) a kept set: save it */
+    e = file + fill[key]++;
+    e->ones = ones;
+    e->zeros = zeros;
+    e->index = dest;
+    A1[dest++] = a;
+  lnext1:;
+  }
+
+  FREE(keys);
+  FREE(start);
+  FREE(fill);
+  FREE(file);
+  A1[dest] = NULL;
+  return dest;
+}
+
 /* sf_sort -- sort the sets of A */
 pset *sf_sort(A, compare) IN pset_family A;
 IN int (*compare)();
@@ -1,6 +1,7 @@
 
 /*
-    Module: cubestr.c -- routines for managing the global cube structure
+    Module: cubestr.c -- routines for managing the cube structure and the
+    minimizer contexts which carry it
 */
 
 #include "espresso.h"
@@ -12,13 +13,46 @@
 
     If a part_size is < 0, then the field size is abs(part_size) and the
     field read from the input is symbolic.
+
+    A structure of the same shape put aside by keep_cube() is taken over
+    rather than built again.
 */
+
+static ESPRESSO_TLS pctx cube_spare = NULL; /* see keep_cube() */
+
+static bool take_spare_cube() {
+  register int var;
+  pctx spare = cube_spare;
+
+  cube_spare = NULL;
+  if (spare->cube.num_vars != cube.num_vars ||
+      spare->cube.num_binary_vars != cube.num_binary_vars) {
+    free_ctx(spare);
+    return FALSE;
+  }
+  for (var = cube.num_binary_vars; var < cube.num_vars; var++)
+    if (ABS(spare->cube.part_size[var]) != ABS(cube.part_size[var])) {
+      free_ctx(spare);
+      return FALSE;
+    }
+  for (var = 0; var < cube.num_binary_vars; var++)
+    cube.part_size[var] = 2;
+  FREE(spare->cube.part_size);
+  spare->cube.part_size = cube.part_size; /* keep the caller's signs */
+  cube = spare->cube;                     /* structure copy ! */
+  cdata = spare->cdata;                   /*      ""          */
+  FREE(spare);
+  return TRUE;
+}
+
 void cube_setup() {
   register int i, var;
   register pcube p;
 
   if (cube.num_binary_vars < 0 || cube.num_vars < cube.num_binary_vars)
     fatal("cube size is silly, error in .i/.o or .mv");
+  if (cube_spare != NULL && take_spare_cube())
+    return;
 
   cube.num_mv_vars = cube.num_vars - cube.num_binary_vars;
   cube.output = cube.num_mv_vars > 0 ? cube.num_vars - 1 : -1;
@@ -37,6 +71,8 @@ void cube_setup() {
     cube.last_part[var] = cube.size - 1;
     cube.last_word[var] = WHICH_WORD(cube.size - 1);
   }
+  if (LOOPINIT(cube.size) > LOOPMAX)
+    fatal("cube too wide for this build (configure with --enable-set64)");
 
   cube.var_mask = ALLOC(pset, cube.num_vars);
   cube.sparse = ALLOC(int, cube.num_vars);
@@ -105,6 +141,7 @@ void setdown_cube() {
   FREE(cdata.var_zeros);
   FREE(cdata.parts_active);
   FREE(cdata.is_unate);
+  free_cube_stack();
 
   cube.first_part = cube.last_part = (int *)NULL;
   cube.first_word = cube.last_word = (int *)NULL;
@@ -117,6 +154,17 @@ void setdown_cube() {
   cdata.is_unate = (bool *)NULL;
 }
 
+/*
+    keep_cube -- as setdown_cube() followed by FREE(cube.part_size), but
+    the structure is put aside for the next cube_setup() of this thread
+    (-Dbatch reads many PLAs of the same shape)
+*/
+void keep_cube() {
+  if (cube_spare != NULL)
+    free_ctx(cube_spare);
+  cube_spare = take_ctx();
+}
+
 void save_cube_struct() {
   temp_cube_save = cube;   /* structure copy ! */
   temp_cdata_save = cdata; /*      ""          */
@@ -130,9 +178,119 @@ void save_cube_struct() {
 
   cdata.part_zeros = cdata.var_zeros = cdata.parts_active = (int *)NULL;
   cdata.is_unate = (bool *)NULL;
+  cdata.stack = NULL;
 }
 
 void restore_cube_struct() {
   cube = temp_cube_save;   /* structure copy ! */
   cdata = temp_cdata_save; /*      ""          */
 }
+
+/*
+    new_ctx -- allocate an empty minimizer context
+
+    The cube structure of the new context is not set up; activate the
+    context, fill in num_vars, num_binary_vars and part_size as for
+    cube_setup(), call cube_setup() and deactivate it again.
+*/
+pctx new_ctx() {
+  register pctx ctx;
+
+  ctx = ALLOC(espresso_ctx_t, 1);
+  (void)memset((char *)ctx, 0, sizeof(espresso_ctx_t));
+  if (budget != NULL) {
+    ctx->budget.time = budget->time;
+    ctx->budget.mem = budget->mem;
+  }
+  ctx->active = FALSE;
+  return ctx;
+}
+
+/*
+    take_ctx -- move the current minimizer state of this thread into a new
+    (inactive) context; the thread is left without a cube structure
+*/
+pctx take_ctx() {
+  register pctx ctx;
+  register int i;
+
+  ctx = new_ctx();
+  ctx->cube = cube;   /* structure copy ! */
+  ctx->cdata = cdata; /*      ""          */
+  for (i = 0; i < TIME_COUNT; i++) {
+    ctx->total_time[i] = total_time[i];
+    ctx->total_calls[i] = total_calls[i];
+  }
+  (void)memset((char *)&cube, 0, sizeof(cube));
+  (void)memset((char *)&cdata, 0, sizeof(cdata));
+  return ctx;
+}
+
+/*
+    free_ctx -- release a minimizer context, including its cube structure
+    and the part_size array
+*/
+void free_ctx(ctx) pctx ctx;
+{
+  if (ctx->active)
+    fatal("free_ctx: context is still active");
+  if (ctx->cube.fullset != NULL) {
+    activate_ctx(ctx);
+    setdown_cube();
+    deactivate_ctx(ctx);
+  }
+  if (ctx->cube.part_size != NULL)
+    FREE(ctx->cube.part_size);
+  FREE(ctx);
+}
+
+/*
+    activate_ctx -- make ctx the current minimizer state of this thread
+
+    The state which was current is saved in the context and restored by
+    the matching deactivate_ctx().
+*/
+void activate_ctx(ctx) pctx ctx;
+{
+  register int i;
+
+  if (ctx->active)
+    fatal("activate_ctx: context is already active");
+  ctx->save_cube = cube;   /* structure copy ! */
+  ctx->save_cdata = cdata; /*      ""          */
+  cube = ctx->cube;
+  cdata = ctx->cdata;
+  ctx->save_budget = budget;
+  budget = &ctx->budget;
+  for (i = 0; i < TIME_COUNT; i++) {
+    ctx->save_time[i] = total_time[i];
+    ctx->save_calls[i] = total_calls[i];
+    total_time[i] = ctx->total_time[i];
+    total_calls[i] = ctx->total_calls[i];
+  }
+  ctx->active = TRUE;
+}
+
+/*
+    deactivate_ctx -- store the current minimizer state back into ctx and
+    restore the state which was current before activate_ctx(ctx)
+*/
+void deactivate_ctx(ctx) pctx ctx;
+{
+  register int i;
+
+  if (!ctx->active)
+    fatal("deactivate_ctx: context is not active");
+  ctx->cube = cube;   /* structure copy ! */
+  ctx->cdata = cdata; /*      ""          */
+  cube = ctx->save_cube;
+  cdata = ctx->save_cdata;
+  budget = ctx->save_budget;
+  for (i = 0; i < TIME_COUNT; i++) {
+    ctx->total_time[i] = total_time[i];
+    ctx->total_calls[i] = total_calls[i];
+    total_time[i] = ctx->save_time[i];
+    total_calls[i] = ctx->save_calls[i];
+  }
+  ctx->active = FALSE;
+}
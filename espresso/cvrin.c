@@ -6,9 +6,14 @@
 
 #include "../utility/utility.h"
 #include "espresso.h"
+#include "autoconf.h"
+#if HAVE_MMAP && HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
-static bool line_length_error;
-static int lineno;
+static ESPRESSO_TLS bool line_length_error;
+static ESPRESSO_TLS int lineno;
 
 void skip_line(fpin, fpout, echo) register FILE *fpin, *fpout;
 register bool echo;
@@ -203,9 +208,181 @@ pPLA PLA;
 
 bad_char:
   (void)fprintf(stderr, "(warning): input line #%d ignored\n", lineno);
-  skip_line(fp, stdout, TRUE);
+  skip_line(fp, echo_file, echo_unknown_commands);
   return;
 }
+#if HAVE_MMAP && HAVE_SYS_MMAN_H
+/*
+ *  read_cubes_mapped -- fast path for the cube rows of a PLA which comes
+ *  from a regular file
+ *
+ *  The file is mapped, the rows are decoded by table lookup, and the
+ *  lines up to the next keyword are counted to size F, D and R once.  The
+ *  rows, blank lines and comments are taken exactly as parse_pla() and
+ *  read_cube() would take them; anything else (symbolic variables, kiss,
+ *  a row which spans lines or has a bad character) is left to them,
+ *  from the start of the row in question.  Returns FALSE if not even the
+ *  first row could be read this way.
+ */
+
+#define ROW_SKIP 8 /* ' ', '\t' or '|' inside a row */
+#define ROW_BAD 16
+
+static unsigned char in_code[256];  /* binary input: its two bits */
+static unsigned char mv_code[256];  /* other variables: 1 if the part is on */
+static unsigned char out_code[256]; /* last variable: F_type, D_type, ... */
+static bool row_tables = FALSE;
+
+static void init_row_tables() {
+  register int ch;
+
+  for (ch = 0; ch < 256; ch++)
+    in_code[ch] = mv_code[ch] = out_code[ch] = ROW_BAD;
+  in_code[' '] = in_code['\t'] = in_code['|'] = ROW_SKIP;
+  mv_code[' '] = mv_code['\t'] = mv_code['|'] = ROW_SKIP;
+  out_code[' '] = out_code['\t'] = out_code['|'] = ROW_SKIP;
+  in_code['0'] = 1;
+  in_code['1'] = 2;
+  in_code['2'] = in_code['-'] = 3;
+  in_code['?'] = 0;
+  mv_code['0'] = 0;
+  mv_code['1'] = 1;
+  out_code['1'] = out_code['4'] = F_type;
+  out_code['0'] = out_code['3'] = R_type;
+  out_code['2'] = out_code['-'] = D_type;
+  out_code['~'] = 0;
+  row_tables = TRUE;
+}
+
+static bool read_cubes_mapped(fp, PLA) FILE *fp;
+pPLA PLA;
+{
+  register unsigned char *s, *end;
+  register int var, i, code;
+  unsigned char *base, *row, *start, *p;
+  pcube cf = cube.temp[0], cr = cube.temp[1], cd = cube.temp[2];
+  bool savef, saved, saver, sized;
+  struct stat st;
+  long off;
+  int nrows, last;
+
+  if (kiss || cube.num_vars == cube.num_binary_vars)
+    return FALSE;
+  for (var = cube.num_binary_vars; var < cube.num_vars; var++)
+    if (cube.part_size[var] < 0)
+      return FALSE;
+  if (fstat(fileno(fp), &st) != 0 || !S_ISREG(st.st_mode) ||
+      (off = ftell(fp)) < 0 || off >= st.st_size)
+    return FALSE;
+  base = (unsigned char *)mmap((char *)NULL, (size_t)st.st_size, PROT_READ,
+                               MAP_PRIVATE, fileno(fp), (off_t)0);
+  if (base == (unsigned char *)MAP_FAILED)
+    return FALSE;
+  if (!row_tables)
+    init_row_tables();
+  start = s = base + off;
+  end = base + st.st_size;
+  sized = FALSE;
+
+  for (;;) {
+    /* blank space and comments between the rows */
+    while (s < end) {
+      if (*s == '\n') {
+        lineno++;
+        s++;
+      } else if (*s == ' ' || *s == '\t' || *s == '\f' || *s == '\r') {
+        s++;
+      } else if (*s == '#') {
+        for (row = s; s < end && *s != '\n'; s++)
+          ;
+        if (echo_comments) {
+          (void)fwrite((char *)row, 1, s - row, echo_file);
+          putc('\n', echo_file);
+        }
+        lineno++;
+        if (s < end)
+          s++;
+      } else {
+        break;
+      }
+    }
+    if (s >= end || *s == '.')
+      break;
+
+    /* the next row */
+    row = s;
+    set_clear(cf, cube.size);
+    for (var = 0; var < cube.num_binary_vars; var++) {
+      while (s < end && (code = in_code[*s]) == ROW_SKIP)
+        s++;
+      if (s >= end || code == ROW_BAD)
+        goto not_mine;
+      s++;
+      cf[WHICH_WORD(2 * var)] |= (set_word_t)code << WHICH_BIT(2 * var);
+    }
+    for (; var < cube.num_vars - 1; var++)
+      for (i = cube.first_part[var]; i <= cube.last_part[var]; i++) {
+        while (s < end && (code = mv_code[*s]) == ROW_SKIP)
+          s++;
+        if (s >= end || code == ROW_BAD)
+          goto not_mine;
+        s++;
+        if (code)
+          set_insert(cf, i);
+      }
+    set_copy(cr, cf);
+    set_copy(cd, cf);
+    savef = saved = saver = FALSE;
+    last = cube.last_part[var];
+    for (i = cube.first_part[var]; i <= last; i++) {
+      while (s < end && (code = out_code[*s]) == ROW_SKIP)
+        s++;
+      if (s >= end || code == ROW_BAD)
+        goto not_mine;
+      s++;
+      if ((code & PLA->pla_type) == 0)
+        continue;
+      if (code == F_type)
+        set_insert(cf, i), savef = TRUE;
+      else if (code == R_type)
+        set_insert(cr, i), saver = TRUE;
+      else
+        set_insert(cd, i), saved = TRUE;
+    }
+
+    /* once the first row is good, size the covers for the lines up to
+       the next keyword */
+    if (!sized) {
+      for (nrows = 1, p = s; p < end; p++)
+        if (*p == '\n') {
+          nrows++;
+          if (p + 1 < end && p[1] == '.')
+            break;
+        }
+      if (PLA->pla_type & F_type)
+        PLA->F = sf_reserve(PLA->F, nrows);
+      if (PLA->pla_type & D_type)
+        PLA->D = sf_reserve(PLA->D, nrows);
+      if (PLA->pla_type & R_type)
+        PLA->R = sf_reserve(PLA->R, nrows);
+      sized = TRUE;
+    }
+    if (savef)
+      PLA->F = sf_addset(PLA->F, cf);
+    if (saved)
+      PLA->D = sf_addset(PLA->D, cd);
+    if (saver)
+      PLA->R = sf_addset(PLA->R, cr);
+  }
+  row = s;
+
+not_mine:
+  (void)munmap((char *)base, (size_t)st.st_size);
+  (void)fseek(fp, (long)(row - base), SEEK_SET);
+  return row != start;
+}
+#endif
+
 void parse_pla(fp, PLA) IN FILE *fp;
 INOUT pPLA PLA;
 {
@@ -231,7 +408,7 @@ loop:
 
   case '#':
     (void)ungetc(ch, fp);
-    skip_line(fp, stdout, echo_comments);
+    skip_line(fp, echo_file, echo_comments);
     break;
 
   case '.':
@@ -435,8 +612,8 @@ loop:
 
     } else {
       if (echo_unknown_commands)
-        printf("%c%s ", ch, word);
-      skip_line(fp, stdout, echo_unknown_commands);
+        (void)fprintf(echo_file, "%c%s ", ch, word);
+      skip_line(fp, echo_file, echo_unknown_commands);
     }
     break;
   default:
@@ -444,8 +621,8 @@ loop:
     if (cube.fullset == NULL) {
       /*		fatal("unknown PLA size, need .i/.o or .mv");*/
       if (echo_comments)
-        putchar('#');
-      skip_line(fp, stdout, echo_comments);
+        putc('#', echo_file);
+      skip_line(fp, echo_file, echo_comments);
       break;
     }
     if (PLA->F == NULL) {
@@ -453,6 +630,10 @@ loop:
       PLA->D = new_cover(10);
       PLA->R = new_cover(10);
     }
+#if HAVE_MMAP && HAVE_SYS_MMAN_H
+    if (read_cubes_mapped(fp, PLA))
+      break;
+#endif
     read_cube(fp, PLA);
   }
   goto loop;
@@ -494,6 +675,135 @@ loop:
         > 0	 : Operation successful
 */
 
+/* bin_read -- read n bytes of a binary PLA, or give up */
+static void bin_read(fp, p, n) FILE *fp;
+char *p;
+long n;
+{
+  if (n > 0 && fread(p, 1, (size_t)n, fp) != (size_t)n)
+    fatal("binary PLA is truncated");
+}
+
+/* bin_skip_pad -- skip the padding after n bytes of a binary PLA */
+static void bin_skip_pad(fp, n) FILE *fp;
+long n;
+{
+  char pad[8];
+
+  bin_read(fp, pad, (8 - n % 8) % 8);
+}
+
+/*
+ *  read_pla_binary -- read a PLA in the binary cover format written by
+ *  fpr_binary(); returns FALSE, having read nothing, if the next byte of
+ *  fp does not start one
+ *
+ *  The cube structure is set up from the header (or, when it already is,
+ *  must have the same shape), and each cover is read with one fread()
+ *  straight into its sets.
+ */
+static bool read_pla_binary(fp, PLA) FILE *fp;
+pPLA PLA;
+{
+  pla_binary_t h;
+  pcover T[3];
+  register pcube p, last;
+  int ch, i, var, len, *part_size;
+  long label_bytes;
+  char msg[80];
+
+  if ((ch = getc(fp)) == EOF)
+    return FALSE;
+  (void)ungetc(ch, fp);
+  if (ch != (PLA_BINARY_MAGIC[0] & 0xff))
+    return FALSE;
+
+  bin_read(fp, (char *)&h, (long)sizeof(h));
+  if (memcmp(h.magic, PLA_BINARY_MAGIC, sizeof(h.magic)) != 0)
+    fatal("not a binary PLA (bad magic number)");
+  if (h.byte_order != PLA_BINARY_ORDER)
+    fatal("binary PLA was written on a machine of another byte order");
+  if (h.version != PLA_BINARY_VERSION || h.word_bits != BPI) {
+    (void)sprintf(msg, "binary PLA has version %d and %d-bit sets, need %d "
+                       "and %d-bit sets",
+                  h.version, h.word_bits, PLA_BINARY_VERSION, BPI);
+    fatal(msg);
+  }
+  if (h.covers == 0 || (h.covers & ~FDR_type) != 0 || h.num_vars <= 0 ||
+      h.num_binary_vars < 0 ||
+      h.num_binary_vars > h.num_vars || h.count[0] < 0 || h.count[1] < 0 ||
+      h.count[2] < 0)
+    fatal("binary PLA has a bad header");
+
+  part_size = ALLOC(int, h.num_vars);
+  bin_read(fp, (char *)part_size, (long)h.num_vars * sizeof(int));
+  bin_skip_pad(fp, (long)h.num_vars * sizeof(int));
+  for (var = 0; var < h.num_vars; var++)
+    if (part_size[var] < (var < h.num_binary_vars ? 2 : 1))
+      fatal("binary PLA has a bad variable size");
+  if (cube.fullset == NULL) {
+    if (cube.part_size != NULL)
+      FREE(cube.part_size);
+    cube.num_vars = h.num_vars;
+    cube.num_binary_vars = h.num_binary_vars;
+    cube.part_size = part_size;
+    cube_setup();
+  } else {
+    if (cube.num_vars != h.num_vars ||
+        cube.num_binary_vars != h.num_binary_vars)
+      fatal("binary PLA does not match the size of the previous PLA");
+    for (var = 0; var < h.num_vars; var++)
+      if (ABS(cube.part_size[var]) != part_size[var])
+        fatal("binary PLA does not match the size of the previous PLA");
+    FREE(part_size);
+  }
+  if (h.wsize != SET_SIZE(cube.size))
+    fatal("binary PLA has a bad set size");
+
+  PLA_labels(PLA);
+  label_bytes = 0;
+  for (i = 0; i < cube.size; i++) {
+    bin_read(fp, (char *)&len, (long)sizeof(int));
+    label_bytes += sizeof(int);
+    if (len >= 0) {
+      if (len > h.label_bytes)
+        fatal("binary PLA has a bad label");
+      PLA->label[i] = ALLOC(char, len + 1);
+      bin_read(fp, PLA->label[i], (long)len);
+      PLA->label[i][len] = '\0';
+      label_bytes += len;
+    }
+  }
+  if (label_bytes != h.label_bytes)
+    fatal("binary PLA has a bad label table");
+  bin_skip_pad(fp, label_bytes);
+
+  for (i = 0; i < 3; i++) {
+    T[i] = new_cover(MAX(h.count[i], 1));
+    if ((h.covers & (i == 0 ? F_type : i == 1 ? D_type : R_type)) == 0)
+      continue;
+    T[i]->count = h.count[i];
+    if (T[i]->wsize == h.wsize)
+      bin_read(fp, (char *)T[i]->data,
+               (long)h.count[i] * h.wsize * sizeof(set_word_t));
+    else
+      foreach_set(T[i], last, p) {
+        bin_read(fp, (char *)p, (long)h.wsize * sizeof(set_word_t));
+      }
+    /* the flags were those of the writer; start afresh */
+    foreach_set(T[i], last, p) {
+      if (LOOP(p) != LOOPINIT(cube.size))
+        fatal("binary PLA has a bad set");
+      p[0] = SETHEADER(LOOP(p));
+    }
+  }
+  PLA->F = T[0];
+  PLA->D = T[1];
+  PLA->R = T[2];
+  PLA->pla_type = h.covers & FDR_type;
+  return TRUE;
+}
+
 int read_pla(fp, needs_dcset, needs_offset, pla_type, PLA_return) IN FILE *fp;
 IN bool needs_dcset, needs_offset;
 IN int pla_type;
@@ -510,7 +820,8 @@ OUT pPLA *PLA_return;
 
   /* Read the pla */
   time = ptime();
-  parse_pla(fp, PLA);
+  if (!read_pla_binary(fp, PLA))
+    parse_pla(fp, PLA);
 
   /* Check for nothing on the file -- implies reached EOF */
   if (PLA->F == NULL) {
@@ -550,17 +861,20 @@ OUT pPLA *PLA_return;
   }
   if (needs_offset && (PLA->pla_type == F_type || PLA->pla_type == FD_type)) {
     free_cover(PLA->R);
-    PLA->R = complement(cube2list(PLA->F, PLA->D));
+    PROFILE(PLA->R = complement(cube2list(PLA->F, PLA->D)),
+            total_name[COMPL_TIME], PLA->R);
   } else if (needs_dcset && PLA->pla_type == FR_type) {
     pcover X;
     free_cover(PLA->D);
     /* hack, why not? */
     X = d1merge(sf_join(PLA->F, PLA->R), cube.num_vars - 1);
-    PLA->D = complement(cube1list(X));
+    PROFILE(PLA->D = complement(cube1list(X)), total_name[COMPL_TIME],
+            PLA->D);
     free_cover(X);
   } else if (PLA->pla_type == R_type || PLA->pla_type == DR_type) {
     free_cover(PLA->F);
-    PLA->F = complement(cube2list(PLA->D, PLA->R));
+    PROFILE(PLA->F = complement(cube2list(PLA->D, PLA->R)),
+            total_name[COMPL_TIME], PLA->F);
   }
 
   if (trace) {
@@ -9,6 +9,8 @@
 
 #include "espresso.h"
 
+static void foreach_output_parallel();
+
 static void cb_unravel(c, start, end, startbase, B1) IN register pcube c;
 IN int start, end;
 IN pcube startbase;
@@ -94,7 +96,10 @@ IN int start, end;
 
 pcover unravel(B, start) IN pcover B;
 IN int start;
-{ return unravel_range(B, start, cube.num_vars - 1); }
+{
+  PROFILE_IN(B->count);
+  return unravel_range(B, start, cube.num_vars - 1);
+}
 
 /* lex_sort -- sort cubes in a standard lexical fashion */
 pcover lex_sort(T) pcover T;
@@ -207,14 +212,18 @@ unsigned int comp_debug;
 {
   register pcube *T1, p, seed, cof;
   pcube *A1, *B1;
-  bool change;
-  int count, numcube;
+  bool change, *covered;
+  int count, numcube, i;
 
   numcube = CUBELISTSIZE(T);
 
-  /* Mark all cubes -- covered cubes belong to the partition */
-  for (T1 = T + 2; (p = *T1++) != NULL;) {
-    RESET(p, COVERED);
+  /*
+   *  Covered cubes belong to the partition.  The marks are kept aside
+   *  rather than in the cubes, which may be shared with other threads.
+   */
+  covered = ALLOC(bool, numcube);
+  for (i = 0; i < numcube; i++) {
+    covered[i] = FALSE;
   }
 
   /*
@@ -224,15 +233,15 @@ unsigned int comp_debug;
    */
   seed = set_save(T[2]);
   cof = T[0];
-  SET(T[2], COVERED);
+  covered[0] = TRUE;
   count = 1;
 
   do {
     change = FALSE;
-    for (T1 = T + 2; (p = *T1++) != NULL;) {
-      if (!TESTP(p, COVERED) && ccommon(p, seed, cof)) {
+    for (i = 0, T1 = T + 2; (p = *T1++) != NULL; i++) {
+      if (!covered[i] && ccommon(p, seed, cof)) {
         INLINEset_and(seed, seed, p);
-        SET(p, COVERED);
+        covered[i] = TRUE;
         change = TRUE;
         count++;
       }
@@ -248,16 +257,16 @@ unsigned int comp_debug;
 
   if (count != numcube) {
     /* Allocate and setup the cubelist's for the two partitions */
-    *A = A1 = ALLOC(pcube, numcube + 3);
-    *B = B1 = ALLOC(pcube, numcube + 3);
-    (*A)[0] = set_save(T[0]);
-    (*B)[0] = set_save(T[0]);
+    *A = A1 = new_cubelist(numcube + 3);
+    *B = B1 = new_cubelist(numcube + 3);
+    (void)set_copy((*A)[0], T[0]);
+    (void)set_copy((*B)[0], T[0]);
     A1 = *A + 2;
     B1 = *B + 2;
 
     /* Loop over the cubes in T and distribute to A and B */
-    for (T1 = T + 2; (p = *T1++) != NULL;) {
-      if (TESTP(p, COVERED)) {
+    for (i = 0, T1 = T + 2; (p = *T1++) != NULL; i++) {
+      if (covered[i]) {
         *A1++ = p;
       } else {
         *B1++ = p;
@@ -271,6 +280,7 @@ unsigned int comp_debug;
     (*B)[1] = (pcube)B1;
   }
 
+  FREE(covered);
   return numcube - count;
 }
 
@@ -323,6 +333,9 @@ int i;
  *  func1() is called after reforming the equivalent output function
  *
  *  Each function returns TRUE if process is to continue
+ *
+ *  With -j, func() runs for several outputs at once on the worker
+ *  threads, while func1() is still called in order by this thread.
  */
 foreach_output_function(PLA, func, func1) pPLA PLA;
 
@@ -334,6 +347,11 @@ int (*func1)();
   pPLA PLA1;
   int i;
 
+  if (task_independent()) {
+    foreach_output_parallel(PLA, func, func1);
+    return;
+  }
+
   /* Loop for each output function */
   for (i = 0; i < cube.part_size[cube.output]; i++) {
 
@@ -365,8 +383,100 @@ int (*func1)();
   }
 }
 
-static pcover Fmin;
-static pcube phase;
+/*
+ *  foreach_output_parallel -- foreach_output_function() with func() run
+ *  for several outputs at once by the worker threads
+ *
+ *  The outputs are independent except for the ordering strategy of
+ *  reduce(), which alternates over all minimizations.  Each output
+ *  starts with the strategy the previous outputs left when it was
+ *  handed out; if that turns out to be wrong it is cancelled (see
+ *  task_cancel()) and minimized again, so the results are those of the
+ *  serial loop.
+ */
+
+typedef struct {
+  pPLA PLA, PLA1;
+  int i;
+  int (*func)();
+  int status;
+  bool toggle_in, toggle_out; /* reduce_toggle() before and after */
+  task_t task;
+} output_task_t;
+
+static void output_task(o) register output_task_t *o;
+{
+  register int part = o->i + cube.first_part[cube.output];
+  bool save = reduce_toggle(); /* of the work this thread interrupted */
+
+  o->PLA1 = new_PLA();
+  o->PLA1->F = cof_output(o->PLA->F, part);
+  o->PLA1->R = cof_output(o->PLA->R, part);
+  o->PLA1->D = cof_output(o->PLA->D, part);
+  set_reduce_toggle(o->toggle_in);
+  o->status = (*o->func)(o->PLA1, o->i);
+  o->toggle_out = reduce_toggle();
+  set_reduce_toggle(save);
+}
+
+static void foreach_output_parallel(PLA, func, func1) pPLA PLA;
+int (*func)(), (*func1)();
+{
+  register output_task_t *o;
+  output_task_t *out;
+  int i, n, spawned, part;
+  bool stop, toggle;
+
+  /* keep one output per thread in progress */
+  n = cube.part_size[cube.output];
+  out = ALLOC(output_task_t, n);
+  toggle = reduce_toggle();
+  for (spawned = 0; spawned < n && spawned < task_threads; spawned++) {
+    o = out + spawned;
+    o->PLA = PLA, o->i = spawned, o->func = func, o->toggle_in = toggle;
+    task_spawn(&o->task, output_task, (char *)o);
+  }
+
+  /* finish the outputs in order; after a stop, cancel the others */
+  stop = FALSE;
+  for (i = 0; i < spawned; i++) {
+    o = out + i;
+    if (stop || o->toggle_in != toggle) {
+      task_cancel(&o->task);
+      if (task_join(&o->task, FALSE)) {
+        free_PLA(o->PLA1);
+      }
+      if (stop) {
+        continue;
+      }
+      o->toggle_in = toggle;
+      output_task(o);
+    } else {
+      (void)task_join(&o->task, TRUE);
+    }
+    toggle = o->toggle_out;
+    stop = o->status == 0;
+    if (!stop && spawned < n) {
+      o = out + spawned;
+      o->PLA = PLA, o->i = spawned++, o->func = func, o->toggle_in = toggle;
+      task_spawn(&o->task, output_task, (char *)o);
+      o = out + i;
+    }
+    if (!stop) {
+      part = i + cube.first_part[cube.output];
+      o->PLA1->F = uncof_output(o->PLA1->F, part);
+      o->PLA1->R = uncof_output(o->PLA1->R, part);
+      o->PLA1->D = uncof_output(o->PLA1->D, part);
+      stop = (*func1)(o->PLA1, i) == 0;
+    }
+    free_PLA(o->PLA1);
+  }
+  set_reduce_toggle(toggle);
+  FREE(out);
+}
+
+static ESPRESSO_TLS pcover Fmin;
+static ESPRESSO_TLS pcube phase;
 
 /*
  *  minimize each output function individually
@@ -43,7 +43,7 @@ INOUT pcost cost;
 /* fmt_cost -- return a string which reports the "cost" of a cover */
 char *fmt_cost(cost) IN pcost cost;
 {
-  static char s[200];
+  static ESPRESSO_TLS char s[200];
 
   if (cube.num_binary_vars == cube.num_vars - 1)
     (void)sprintf(s, "c=%d(%d) in=%d out=%d tot=%d", cost->cubes,
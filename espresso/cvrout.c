@@ -13,6 +13,11 @@ IN int output_type;
   int num;
   register pcube last, p;
 
+  if ((output_type & BINARY_type) != 0) {
+    fpr_binary(fp, PLA, output_type & FDR_type);
+    return;
+  }
+
   if ((output_type & CONSTRAINTS_type) != 0) {
     output_symbolic_constraints(fp, PLA, 0);
     output_type &= ~CONSTRAINTS_type;
@@ -30,9 +35,9 @@ IN int output_type;
   }
 
   if (output_type == PLEASURE_type) {
-    pls_output(PLA);
+    pls_output(fp, PLA);
   } else if (output_type == EQNTOTT_type) {
-    eqn_output(PLA);
+    eqn_output(fp, PLA);
   } else if (output_type == KISS_type) {
     kiss_output(fp, PLA);
   } else {
@@ -66,6 +71,78 @@ IN int output_type;
   }
 }
 
+/* fpr_pad -- write zero bytes up to the next multiple of 8 of n */
+static void fpr_pad(fp, n) FILE *fp;
+long n;
+{
+  for (; n % 8 != 0; n++)
+    putc('\0', fp);
+}
+
+/*
+ *  fpr_binary -- write the covers of output_type (F_type, D_type, R_type)
+ *  in the binary cover format (see pla_binary_t in espresso.h)
+ */
+void fpr_binary(fp, PLA, output_type) FILE *fp;
+pPLA PLA;
+int output_type;
+{
+  pla_binary_t h;
+  pcover T[3];
+  register pcube p, last;
+  int i, len, *part_size;
+
+  T[0] = (output_type & F_type) ? PLA->F : NULL;
+  T[1] = (output_type & D_type) ? PLA->D : NULL;
+  T[2] = (output_type & R_type) ? PLA->R : NULL;
+
+  (void)memset((char *)&h, 0, sizeof(h));
+  (void)memcpy(h.magic, PLA_BINARY_MAGIC, sizeof(h.magic));
+  h.version = PLA_BINARY_VERSION;
+  h.byte_order = PLA_BINARY_ORDER;
+  h.word_bits = BPI;
+  h.covers = output_type & FDR_type;
+  h.num_vars = cube.num_vars;
+  h.num_binary_vars = cube.num_binary_vars;
+  h.wsize = SET_SIZE(cube.size);
+  for (i = 0; i < 3; i++)
+    h.count[i] = T[i] != NULL ? T[i]->count : 0;
+  if (PLA->label != NULL)
+    for (i = 0; i < cube.size; i++)
+      if (PLA->label[i] != NULL)
+        h.label_bytes += strlen(PLA->label[i]);
+  h.label_bytes += cube.size * sizeof(int);
+
+  (void)fwrite((char *)&h, sizeof(h), 1, fp);
+  part_size = ALLOC(int, cube.num_vars);
+  for (i = 0; i < cube.num_vars; i++)
+    part_size[i] = ABS(cube.part_size[i]);
+  (void)fwrite((char *)part_size, sizeof(int), cube.num_vars, fp);
+  fpr_pad(fp, (long)cube.num_vars * sizeof(int));
+  FREE(part_size);
+
+  for (i = 0; i < cube.size; i++) {
+    len = PLA->label != NULL && PLA->label[i] != NULL ? strlen(PLA->label[i])
+                                                       : -1;
+    (void)fwrite((char *)&len, sizeof(int), 1, fp);
+    if (len > 0)
+      (void)fwrite(PLA->label[i], 1, len, fp);
+  }
+  fpr_pad(fp, (long)h.label_bytes);
+
+  /* wide covers keep their sets aligned; the file does not */
+  for (i = 0; i < 3; i++)
+    if (h.count[i] == 0)
+      continue;
+    else if (T[i]->wsize == h.wsize)
+      (void)fwrite((char *)T[i]->data, sizeof(set_word_t),
+                   (size_t)h.count[i] * h.wsize, fp);
+    else
+      foreach_set(T[i], last, p) {
+        (void)fwrite((char *)p, sizeof(set_word_t), (size_t)h.wsize, fp);
+      }
+}
+
 void fpr_header(fp, PLA, output_type) FILE *fp;
 pPLA PLA;
 int output_type;
@@ -139,17 +216,18 @@ int output_type;
   }
 }
 
-void pls_output(PLA) IN pPLA PLA;
+void pls_output(fp, PLA) IN FILE *fp;
+IN pPLA PLA;
 {
   register pcube last, p;
 
-  (void)printf(".option unmerged\n");
+  (void)fprintf(fp, ".option unmerged\n");
   makeup_labels(PLA);
-  pls_label(PLA, stdout);
-  pls_group(PLA, stdout);
-  (void)printf(".p %d\n", PLA->F->count);
-  foreach_set(PLA->F, last, p) { print_expanded_cube(stdout, p, PLA->phase); }
-  (void)printf(".end\n");
+  pls_label(PLA, fp);
+  pls_group(PLA, fp);
+  (void)fprintf(fp, ".p %d\n", PLA->F->count);
+  foreach_set(PLA->F, last, p) { print_expanded_cube(fp, p, PLA->phase); }
+  (void)fprintf(fp, ".end\n");
 }
 
 void pls_group(PLA, fp) pPLA PLA;
@@ -195,7 +273,8 @@ FILE *fp;
 /*
     eqntott output mode -- output algebraic equations
 */
-void eqn_output(PLA) pPLA PLA;
+void eqn_output(fp, PLA) FILE *fp;
+pPLA PLA;
 {
   register pcube p, last;
   register int i, var, col, len;
@@ -210,7 +289,7 @@ void eqn_output(PLA) pPLA PLA;
 
   /* Write a single equation for each output */
   for (i = 0; i < cube.part_size[cube.output]; i++) {
-    (void)printf("%s = ", OUTLABEL(i));
+    (void)fprintf(fp, "%s = ", OUTLABEL(i));
     col = strlen(OUTLABEL(i)) + 3;
     firstor = TRUE;
 
@@ -218,9 +297,9 @@ void eqn_output(PLA) pPLA PLA;
     foreach_set(PLA->F, last,
                 p) if (is_in_set(p, i + cube.first_part[cube.output])) {
       if (firstor)
-        (void)printf("("), col += 1;
+        (void)fprintf(fp, "("), col += 1;
       else
-        (void)printf(" | ("), col += 4;
+        (void)fprintf(fp, " | ("), col += 4;
       firstor = FALSE;
       firstand = TRUE;
 
@@ -229,17 +308,17 @@ void eqn_output(PLA) pPLA PLA;
         if ((x = GETINPUT(p, var)) != DASH) {
           len = strlen(INLABEL(var));
           if (col + len > 72)
-            (void)printf("\n    "), col = 4;
+            (void)fprintf(fp, "\n    "), col = 4;
           if (!firstand)
-            (void)printf("&"), col += 1;
+            (void)fprintf(fp, "&"), col += 1;
           firstand = FALSE;
           if (x == ZERO)
-            (void)printf("!"), col += 1;
-          (void)printf("%s", INLABEL(var)), col += len;
+            (void)fprintf(fp, "!"), col += 1;
+          (void)fprintf(fp, "%s", INLABEL(var)), col += len;
         }
-      (void)printf(")"), col += 1;
+      (void)fprintf(fp, ")"), col += 1;
     }
-    (void)printf(";\n\n");
+    (void)fprintf(fp, ";\n\n");
   }
 }
 
@@ -35,15 +35,85 @@
  *
  *      skip_make_sparse
  *          skip the make_sparse step (used by opo only)
+ *
+ *  BUDGET (see budget_t):
+ *      budget
+ *          limits on the time and memory of each call; when they are
+ *          exceeded, the cover of the last IRREDUNDANT step is returned
+ *          and the -t trace says TRUNCATED
  */
 
 #include "espresso.h"
+#include "autoconf.h"
+#include <sys/time.h>
+#include <sys/resource.h>
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifndef NO_THREADS
+#include <pthread.h>
+
+static pthread_mutex_t budget_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/* budget_clock -- the time of day in milliseconds */
+static long budget_clock()
+{
+  struct timeval now;
+
+  (void)gettimeofday(&now, (struct timezone *)NULL);
+  return now.tv_sec * 1000L + now.tv_usec / 1000;
+}
+
+/* budget_memory -- the resident size of the process in bytes */
+static long budget_memory()
+{
+  FILE *fp;
+  long size, resident;
+  struct rusage rusage;
+
+  /* Linux tells the current size, elsewhere settle for the peak */
+#if HAVE_UNISTD_H && defined(_SC_PAGESIZE)
+  if ((fp = fopen("/proc/self/statm", "r")) != NULL) {
+    if (fscanf(fp, "%ld %ld", &size, &resident) != 2)
+      resident = 0;
+    (void)fclose(fp);
+    return resident * sysconf(_SC_PAGESIZE);
+  }
+#endif
+  (void)getrusage(RUSAGE_SELF, &rusage);
+  return rusage.ru_maxrss * 1024L;
+}
+
+/* budget_spent -- TRUE if the call which began at "start" is over budget */
+static bool budget_spent(start) long start;
+{
+  if (budget == NULL)
+    return FALSE;
+  return (budget->time > 0 && budget_clock() - start >= budget->time) ||
+         (budget->mem > 0 && budget_memory() > budget->mem);
+}
+
+/* budget_truncated -- count a call which was cut short */
+static void budget_truncated()
+{
+#ifndef NO_THREADS
+  (void)pthread_mutex_lock(&budget_lock);
+#endif
+  budget->truncated++;
+#ifndef NO_THREADS
+  (void)pthread_mutex_unlock(&budget_lock);
+#endif
+}
 
 pcover espresso(F, D1, R) pcover F, D1, R;
 {
   pcover E, D, Fsave;
   pset last, p;
   cost_t cost, best_cost;
+  bool unwrap = unwrap_onset; /* private copy: the option is shared */
+  bool truncated = FALSE;
+  long start = budget_clock();
 
 begin:
   Fsave = sf_save(F); /* save original function */
@@ -56,7 +126,7 @@ begin:
     F = E;
   }
   cover_cost(F, &cost);
-  if (unwrap_onset && (cube.part_size[cube.num_vars - 1] > 1) &&
+  if (unwrap && (cube.part_size[cube.num_vars - 1] > 1) &&
       (cost.out != cost.cubes * cube.part_size[cube.num_vars - 1]) &&
       (cost.out < 5000))
     EXEC(F = sf_contain(unravel(F, cube.num_vars - 1)), "SETUP      ", F);
@@ -66,7 +136,10 @@ begin:
   EXECUTE(F = expand(F, R, FALSE), EXPAND_TIME, F, cost);
   EXECUTE(F = irredundant(F, D), IRRED_TIME, F, cost);
 
-  if (!single_expand) {
+  /* From here on, stop with the last irredundant cover when over budget */
+  truncated = budget_spent(start);
+
+  if (!single_expand && !truncated) {
     if (remove_essential) {
       EXECUTE(E = essential(&F, &D), ESSEN_TIME, E, cost);
     } else {
@@ -79,6 +152,8 @@ begin:
       /* Repeat inner loop until solution becomes "stable" */
       do {
         copy_cost(&cost, &best_cost);
+        if ((truncated = budget_spent(start)))
+          break;
         EXECUTE(F = reduce(F, D), REDUCE_TIME, F, cost);
         EXECUTE(F = expand(F, R, FALSE), EXPAND_TIME, F, cost);
         EXECUTE(F = irredundant(F, D), IRRED_TIME, F, cost);
@@ -86,12 +161,16 @@ begin:
 
       /* Perturb solution to see if we can continue to iterate */
       copy_cost(&cost, &best_cost);
+      if (truncated || task_cancelled())
+        break;
+      if ((truncated = budget_spent(start)))
+        break;
       if (use_super_gasp) {
-        F = super_gasp(F, D, R, &cost);
+        PROFILE(F = super_gasp(F, D, R, &cost), "SUPER_GASP", F);
         if (cost.cubes >= best_cost.cubes)
           break;
       } else {
-        F = last_gasp(F, D, R, &cost);
+        PROFILE(F = last_gasp(F, D, R, &cost), "GASP", F);
       }
 
     } while (cost.cubes < best_cost.cubes ||
@@ -107,8 +186,9 @@ begin:
   free_cover(D);
 
   /* Attempt to make the PLA matrix sparse */
-  if (!skip_make_sparse) {
-    F = make_sparse(F, D1, R);
+  if (!skip_make_sparse && !truncated) {
+    if (!(truncated = budget_spent(start)))
+      F = make_sparse(F, D1, R);
   }
 
   /*
@@ -119,11 +199,18 @@ begin:
   if (Fsave->count < F->count) {
     free_cover(F);
     F = Fsave;
-    unwrap_onset = FALSE;
-    goto begin;
+    if (!truncated) {
+      unwrap = FALSE;
+      goto begin;
+    }
   } else {
     free_cover(Fsave);
   }
 
+  if (truncated) {
+    budget_truncated();
+    if (trace)
+      size_stamp(F, "TRUNCATED  ");
+  }
   return F;
 }
@@ -9,7 +9,7 @@
 #include "sparse.h"
 #include "mincov.h"
 
-#define ptime()        util_cpu_time()
+#define ptime()        task_time()
 #define print_time(t)    util_print_time(t)
 
 #ifdef IBM_WATC
@@ -22,6 +22,22 @@
 #define BPI 16
 #endif
 
+/*
+ *  Storage class for the state of the minimizer which must be private to
+ *  each thread (the cube structure, cdata and the statistics).  Compilers
+ *  without thread-local storage fall back to ordinary globals, which is
+ *  correct as long as only one thread minimizes at a time.
+ */
+#ifndef ESPRESSO_TLS
+#if defined(__GNUC__) || defined(__clang__)
+#define ESPRESSO_TLS __thread
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define ESPRESSO_TLS _Thread_local
+#else
+#define ESPRESSO_TLS
+#endif
+#endif
+
 /*-----THIS USED TO BE set.h----- */
 
 /*
@@ -32,36 +48,44 @@
  *   (otherwise known as sets, cf. Pascal).
  *
  *   A set is a vector of bits and is implemented here as an array of
- *   unsigned integers.  The low order bits of set[0] give the index of
- *   the last word of set data.  The higher order bits of set[0] are
- *   used to store data associated with the set.  The set data is
+ *   unsigned words (set_word_t).  The low order bits of set[0] give the
+ *   index of the last word of set data.  The higher order bits of set[0]
+ *   are used to store data associated with the set.  The set data is
  *   contained in elements set[1] ... set[LOOP(set)] as a packed bit
  *   array.
  *
  *   A family of sets is a two-dimensional matrix of bits and is
  *   implemented with the data type "set_family".
  *
- *   BPI == 32 and BPI == 16 have been tested and work.
+ *   BPI == 32 and BPI == 16 have been tested and work.  BPI == 64
+ *   (configure --enable-set64) uses 64-bit words and a wider set[0]
+ *   layout, which lifts the limit of 1023 data words (about 32K
+ *   positions) per set.
  */
 
 
-/* Define host machine characteristics of "unsigned int" */
+/* Define host machine characteristics of a set word */
 #ifndef BPI
-#define BPI             32              /* # bits per integer */
+#define BPI             32              /* # bits per word */
 #endif
 
-#if BPI == 32
+#if BPI == 64
+#define LOGBPI          6               /* log(BPI)/log(2) */
+typedef unsigned long long set_word_t;
+#elif BPI == 32
 #define LOGBPI          5               /* log(BPI)/log(2) */
+typedef unsigned int set_word_t;
 #else
 #define LOGBPI          4               /* log(BPI)/log(2) */
+typedef unsigned int set_word_t;
 #endif
 
 /* Define the set type */
-typedef unsigned int *pset;
+typedef set_word_t *pset;
 
 /* Define the set family type -- an array of sets */
 typedef struct set_family {
-    int               wsize;                  /* Size of each set in 'ints' */
+    int               wsize;                  /* Size of each set in words */
     int               sf_size;                /* User declared set size */
     int               capacity;               /* Number of sets allocated */
     int               count;                  /* The number of sets in the family */
@@ -73,9 +97,10 @@ typedef struct set_family {
 /* Macros to set and test single elements */
 #define WHICH_WORD(element)     (((element) >> LOGBPI) + 1)
 #define WHICH_BIT(element)      ((element) & (BPI-1))
+#define BIT(element)            ((set_word_t) 1 << WHICH_BIT(element))
 
-/* # of ints needed to allocate a set with "size" elements */
-#if BPI == 32
+/* # of words needed to allocate a set with "size" elements */
+#if BPI >= 32
 #define SET_SIZE(size)          ((size) <= BPI ? 2 : (WHICH_WORD((size)-1) + 1))
 #else
 #define SET_SIZE(size)          ((size) <= BPI ? 3 : (WHICH_WORD((size)-1) + 2))
@@ -87,9 +112,27 @@ typedef struct set_family {
  *      LOOPCOPY is the index of the last word in the set
  *      SIZE is available for general use (e.g., recording # elements in set)
  *      NELEM retrieves the number of elements in the set
+ *  SETHEADER(i) is the first word of a fresh set with LOOP == i, and
+ *  LOOPMAX the largest LOOP the layout can hold.
+ *
+ *  With 64-bit words the flags keep bits 10-15, SIZE takes bits 16-39 and
+ *  LOOP bits 40-63; otherwise LOOP is the low 10 bits.
  */
+#if BPI == 64
+#define LOOPMAX                 0xffffff
+#define LOOP(set)               ((int) (set[0] >> 40))
+#define PUTLOOP(set, i)         (set[0] &= 0xffffffffffULL, \
+                                 set[0] |= (set_word_t) (i) << 40)
+#define SETHEADER(i)            ((set_word_t) (i) << 40)
+#define LOOPCOPY(set)           LOOP(set)
+#define SIZE(set)               ((int) ((set[0] >> 16) & 0xffffff))
+#define PUTSIZE(set, size)      (set[0] &= ~(0xffffffULL << 16), \
+                                 set[0] |= (set_word_t) (size) << 16)
+#else
+#define LOOPMAX                 0x03ff
 #define LOOP(set)               (set[0] & 0x03ff)
 #define PUTLOOP(set, i)         (set[0] &= ~0x03ff, set[0] |= (i))
+#define SETHEADER(i)            (i)
 #if BPI == 32
 #define LOOPCOPY(set)           LOOP(set)
 #define SIZE(set)               (set[0] >> 16)
@@ -99,6 +142,7 @@ typedef struct set_family {
 #define SIZE(set)               (set[LOOP(set)+1])
 #define PUTSIZE(set, size)      ((set[LOOP(set)+1]) = (size))
 #endif
+#endif
 
 #define NELEM(set)        (BPI * LOOP(set))
 #define LOOPINIT(size)        ((size <= BPI) ? 1 : WHICH_WORD((size)-1))
@@ -133,7 +177,7 @@ typedef struct set_family {
     foreachi_set(R,i,p) if (TESTP(p, ACTIVE))
 
 /* Looping over all elements in a set:
- *      foreach_set_element(pset p, int i, unsigned val, int base) {
+ *      foreach_set_element(pset p, int i, set_word_t val, int base) {
  *		.
  *		.
  *		.
@@ -148,15 +192,40 @@ typedef struct set_family {
 #define GETSET(family, index)   ((family)->data + (family)->wsize * (index))
 
 /* Allocate and deallocate sets */
-#define set_new(size)    set_clear(ALLOC(unsigned int, SET_SIZE(size)), size)
-#define set_full(size)    set_fill(ALLOC(unsigned int, SET_SIZE(size)), size)
-#define set_save(r)    set_copy(ALLOC(unsigned int, SET_SIZE(NELEM(r))), r)
+#define set_new(size)    set_clear(ALLOC(set_word_t, SET_SIZE(size)), size)
+#define set_full(size)    set_fill(ALLOC(set_word_t, SET_SIZE(size)), size)
+#define set_save(r)    set_copy(ALLOC(set_word_t, SET_SIZE(NELEM(r))), r)
 #define set_free(r)    FREE(r)
 
 /* Check for set membership, remove set element and insert set element */
-#define is_in_set(set, e)       (set[WHICH_WORD(e)] & (1 << WHICH_BIT(e)))
-#define set_remove(set, e)      (set[WHICH_WORD(e)] &= ~ (1 << WHICH_BIT(e)))
-#define set_insert(set, e)      (set[WHICH_WORD(e)] |= 1 << WHICH_BIT(e))
+#define is_in_set(set, e)       (set[WHICH_WORD(e)] & BIT(e))
+#define set_remove(set, e)      (set[WHICH_WORD(e)] &= ~ BIT(e))
+#define set_insert(set, e)      (set[WHICH_WORD(e)] |= BIT(e))
+
+/*
+ *  Sets with more than SETV_MIN_WORDS words of data are handed to the
+ *  vector kernels of setv.c (selected at startup by setv_init()); shorter
+ *  sets are faster with the plain loops.  Set families of wide sets are
+ *  laid out so that the data of each set starts on a SETV_ALIGN byte
+ *  boundary (see sf_new()).
+ */
+#ifndef SETV_MIN_WORDS
+#define SETV_MIN_WORDS  16
+#endif
+#define SETV_ALIGN      32
+
+typedef struct setv_struct {
+    char *name;                         /* "c", "avx2" or "avx512" */
+    void (*v_and)();                    /* r = a & b */
+    void (*v_or)();                     /* r = a | b */
+    void (*v_diff)();                   /* r = a & ~b */
+    int  (*v_implies)();                /* a & ~b == 0 */
+    int  (*v_disjoint)();               /* a & b == 0 */
+    int  (*v_dist0)();                  /* binary part of cdist0() */
+    int  (*v_dist)();                   /* binary part of cdist() */
+    void (*v_lower)();                  /* binary part of force_lower() */
+}                    setv_t;
+extern setv_t setv;
 
 /* Inline code substitution for those places that REALLY need it on a VAX */
 #ifdef NO_INLINE
@@ -182,18 +251,21 @@ typedef struct set_family {
 #define INLINEset_copy(r, a)\
     {register int i_=LOOPCOPY(a); do r[i_]=a[i_]; while (--i_>=0);}
 #define INLINEset_clear(r, size)\
-    {register int i_=LOOPINIT(size); *r=i_; do r[i_] = 0; while (--i_ > 0);}
+    {register int i_=LOOPINIT(size); *r=SETHEADER(i_); do r[i_] = 0; while (--i_ > 0);}
 #define INLINEset_fill(r, size)\
-    {register int i_=LOOPINIT(size); *r=i_; \
-    r[i_]=((unsigned int)(~0))>>(i_*BPI-size); while(--i_>0) r[i_]=~0;}
+    {register int i_=LOOPINIT(size); *r=SETHEADER(i_); \
+    r[i_]=((set_word_t)(~0))>>(i_*BPI-size); while(--i_>0) r[i_]=~0;}
 #define INLINEset_and(r, a, b)\
     {register int i_=LOOP(a); PUTLOOP(r,i_);\
+    if (i_ > SETV_MIN_WORDS) (*setv.v_and)(r+1, a+1, b+1, i_); else\
     do r[i_] = a[i_] & b[i_]; while (--i_>0);}
 #define INLINEset_or(r, a, b)\
     {register int i_=LOOP(a); PUTLOOP(r,i_);\
+    if (i_ > SETV_MIN_WORDS) (*setv.v_or)(r+1, a+1, b+1, i_); else\
     do r[i_] = a[i_] | b[i_]; while (--i_>0);}
 #define INLINEset_diff(r, a, b)\
     {register int i_=LOOP(a); PUTLOOP(r,i_);\
+    if (i_ > SETV_MIN_WORDS) (*setv.v_diff)(r+1, a+1, b+1, i_); else\
     do r[i_] = a[i_] & ~ b[i_]; while (--i_>0);}
 #define INLINEset_ndiff(r, a, b, fullset)\
     {register int i_=LOOP(a); PUTLOOP(r,i_);\
@@ -213,10 +285,14 @@ typedef struct set_family {
     {register int i_=LOOP(a); PUTLOOP(r,i_);\
     do r[i_] = (a[i_]&mask[i_]) | (b[i_]&~mask[i_]); while (--i_>0);}
 #define INLINEsetp_implies(a, b, when_false)\
-    {register int i_=LOOP(a); do if (a[i_]&~b[i_]) break; while (--i_>0);\
+    {register int i_=LOOP(a);\
+    if (i_ > SETV_MIN_WORDS) i_ = ! (*setv.v_implies)(a+1, b+1, i_); else\
+    do if (a[i_]&~b[i_]) break; while (--i_>0);\
     if (i_ != 0) when_false;}
 #define INLINEsetp_disjoint(a, b, when_false)\
-    {register int i_=LOOP(a); do if (a[i_]&b[i_]) break; while (--i_>0);\
+    {register int i_=LOOP(a);\
+    if (i_ > SETV_MIN_WORDS) i_ = ! (*setv.v_disjoint)(a+1, b+1, i_); else\
+    do if (a[i_]&b[i_]) break; while (--i_>0);\
     if (i_ != 0) when_false;}
 #define INLINEsetp_equal(a, b, when_false)\
     {register int i_=LOOP(a); do if (a[i_]!=b[i_]) break; while (--i_>0);\
@@ -224,7 +300,20 @@ typedef struct set_family {
 
 #endif
 
-#if BPI == 32
+/* Count the elements of one set word, in hardware where possible */
+#if defined(__GNUC__) || defined(__clang__)
+#if BPI == 64
+#define count_ones(v)   __builtin_popcountll(v)
+#else
+#define count_ones(v)   __builtin_popcount(v)
+#endif
+#elif BPI == 64
+#define count_ones(v)\
+    (bit_count[v & 255] + bit_count[(v >> 8) & 255]\
+    + bit_count[(v >> 16) & 255] + bit_count[(v >> 24) & 255]\
+    + bit_count[(v >> 32) & 255] + bit_count[(v >> 40) & 255]\
+    + bit_count[(v >> 48) & 255] + bit_count[(v >> 56) & 255])
+#elif BPI == 32
 #define count_ones(v)\
     (bit_count[v & 255] + bit_count[(v >> 8) & 255]\
     + bit_count[(v >> 16) & 255] + bit_count[(v >> 24) & 255])
@@ -232,7 +321,7 @@ typedef struct set_family {
 #define count_ones(v)   (bit_count[v & 255] + bit_count[(v >> 8) & 255])
 #endif
 
-/* Table for efficient bit counting */
+/* Table for bit counting without a popcount builtin */
 int bit_count[256];
 /*----- END OF set.h ----- */
 
@@ -250,7 +339,6 @@ int bit_count[256];
 #define pcover                  pset_family
 #define new_cover(i)            sf_new(i, cube.size)
 #define free_cover(r)           sf_free(r)
-#define free_cubelist(T)        FREE(T[0]); FREE(T);
 
 
 /* cost_t describes the cost of a cover */
@@ -328,11 +416,37 @@ typedef struct {
 #define KISS_type    128        /* output format kiss */
 #define CONSTRAINTS_type    256    /* output the constraints (numeric) */
 #define SYMBOLIC_CONSTRAINTS_type 512    /* output the constraints (symbolic) */
+#define BINARY_type     1024            /* output format binary covers */
 #define FD_type (F_type | D_type)
 #define FR_type (F_type | R_type)
 #define DR_type (D_type | R_type)
 #define FDR_type (F_type | D_type | R_type)
 
+/*
+ *  The binary cover format (-o binary, see pla(5)) starts with this
+ *  header.  part_size[num_vars] and the label table (for each part an
+ *  int length, -1 for no label, and the characters) follow, each padded
+ *  to a multiple of 8 bytes, and then the sets of F, D and R exactly as
+ *  they are kept in memory.  read_pla() recognizes the format by its
+ *  first byte.
+ */
+#define PLA_BINARY_MAGIC        "\211ESP\r\n\032\n"
+#define PLA_BINARY_VERSION      1
+#define PLA_BINARY_ORDER        0x01020304
+
+typedef struct {
+    char magic[8];                      /* PLA_BINARY_MAGIC */
+    int version;                        /* PLA_BINARY_VERSION */
+    int byte_order;                     /* PLA_BINARY_ORDER as written */
+    int word_bits;                      /* BPI of the writer */
+    int covers;                         /* F_type | D_type | R_type written */
+    int num_vars, num_binary_vars;
+    int wsize;                          /* words per set */
+    int count[3];                       /* sets in F, D and R */
+    int label_bytes;                    /* size of the label table */
+    int unused;
+}          pla_binary_t;
+
 /* Definitions for the debug variable */
 #define COMPL           0x0001
 #define ESSEN           0x0002
@@ -389,11 +503,11 @@ typedef struct {
     (is_in_set(c, cube.first_part[cube.output] + pos) != 0)
 
 #define PUTINPUT(c, pos, value)\
-    c[WHICH_WORD(2*pos)] = (c[WHICH_WORD(2*pos)] & ~(3 << WHICH_BIT(2*pos)))\
-        | (value << WHICH_BIT(2*pos))
+    c[WHICH_WORD(2*pos)] = (c[WHICH_WORD(2*pos)] & ~((set_word_t) 3 << WHICH_BIT(2*pos)))\
+        | ((set_word_t) (value) << WHICH_BIT(2*pos))
 #define PUTOUTPUT(c, pos, value)\
-    c[WHICH_WORD(pos)] = (c[WHICH_WORD(pos)] & ~(1 << WHICH_BIT(pos)))\
-        | (value << WHICH_BIT(pos))
+    c[WHICH_WORD(pos)] = (c[WHICH_WORD(pos)] & ~BIT(pos))\
+        | ((set_word_t) (value) << WHICH_BIT(pos))
 
 #define TWO     3
 #define DASH    3
@@ -401,12 +515,27 @@ typedef struct {
 #define ZERO    1
 
 
+/*
+ *  PROFILE runs a phase under -P (see profile.c), and a phase reports the
+ *  size of its input with PROFILE_IN; both compile away with NO_PROFILE
+ */
+#ifndef NO_PROFILE
+#define PROFILE(fct, name, S)\
+    {profile_t profile_;if(profile_file!=NULL)profile_begin(&profile_,name);\
+     fct;if(profile_file!=NULL)profile_end(&profile_,S);}
+#define PROFILE_IN(n)\
+    {if(profile_top!=NULL&&profile_top->cubes_in<0)profile_top->cubes_in=(n);}
+#else
+#define PROFILE(fct, name, S)   {fct;}
+#define PROFILE_IN(n)
+#endif
+
 #define EXEC(fct, name, S)\
-    {long t=ptime();fct;if(trace)print_trace(S,name,ptime()-t);}
+    {long t=ptime();PROFILE(fct,name,S);if(trace)print_trace(S,name,ptime()-t);}
 #define EXEC_S(fct, name, S)\
-    {long t=ptime();fct;if(summary)print_trace(S,name,ptime()-t);}
+    {long t=ptime();PROFILE(fct,name,S);if(summary)print_trace(S,name,ptime()-t);}
 #define EXECUTE(fct, i, S, cost)\
-    {long t=ptime();fct;totals(t,i,S,&(cost));}
+    {long t=ptime();PROFILE(fct,total_name[i],S);totals(t,i,S,&(cost));}
 
 /*
  *    Global Variable Declarations
@@ -415,13 +544,14 @@ typedef struct {
 unsigned int debug;              /* debug parameter */
 bool verbose_debug;              /* -v:  whether to print a lot */
 char         *total_name[TIME_COUNT];    /* basic function names */
-long         total_time[TIME_COUNT];     /* time spent in basic fcts */
-int          total_calls[TIME_COUNT];     /* # calls to each fct */
+extern ESPRESSO_TLS long total_time[TIME_COUNT];  /* time spent in basic fcts */
+extern ESPRESSO_TLS int  total_calls[TIME_COUNT]; /* # calls to each fct */
 
 bool echo_comments;        /* turned off by -eat option */
 bool echo_unknown_commands;    /* always true ?? */
+FILE *echo_file;               /* where read_pla() echoes them */
 bool force_irredundant;          /* -nirr command line option */
-bool skip_make_sparse;
+extern ESPRESSO_TLS bool skip_make_sparse;
 bool kiss;                       /* -kiss command line option */
 bool pos;                        /* -pos command line option */
 bool print_solution;             /* -x command line option */
@@ -433,6 +563,9 @@ bool trace;                      /* -t command line option */
 bool unwrap_onset;               /* -nunwrap command line option */
 bool use_random_order;        /* -random command line option */
 bool use_super_gasp;        /* -strong command line option */
+bool use_zdd_primes;        /* -zdd command line option */
+int          task_threads;         /* -j command line option */
+int          task_cutoff;          /* -j N,cutoff: smallest list to fork */
 char         *filename;            /* filename PLA was read from */
 bool debug_exact_minimization;   /* dumps info for -do exact */
 
@@ -469,7 +602,7 @@ struct cube_struct {
     pset         *temp;                 /* an array of temporary sets */
     pset         fullset;               /* a full cube */
     pset         emptyset;              /* an empty cube */
-    unsigned int inmask;        /* mask to get odd word of binary part */
+    set_word_t   inmask;        /* mask to get odd word of binary part */
     int          inword;                 /* which word number for above */
     int          *sparse;                /* should this variable be sparse? */
     int          num_mv_vars;            /* number of multiple-valued variables */
@@ -484,17 +617,116 @@ struct cdata_struct {
     int vars_active;            /* number of "active" variables */
     int vars_unate;             /* number of unate variables */
     int best;                   /* best "binate" variable */
+    struct cube_stack *stack;   /* cube lists and temporary cubes */
 };
 
 
-struct pla_types_struct pla_types[];
-struct cube_struct      cube, temp_cube_save;
-struct cdata_struct     cdata, temp_cdata_save;
+
+/*
+ *  A budget_t bounds each call of espresso() (-B on the command line):
+ *  once "time" milliseconds have passed since the call began, or the
+ *  process holds more than "mem" bytes of memory, espresso() stops
+ *  iterating and returns the cover of its last IRREDUNDANT step.
+ *  "truncated" counts the calls which were cut short that way.
+ */
+typedef struct budget_struct {
+    long                time;               /* 0 for no limit */
+    long                mem;                /* 0 for no limit */
+    int                 truncated;
+}          budget_t;
+
+/*
+ *  The records of -P (see profile.c).  A profile_t lives on the stack of
+ *  PROFILE() while its phase runs; profile_top is the innermost one of
+ *  the thread.  profile_mem counts the set family storage of the thread.
+ */
+typedef struct profile_count_struct {
+    long                allocs;             /* set family allocations */
+    long                bytes;              /* set family storage held */
+    long                peak;               /* the most bytes held */
+}          profile_count_t;
+
+typedef struct profile_struct {
+    char                *name;              /* the phase */
+    double              wall;               /* start, ms of wall clock */
+    long                cpu;                /* start, ptime() */
+    int                 cubes_in;           /* -1 until PROFILE_IN() */
+    long                allocs;             /* profile_mem at the start */
+    long                peak;               /* peak of the enclosing phase */
+    struct profile_struct *up;              /* the enclosing phase */
+}          profile_t;
+
+/*
+ *  An espresso_ctx_t is a complete, independent minimizer state: the cube
+ *  geometry, the cdata scratch area and the statistics.  The espresso core
+ *  always works on the thread's current "cube" and "cdata"; activate_ctx()
+ *  makes a context current (saving what was there before) and
+ *  deactivate_ctx() stores the context back and restores the previous
+ *  state.  Calls may nest, but must be properly bracketed.  The budget
+ *  of a context applies while it is active; new_ctx() starts it with the
+ *  limits of the current one.
+ *
+ *  Since cube and cdata are thread-local, each thread may minimize a
+ *  different problem at the same time.
+ */
+typedef struct espresso_ctx_struct {
+    struct cube_struct  cube;               /* cube geometry */
+    struct cdata_struct cdata;              /* unate recursion scratch */
+    long                total_time[TIME_COUNT];   /* statistics */
+    int                 total_calls[TIME_COUNT];
+    budget_t            budget;             /* limits for espresso() */
+    bool                active;             /* context is current */
+    struct cube_struct  save_cube;          /* state before activate_ctx */
+    struct cdata_struct save_cdata;
+    long                save_time[TIME_COUNT];
+    int                 save_calls[TIME_COUNT];
+    budget_t            *save_budget;
+}          espresso_ctx_t, *pctx;
+
+/*
+ *  A task_t is a piece of work (e.g., one branch of the unate recursion)
+ *  offered to the worker threads (see task.c).  The caller owns the
+ *  storage; it must stay valid until task_join() returns.
+ */
+#define TASK_DEFERRED   0               /* to be run by task_join() */
+#define TASK_QUEUED     1               /* waiting for a worker */
+#define TASK_RUNNING    2
+#define TASK_DONE       3
+
+typedef struct task_struct {
+    void                (*fn)();        /* fn(arg) does the work */
+    char                *arg;
+    struct cube_struct  *parent;        /* cube structure of the spawner,
+                                           NULL if the task has its own */
+    int                 state;          /* changed under the task lock */
+    bool                offered;        /* queued by task_spawn() */
+    bool                cancelled;      /* see task_cancel() */
+    budget_t            *budget;        /* the budget of the spawner */
+    profile_count_t     mem;            /* storage counted while it ran */
+    struct task_struct  *up;            /* task which spawned this one */
+    struct task_struct  *next;          /* queue link */
+}          task_t;
+
+/* a set of BDDs and ZDDs, for computing the primes implicitly (zdd.c) */
+typedef struct zdd_struct zdd_t;
+
+extern struct pla_types_struct pla_types[];
+extern ESPRESSO_TLS budget_t *budget;   /* limits of this thread, or NULL */
+#ifndef NO_PROFILE
+extern FILE *profile_file;                       /* -P, or NULL */
+extern ESPRESSO_TLS char *profile_input;         /* NULL for filename */
+extern ESPRESSO_TLS profile_t *profile_top;
+extern ESPRESSO_TLS profile_count_t profile_mem;
+#endif
+extern ESPRESSO_TLS struct cube_struct  cube, temp_cube_save;
+extern ESPRESSO_TLS struct cdata_struct cdata, temp_cdata_save;
 
 #ifdef lint
 #define DISJOINT 0x5555
 #else
-#if BPI == 32
+#if BPI == 64
+#define DISJOINT 0x5555555555555555ULL
+#elif BPI == 32
 #define DISJOINT 0x55555555
 #else
 #define DISJOINT 0x5555
@@ -509,7 +741,12 @@ struct cdata_struct     cdata, temp_cdata_save;
 /* cofactor.c */    pcube *cube1list();
 /* cofactor.c */    pcube *cube2list();
 /* cofactor.c */    pcube *cube3list();
+/* cofactor.c */    pcube *new_cubelist();
 /* cofactor.c */    pcube *scofactor();
+/* cofactor.c */    pcube new_temp_cube();
+/* cofactor.c */    void free_cube_stack();
+/* cofactor.c */    void free_cubelist();
+/* cofactor.c */    void free_temp_cube();
 /* cofactor.c */    void massive_count();
 /* compl.c */    pcover complement();
 /* compl.c */    pcover simplify();
@@ -532,10 +769,17 @@ struct cdata_struct     cdata, temp_cdata_save;
 /* contain.c */    pset_family sf_rev_contain();
 /* contain.c */    pset_family sf_union();
 /* contain.c */    pset_family sf_unlist();
+/* cluster.c */    pcover cluster_espresso();
+/* cubestr.c */    pctx new_ctx();
+/* cubestr.c */    void activate_ctx();
 /* cubestr.c */    void cube_setup();
+/* cubestr.c */    void deactivate_ctx();
+/* cubestr.c */    void free_ctx();
+/* cubestr.c */    void keep_cube();
 /* cubestr.c */    void restore_cube_struct();
 /* cubestr.c */    void save_cube_struct();
 /* cubestr.c */    void setdown_cube();
+/* cubestr.c */    pctx take_ctx();
 /* cvrin.c */    PLA_labels();
 /* cvrin.c */    char *get_word();
 /* cvrin.c */    int label_index();
@@ -588,6 +832,7 @@ struct cdata_struct     cdata, temp_cdata_save;
 /* cvrout.c */    void debug1_print();
 /* cvrout.c */    void debug_print();
 /* cvrout.c */    void eqn_output();
+/* cvrout.c */    void fpr_binary();
 /* cvrout.c */    void fpr_header();
 /* cvrout.c */    void fprint_pla();
 /* cvrout.c */    void pls_group();
@@ -669,12 +914,18 @@ struct cdata_struct     cdata, temp_cdata_save;
 /* pair.c */    void set_pair();
 /* pair.c */    void set_pair1();
 /* primes.c */    pcover primes_consensus();
+/* profile.c */    void profile_begin();
+/* profile.c */    void profile_end();
+/* profile.c */    void profile_merge();
+/* profile.c */    bool profile_open();
 /* reduce.c */    bool sccc_special_cases();
 /* reduce.c */    pcover reduce();
 /* reduce.c */    pcube reduce_cube();
+/* reduce.c */    bool reduce_toggle();
 /* reduce.c */    pcube sccc();
 /* reduce.c */    pcube sccc_cube();
 /* reduce.c */    pcube sccc_merge();
+/* reduce.c */    void set_reduce_toggle();
 /* set.c */    bool set_andp();
 /* set.c */    bool set_orp();
 /* set.c */    bool setp_disjoint();
@@ -715,6 +966,7 @@ struct cdata_struct     cdata, temp_cdata_save;
 /* set.c */    pset_family sf_new();
 /* set.c */    pset_family sf_permute();
 /* set.c */    pset_family sf_read();
+/* set.c */    pset_family sf_reserve();
 /* set.c */    pset_family sf_save();
 /* set.c */    pset_family sf_transpose();
 /* set.c */    void set_write();
@@ -740,6 +992,7 @@ struct cdata_struct     cdata, temp_cdata_save;
 /* setc.c */    int lex_order1();
 /* setc.c */    pset force_lower();
 /* setc.c */    void consensus();
+/* setv.c */    void setv_init();
 /* sharp.c */    pcover cb1_dsharp();
 /* sharp.c */    pcover cb_dsharp();
 /* sharp.c */    pcover cb_recur_dsharp();
@@ -753,6 +1006,15 @@ struct cdata_struct     cdata, temp_cdata_save;
 /* sharp.c */    pcover sharp();
 
 /* sminterf.c */pset do_sm_minimum_cover();
+/* task.c */    bool task_active();
+/* task.c */    bool task_cancelled();
+/* task.c */    void task_cancel();
+/* task.c */    bool task_independent();
+/* task.c */    bool task_join();
+/* task.c */    void task_init();
+/* task.c */    void task_spawn();
+/* task.c */    void task_start();
+/* task.c */    long task_time();
 /* sparse.c */    pcover make_sparse();
 /* sparse.c */    pcover mv_reduce();
 
@@ -772,5 +1034,12 @@ struct cdata_struct     cdata, temp_cdata_save;
 /* verify.c */    bool PLA_verify();
 /* verify.c */    bool check_consistency();
 /* verify.c */    bool verify();
+/* zdd.c */    double zdd_count();
+/* zdd.c */    pcover zdd_cover();
+/* zdd.c */    void zdd_foreach();
+/* zdd.c */    void zdd_free();
+/* zdd.c */    zdd_t *zdd_new();
+/* zdd.c */    pcover zdd_prime_cover();
+/* zdd.c */    int zdd_primes();
 
 #endif
\ No newline at end of file
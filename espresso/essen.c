@@ -30,6 +30,8 @@ pcover essential(Fp, Dp) IN pcover *Fp, *Dp;
   register pcube last, p;
   pcover E, F = *Fp, D = *Dp;
 
+  PROFILE_IN(F->count);
+
   /* set all cubes in F active */
   (void)sf_active(F);
 
@@ -45,8 +45,16 @@ int weighted;
   level = (debug & MINCOV) ? 4 : 0;
   heur = !exact_cover;
 
-  /* Generate all prime implicants */
-  EXEC(F = primes_consensus(cube2list(F, D)), "PRIMES     ", F);
+  /* Generate all prime implicants (from the ZDD with -ezdd) */
+  newF = NULL;
+  if (use_zdd_primes) {
+    EXEC(newF = zdd_prime_cover(F, D), "ZPRIMES    ", newF ? newF : F);
+  }
+  if (newF != NULL) {
+    F = newF;
+  } else {
+    EXEC(F = primes_consensus(cube2list(F, D)), "PRIMES     ", F);
+  }
 
   /* Setup the prime implicant table */
   EXEC(irred_split_cover(F, D, &E, &Rt, &Rp), "ESSENTIALS ", E);
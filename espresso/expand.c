@@ -32,6 +32,8 @@
 
 #include "espresso.h"
 
+static void expand_parallel();
+
 /*
     expand -- expand each nonprime cube of F into a prime implicant
 
@@ -48,6 +50,8 @@ IN bool nonsparse; /* expand non-sparse variables only */
   int var, num_covered;
   bool change;
 
+  PROFILE_IN(F->count);
+
   /* Order the cubes according to "chewing-away from the edges" of mini */
   if (use_random_order)
     F = random_order(F);
@@ -74,6 +78,9 @@ IN bool nonsparse; /* expand non-sparse variables only */
   }
 
   /* Try to expand each nonprime and noncovered cube */
+  if (task_active(F->count)) {
+    expand_parallel(F, R, INIT_LOWER);
+  } else
   foreach_set(F, last, p) {
     /* do not expand if PRIME or if covered by previous expansion */
     if (!TESTP(p, PRIME) && !TESTP(p, COVERED)) {
@@ -117,6 +124,162 @@ IN bool nonsparse; /* expand non-sparse variables only */
   return F;
 }
 
+/*
+    expand_parallel -- expand the cubes of F using several threads
+
+    The cubes are taken in batches of one cube per thread.  The first
+    cube of a batch is expanded exactly as by expand(); the others are
+    expanded at the same time, speculatively, on private copies of F
+    and R, assuming that the cubes before them in the batch cover
+    nothing.  The results are then reconciled in the original order: a
+    cube covered by an earlier expansion is dropped, and a speculative
+    expansion is kept only if no earlier cube of the batch covered a
+    cube which it could still have covered; otherwise the cube is
+    expanded again.  This gives the same cover as the serial loop.
+*/
+
+typedef struct {
+  pcover F, R;     /* covers to expand against (private for speculation) */
+  char *skip;      /* cubes of F prime or covered when the batch started */
+  int *batch, pos; /* the cube to expand is batch[pos] */
+  pcube RAISE, FREESET, SUPER_CUBE, OVEREXPANDED_CUBE, INIT_LOWER;
+  int num_covered;
+  task_t task;
+} expand_spec_t;
+
+/* expand_spec -- speculative expand1() of a cube of the batch */
+static void expand_spec(s) register expand_spec_t *s;
+{
+  register pcube p, last;
+  register int i;
+
+  /* cubes which the serial loop would not try to cover are made prime */
+  i = 0;
+  foreach_set(s->F, last, p) {
+    RESET(p, COVERED);
+    if (s->skip[i++]) {
+      SET(p, PRIME);
+    } else {
+      RESET(p, PRIME);
+    }
+  }
+  for (i = 0; i < s->pos; i++) {
+    SET(GETSET(s->F, s->batch[i]), PRIME);
+  }
+
+  expand1(s->R, s->F, s->RAISE, s->FREESET, s->OVEREXPANDED_CUBE,
+          s->SUPER_CUBE, s->INIT_LOWER, &s->num_covered,
+          GETSET(s->F, s->batch[s->pos]));
+}
+
+/* expand_keep -- replace p by the expansion found in s */
+static void expand_keep(p, s) register pcube p;
+register expand_spec_t *s;
+{
+  register set_word_t flags = p[0];
+
+  (void)set_copy(p, s->RAISE);
+  p[0] = flags;
+  SET(p, PRIME);
+  RESET(p, ACTIVE);
+  RESET(p, COVERED);
+  if (s->num_covered == 0 && !setp_equal(p, s->OVEREXPANDED_CUBE)) {
+    SET(p, NONESSEN);
+  }
+}
+
+static void expand_parallel(F, R, INIT_LOWER) pcover F, R;
+pcube INIT_LOWER;
+{
+  register pcube p;
+  register int i, j, m;
+  register expand_spec_t *s;
+  expand_spec_t *spec;
+  int n, nspec, *batch, newcover;
+  bool ran;
+  char *skip;
+
+  nspec = task_threads;
+  spec = ALLOC(expand_spec_t, nspec);
+  batch = ALLOC(int, nspec);
+  skip = ALLOC(char, F->count);
+  for (m = 0; m < nspec; m++) {
+    s = spec + m;
+    s->F = m == 0 ? F : sf_save(F);
+    s->R = m == 0 ? R : sf_save(R);
+    s->skip = skip;
+    s->batch = batch;
+    s->pos = m;
+    s->RAISE = new_cube();
+    s->FREESET = new_cube();
+    s->SUPER_CUBE = new_cube();
+    s->OVEREXPANDED_CUBE = new_cube();
+    s->INIT_LOWER = INIT_LOWER;
+  }
+
+  for (i = 0; i < F->count;) {
+    /* Record the state at the start of the batch and select its cubes */
+    for (j = 0; j < F->count; j++) {
+      p = GETSET(F, j);
+      skip[j] = TESTP(p, PRIME) || TESTP(p, COVERED);
+    }
+    for (n = 0; i < F->count && n < nspec; i++) {
+      if (!skip[i]) {
+        batch[n++] = i;
+      }
+    }
+
+    for (m = 1; m < n; m++) {
+      task_spawn(&spec[m].task, expand_spec, (char *)&spec[m]);
+    }
+
+    /* newcover is the last cube covered by this batch so far */
+    newcover = -1;
+    for (m = 0; m < n; m++) {
+      s = spec + m;
+      p = GETSET(F, batch[m]);
+      ran = m > 0 && task_join(&s->task, FALSE);
+      if (TESTP(p, COVERED)) {
+        continue;
+      }
+      if (ran && newcover < batch[m]) {
+        /* the speculation saw the right cubes: take over its coverings */
+        for (j = 0; j < F->count; j++) {
+          if (TESTP(GETSET(s->F, j), COVERED)) {
+            SET(GETSET(F, j), COVERED);
+          }
+        }
+      } else {
+        s = spec;
+        expand1(R, F, s->RAISE, s->FREESET, s->OVEREXPANDED_CUBE,
+                s->SUPER_CUBE, s->INIT_LOWER, &s->num_covered, p);
+      }
+      expand_keep(p, s);
+      for (j = F->count - 1; j > newcover; j--) {
+        if (!skip[j] && TESTP(GETSET(F, j), COVERED)) {
+          newcover = j;
+          break;
+        }
+      }
+    }
+  }
+
+  for (m = 0; m < nspec; m++) {
+    s = spec + m;
+    if (m > 0) {
+      free_cover(s->F);
+      free_cover(s->R);
+    }
+    free_cube(s->RAISE);
+    free_cube(s->FREESET);
+    free_cube(s->SUPER_CUBE);
+    free_cube(s->OVEREXPANDED_CUBE);
+  }
+  FREE(skip);
+  FREE(batch);
+  FREE(spec);
+}
+
 /*
     expand1 -- Expand a single cube against the OFF-set
 */
@@ -210,7 +373,7 @@ pcube RAISE, FREESET;
 #else
     {
       register int w, last;
-      register unsigned int x;
+      register set_word_t x;
       dist = 0;
       if ((last = cube.inword) != -1) {
         x = p[last] & r[last];
@@ -308,7 +471,7 @@ pcube RAISE, FREESET;
 #else
     {
       register int w, lastw;
-      register unsigned int x;
+      register set_word_t x;
       if ((lastw = cube.inword) != -1) {
         x = p[lastw] & r[lastw];
         if (~(x | x >> 1) & cube.inmask)
@@ -553,7 +716,7 @@ pcube c, RAISE, new_lower;
 #else
     {
       register int w, last;
-      register unsigned int x;
+      register set_word_t x;
       dist = 0;
       if ((last = cube.inword) != -1) {
         x = p[last] & r[last];
@@ -711,6 +874,7 @@ pcover all_primes(F, R) pcover F, R;
   register pcube last, p, RAISE, FREESET;
   pcover Fall_primes, B1;
 
+  PROFILE_IN(F->count);
   FREESET = new_cube();
   RAISE = new_cube();
   Fall_primes = new_cover(F->count);
@@ -34,6 +34,7 @@ static pcover reduce_gasp(F, D) pcover F, D;
   pcube p, last, cunder, *FD;
   pcover G;
 
+  PROFILE_IN(F->count);
   G = new_cover(F->count);
   FD = cube2list(F, D);
 
@@ -75,6 +76,8 @@ IN pcover Foriginal;
   int c1index;
   pcover G;
 
+  PROFILE_IN(F->count);
+
   /* Try to expand each nonprime and noncovered cube */
   G = new_cover(10);
   for (c1index = 0; c1index < F->count; c1index++) {
@@ -173,6 +176,7 @@ pcover *G;
 /* irred_gasp -- Add new primes to F and find an irredundant subset */
 pcover irred_gasp(F, D, G) pcover F, D, G; /* G is disposed of */
 {
+  PROFILE_IN(F->count + G->count);
   if (G->count != 0)
     F = irredundant(sf_append(F, G), D);
   else
@@ -186,6 +190,7 @@ cost_t *cost;
 {
   pcover G, G1;
 
+  PROFILE_IN(F->count);
   EXECUTE(G = reduce_gasp(F, D), GREDUCE_TIME, G, *cost);
   EXECUTE(G1 = expand_gasp(G, D, R, F), GEXPAND_TIME, G1, *cost);
   free_cover(G);
@@ -199,6 +204,7 @@ cost_t *cost;
 {
   pcover G, G1;
 
+  PROFILE_IN(F->count);
   EXECUTE(G = reduce_gasp(F, D), GREDUCE_TIME, G, *cost);
   EXECUTE(G1 = all_primes(G, R), GEXPAND_TIME, G1, *cost);
   free_cover(G);
@@ -8,13 +8,14 @@
 unsigned int debug;           /* debug parameter */
 bool verbose_debug;           /* -v:  whether to print a lot */
 char *total_name[TIME_COUNT]; /* basic function names */
-long total_time[TIME_COUNT];  /* time spent in basic fcts */
-int total_calls[TIME_COUNT];  /* # calls to each fct */
+ESPRESSO_TLS long total_time[TIME_COUNT]; /* time spent in basic fcts */
+ESPRESSO_TLS int total_calls[TIME_COUNT]; /* # calls to each fct */
 
 bool echo_comments;         /* turned off by -eat option */
 bool echo_unknown_commands; /* always true ?? */
+FILE *echo_file;            /* where read_pla() echoes them */
 bool force_irredundant;     /* -nirr command line option */
-bool skip_make_sparse;
+ESPRESSO_TLS bool skip_make_sparse; /* per thread (-Dso runs threads) */
 bool kiss;             /* -kiss command line option */
 bool pos;              /* -pos command line option */
 bool print_solution;   /* -x command line option */
@@ -26,6 +27,9 @@ bool trace;            /* -t command line option */
 bool unwrap_onset;     /* -nunwrap command line option */
 bool use_random_order; /* -random command line option */
 bool use_super_gasp;   /* -strong command line option */
+bool use_zdd_primes;   /* -zdd command line option */
+int task_threads;      /* -j command line option */
+int task_cutoff;       /* -j N,cutoff: smallest list to fork */
 char *filename;        /* filename PLA was read from */
 
 struct pla_types_struct pla_types[] = {"-f",        F_type,
@@ -48,10 +52,16 @@ struct pla_types_struct pla_types[] = {"-f",        F_type,
                                        "-kiss",     KISS_type,
                                        "-cons",     CONSTRAINTS_type,
                                        "-scons",    SYMBOLIC_CONSTRAINTS_type,
+                                       "-binary",   BINARY_type | F_type,
+                                       "-binaryfd", BINARY_type | FD_type,
+                                       "-binaryfr", BINARY_type | FR_type,
+                                       "-binaryfdr", BINARY_type | FDR_type,
                                        0,           0};
 
-struct cube_struct cube, temp_cube_save;
-struct cdata_struct cdata, temp_cdata_save;
+/* per-thread minimizer state (see activate_ctx() in cubestr.c) */
+ESPRESSO_TLS budget_t *budget = NULL; /* see activate_ctx() */
+ESPRESSO_TLS struct cube_struct cube, temp_cube_save;
+ESPRESSO_TLS struct cdata_struct cdata, temp_cdata_save;
 
 int bit_count[256] = {
     0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 1, 2, 2, 3, 2, 3, 3, 4,
@@ -7,7 +7,14 @@ static void ftautology();
 
 static bool ftaut_special_cases();
 
-static int Rp_current;
+static void irred_derive_parallel();
+
+static void irred_reduce_table();
+
+/* the cube of Rp being covered; cubes of Rp after it are still redundant */
+static ESPRESSO_TLS pcube Rp_current;
+
+#define IS_REDUND(p) (TESTP(p, REDUND) && (p) >= Rp_current)
 
 /*
  *   irredundant -- Return a minimal subset of F
@@ -15,6 +22,7 @@ static int Rp_current;
 
 pcover irredundant(F, D) pcover F, D;
 {
+  PROFILE_IN(F->count);
   mark_irredundant(F, D);
   return sf_inactive(F);
 }
@@ -151,9 +159,15 @@ sm_matrix *irred_derive_table(D, E, Rp) pcover D, E, Rp;
   list = cube3list(D, E, Rp);
   table = sm_alloc();
   size_last_dominance = 0;
+  if (task_active(Rp->count)) {
+    irred_derive_parallel(list, Rp, table, &size_last_dominance);
+    foreach_set(Rp, last, p) { RESET(p, REDUND); }
+    free_cubelist(list);
+    return table;
+  }
   i = 0;
   foreach_set(Rp, last, p) {
-    Rp_current = SIZE(p);
+    Rp_current = p;
     fcube_is_covered(list, p, table);
     RESET(p, REDUND); /* can now consider this cube redundant */
     if (debug & IRRED1) {
@@ -161,15 +175,7 @@ sm_matrix *irred_derive_table(D, E, Rp) pcover D, E, Rp;
                    Rp->count, Rp->count - i, table->nrows, table->ncols,
                    print_time(ptime()));
     }
-    /* try to keep memory limits down by reducing table as we go along */
-    if (table->nrows - size_last_dominance > 1000) {
-      (void)sm_row_dominance(table);
-      size_last_dominance = table->nrows;
-      if (debug & IRRED1) {
-        (void)printf("IRRED1: delete redundant rows, now %dx%d\n", table->nrows,
-                     table->ncols);
-      }
-    }
+    irred_reduce_table(table, &size_last_dominance);
     i++;
   }
   free_cubelist(list);
@@ -177,30 +183,151 @@ sm_matrix *irred_derive_table(D, E, Rp) pcover D, E, Rp;
   return table;
 }
 
+/* irred_reduce_table -- keep memory limits down by reducing the table */
+static void irred_reduce_table(table, size_last_dominance) sm_matrix *table;
+int *size_last_dominance;
+{
+  if (table->nrows - *size_last_dominance > 1000) {
+    (void)sm_row_dominance(table);
+    *size_last_dominance = table->nrows;
+    if (debug & IRRED1) {
+      (void)printf("IRRED1: delete redundant rows, now %dx%d\n", table->nrows,
+                   table->ncols);
+    }
+  }
+}
+
+/*
+ *  irred_derive_parallel -- irred_derive_table() on several threads
+ *
+ *  The rows found for a cube of Rp depend only on its position in Rp
+ *  (the cubes after it are the redundant ones), so runs of consecutive
+ *  cubes are handed to the worker threads, each one building its rows
+ *  in a private matrix.  The rows are then added to the table in the
+ *  original order, reducing it at the same points as the serial loop.
+ */
+
+typedef struct {
+  pcube *list;     /* D, E and Rp */
+  pcover Rp;
+  int first, last; /* the cubes first ... last-1 of Rp */
+  sm_matrix *rows; /* the rows found for them */
+  int *end;        /* rows->nrows after each cube */
+  task_t task;
+} irred_chunk_t;
+
+static void irred_chunk(c) irred_chunk_t *c;
+{
+  register int i;
+
+  for (i = c->first; i < c->last; i++) {
+    Rp_current = GETSET(c->Rp, i);
+    fcube_is_covered(c->list, Rp_current, c->rows);
+    c->end[i - c->first] = c->rows->nrows;
+  }
+}
+
+static void irred_derive_parallel(list, Rp, table,
+                                  size_last_dominance) pcube *list;
+pcover Rp;
+sm_matrix *table;
+int *size_last_dominance;
+{
+  register irred_chunk_t *c;
+  register sm_row *row;
+  register sm_element *pe;
+  irred_chunk_t *chunk;
+  int nchunk, size, i, k, rownum;
+
+  /* a few runs per thread, so that the threads stay busy */
+  size = (Rp->count + 8 * task_threads - 1) / (8 * task_threads);
+  nchunk = (Rp->count + size - 1) / size;
+  chunk = ALLOC(irred_chunk_t, nchunk);
+  for (k = 0; k < nchunk; k++) {
+    c = chunk + k;
+    c->list = list;
+    c->Rp = Rp;
+    c->first = k * size;
+    c->last = MIN(c->first + size, Rp->count);
+    c->rows = sm_alloc();
+    c->end = ALLOC(int, c->last - c->first);
+  }
+
+  /* keep one run per thread in progress, and merge them in order */
+  for (k = 0; k < nchunk && k < task_threads; k++) {
+    task_spawn(&chunk[k].task, irred_chunk, (char *)&chunk[k]);
+  }
+  for (k = 0; k < nchunk; k++) {
+    c = chunk + k;
+    (void)task_join(&c->task, TRUE);
+    if (k + task_threads < nchunk) {
+      task_spawn(&chunk[k + task_threads].task, irred_chunk,
+                 (char *)&chunk[k + task_threads]);
+    }
+
+    row = c->rows->first_row;
+    for (i = c->first; i < c->last; i++) {
+      for (; row != NIL(sm_row) && row->row_num < c->end[i - c->first];
+           row = row->next_row) {
+        rownum = table->last_row ? table->last_row->row_num + 1 : 0;
+        sm_foreach_row_element(row, pe) {
+          (void)sm_insert(table, rownum, pe->col_num);
+        }
+      }
+      irred_reduce_table(table, size_last_dominance);
+    }
+    sm_free(c->rows);
+    FREE(c->end);
+  }
+  FREE(chunk);
+}
+
 /* cube_is_covered -- determine if a cubelist "covers" a single cube */
 bool cube_is_covered(T, c) pcube *T, c;
 { return tautology(cofactor(T, c)); }
 
+/* one branch of tautology(), possibly run by another thread */
+typedef struct {
+  pcube *T;    /* cube list being split */
+  pcube c;     /* cube to cofactor against */
+  int var;     /* the splitting variable */
+  bool result; /* the cofactor is a tautology */
+} taut_branch_t;
+
+static void taut_branch(b) taut_branch_t *b;
+{ b->result = tautology(scofactor(b->T, b->c, b->var)); }
+
 /* tautology -- answer the tautology question for T */
 bool tautology(T) pcube *T; /* T will be disposed of */
 {
   register pcube cl, cr;
   register int best, result;
-  static int taut_level = 0;
+  taut_branch_t right;
+  task_t task;
+  static ESPRESSO_TLS int taut_level = 0;
 
   if (debug & TAUT) {
     debug_print(T, "TAUTOLOGY", taut_level++);
   }
 
   if ((result = taut_special_cases(T)) == MAYBE) {
-    cl = new_cube();
-    cr = new_cube();
+    cl = new_temp_cube();
+    cr = new_temp_cube();
     best = binate_split_select(T, cl, cr, TAUT);
-    result =
-        tautology(scofactor(T, cl, best)) && tautology(scofactor(T, cr, best));
+    if (task_active(CUBELISTSIZE(T))) {
+      right.T = T, right.c = cr, right.var = best;
+      task_spawn(&task, taut_branch, (char *)&right);
+      result = tautology(scofactor(T, cl, best));
+      /* the right half is only needed if the left one is a tautology */
+      if (task_join(&task, result))
+        result = result && right.result;
+    } else {
+      result = tautology(scofactor(T, cl, best)) &&
+               tautology(scofactor(T, cr, best));
+    }
     free_cubelist(T);
-    free_cube(cl);
-    free_cube(cr);
+    free_temp_cube(cl);
+    free_temp_cube(cr);
   }
 
   if (debug & TAUT) {
@@ -307,23 +434,23 @@ sm_matrix *table;
 {
   register pcube cl, cr;
   register int best;
-  static int ftaut_level = 0;
+  static ESPRESSO_TLS int ftaut_level = 0;
 
   if (debug & TAUT) {
     debug_print(T, "FIND_TAUTOLOGY", ftaut_level++);
   }
 
   if (ftaut_special_cases(T, table) == MAYBE) {
-    cl = new_cube();
-    cr = new_cube();
+    cl = new_temp_cube();
+    cr = new_temp_cube();
     best = binate_split_select(T, cl, cr, TAUT);
 
     ftautology(scofactor(T, cl, best), table);
     ftautology(scofactor(T, cr, best), table);
 
     free_cubelist(T);
-    free_cube(cl);
-    free_cube(cr);
+    free_temp_cube(cl);
+    free_temp_cube(cr);
   }
 
   if (debug & TAUT) {
@@ -341,7 +468,7 @@ sm_matrix *table;
 
   /* Check for a row of all 1's in the essential cubes */
   for (T1 = T + 2; (p = *T1++) != 0;) {
-    if (!TESTP(p, REDUND)) {
+    if (!IS_REDUND(p)) {
       if (full_row(p, T[0])) {
         /* subspace is covered by essentials -- no new rows for table */
         free_cubelist(T);
@@ -358,9 +485,9 @@ start:
   if (cdata.vars_unate == cdata.vars_active) {
     /* find which nonessentials cover this subspace */
     rownum = table->last_row ? table->last_row->row_num + 1 : 0;
-    (void)sm_insert(table, rownum, Rp_current);
+    (void)sm_insert(table, rownum, (int)SIZE(Rp_current));
     for (T1 = T + 2; (p = *T1++) != 0;) {
-      if (TESTP(p, REDUND)) {
+      if (IS_REDUND(p)) {
         /* See if a redundant cube covers this leaf */
         if (full_row(p, T[0])) {
           (void)sm_insert(table, rownum, (int)SIZE(p));
@@ -11,24 +11,32 @@
 static FILE *last_fp;
 static int input_type = FD_type;
 
+static budget_t main_budget; /* -B */
+static void many_espresso();
+static void batch_espresso();
+static bool parse_budget();
+static bool print_primes();
+
 main(argc, argv) int argc;
 char *argv[];
 {
-  int i, j, first, last, strategy, out_type, option;
+  int i, j, first, last, strategy, out_type, option, cluster_size;
   pPLA PLA, PLA1;
   pcover F, Fold, Dold;
   pset last1, p;
   cost_t cost;
   bool error, exact_cover;
   long start;
-  char *optarg;
-  int optind;
+  double limit;
+  extern char *optarg;
+  extern int optind;
 
   start = ptime();
 
   error = FALSE;
 
   init_runtime();
+  setv_init();
 
 #ifdef RANDOM
   srandom(314973);
@@ -44,6 +52,7 @@ char *argv[];
   strategy = 0;          /* default -S: strategy number */
   first = -1;            /* default -R: select range */
   last = -1;
+  cluster_size = 32;     /* outputs per cluster for -Dcluster (-e cluster=N) */
   remove_essential = TRUE; /* default -e: */
   force_irredundant = TRUE;
   unwrap_onset = TRUE;
@@ -51,16 +60,20 @@ char *argv[];
   pos = FALSE;
   recompute_onset = FALSE;
   use_super_gasp = FALSE;
+  use_zdd_primes = FALSE;
   use_random_order = FALSE;
   kiss = FALSE;
   echo_comments = TRUE;
   echo_unknown_commands = TRUE;
+  echo_file = stdout;
   exact_cover = FALSE; /* for -qm option, the default */
+  task_threads = 1;    /* default -j: single threaded */
+  task_cutoff = 64;
 
   backward_compatibility_hack(&argc, argv, &option, &out_type);
 
   /* parse command line options*/
-  while ((i = getopt(argc, argv, "D:S:de:o:r:stv:x")) != EOF) {
+  while ((i = getopt(argc, argv, "B:D:P:S:de:j:o:r:stv:x")) != EOF) {
     switch (i) {
     case 'D': /* -Dcommand invokes a subcommand */
       for (j = 0; option_table[j].name != 0; j++) {
@@ -89,6 +102,13 @@ char *argv[];
       break;
 
     case 'e': /* -eespresso selects an option for espresso */
+      if (sscanf(optarg, "exact_limit=%lf", &limit) == 1) {
+        sm_mincov_time_limit = (long)(limit * 1000.0 + 0.5);
+        break;
+      }
+      if (sscanf(optarg, "cluster=%d", &cluster_size) == 1) {
+        break;
+      }
       for (j = 0; esp_opt_table[j].name != 0; j++) {
         if (strcmp(optarg, esp_opt_table[j].name) == 0) {
           *(esp_opt_table[j].variable) = esp_opt_table[j].value;
@@ -138,6 +158,36 @@ char *argv[];
       strategy = atoi(optarg);
       break;
 
+    case 'B': /* -Btime=s,mem=n limits each minimization */
+      if (!parse_budget(optarg, &main_budget)) {
+        (void)fprintf(stderr, "%s: bad budget \"%s\"\n", argv[0], optarg);
+        exit(1);
+      }
+      budget = &main_budget;
+      break;
+
+    case 'P': /* -Pfile appends a JSON line per phase to file */
+#ifndef NO_PROFILE
+      if (!profile_open(optarg)) {
+        (void)fprintf(stderr, "%s: cannot open %s\n", argv[0], optarg);
+        exit(1);
+      }
+#else
+      (void)fprintf(stderr, "%s: -P was configured out (--disable-profile)\n",
+                    argv[0]);
+      exit(1);
+#endif
+      break;
+
+    case 'j': /* -jn[,cutoff] sets the number of threads */
+      if (sscanf(optarg, "%d,%d", &task_threads, &task_cutoff) < 1 ||
+          task_threads < 1 || task_cutoff < 1) {
+        (void)fprintf(stderr, "%s: bad thread count \"%s\"\n", argv[0],
+                      optarg);
+        exit(1);
+      }
+      break;
+
     case 'r': /* -r selects range (outputs or vars) */
       if (sscanf(optarg, "%d-%d", &first, &last) < 2) {
         (void)fprintf(stderr, "%s: bad output range \"%s\"\n", argv[0], optarg);
@@ -153,6 +203,12 @@ char *argv[];
     }
   }
 
+  /* comments and unknown commands would end up inside a binary cover */
+  if (out_type & BINARY_type) {
+    echo_comments = FALSE;
+    echo_unknown_commands = FALSE;
+  }
+
   /* provide version information and summaries */
   if (summary || trace) {
     /* echo command line and arguments */
@@ -162,7 +218,16 @@ char *argv[];
     }
     printf("\n");
     printf("# %s\n", VERSION);
+    printf("# set kernels: %s\n", setv.name);
+    if (task_threads > 1) {
+      printf("# threads: %d (cutoff %d cubes)\n", task_threads, task_cutoff);
+    }
+    if (budget != NULL) {
+      printf("# budget: time %ld ms, memory %ld bytes (0 for no limit)\n",
+             budget->time, budget->mem);
+    }
   }
+  task_init(task_threads);
 
   /* the remaining arguments are argv[optind ... argc-1] */
   PLA = PLA1 = NIL(PLA_t);
@@ -210,8 +275,16 @@ char *argv[];
     }
     break;
 
+  case KEY_batch:
+    batch_espresso(out_type);
+    exit(0);
+
   case KEY_MANY_ESPRESSO: {
     int pla_type;
+    if (task_independent()) {
+      many_espresso(PLA, out_type);
+      exit(0);
+    }
     do {
       EXEC(PLA->F = espresso(PLA->F, PLA->D, PLA->R), "ESPRESSO   ", PLA->F);
       if (print_solution) {
@@ -227,6 +300,11 @@ char *argv[];
     exit(0);
   }
 
+  case KEY_cluster:
+    EXEC(PLA->F = cluster_espresso(PLA->F, PLA->D, cluster_size),
+         "CLUSTER    ", PLA->F);
+    break;
+
   case KEY_simplify:
     EXEC(PLA->F = simplify(cube1list(PLA->F)), "SIMPLIFY  ", PLA->F);
     break;
@@ -298,6 +376,17 @@ char *argv[];
          PLA->F);
     break;
 
+  case KEY_zprimes: /* count and list the primes without a prime cover */
+    if (print_primes(stdout, PLA)) {
+      print_solution = FALSE;
+    } else {
+      (void)fprintf(stderr, "%s: no ZDD of the primes, using -Dprimes\n",
+                    argv[0]);
+      EXEC(PLA->F = primes_consensus(cube2list(PLA->F, PLA->D)),
+           "PRIMES     ", PLA->F);
+    }
+    break;
+
   case KEY_map: /* print out a Karnaugh map of function */
     map(PLA->F);
     print_solution = FALSE;
@@ -517,6 +606,214 @@ char *argv[];
   exit(0);
 }
 
+/*
+ *  many_espresso -- -Dmany on several threads
+ *
+ *  Each PLA is read into a minimizer context of its own and minimized by
+ *  a worker thread while the next ones are read; the results are printed
+ *  in the order of the input.  As for -Dso (see foreach_output_parallel),
+ *  a PLA is cancelled and minimized again if it did not start with the
+ *  reduce() ordering strategy which the PLAs before it left.
+ */
+
+typedef struct {
+  pctx ctx;
+  pPLA PLA;
+  pcover F;                   /* the ON-set as read */
+  FILE *echo;                 /* comments read with it, or NULL */
+  bool toggle_in, toggle_out; /* reduce_toggle() before and after */
+  task_t task;
+} many_t;
+
+static void many_minimize(m) many_t *m;
+{
+  bool save = reduce_toggle(); /* of the work this thread interrupted */
+
+  activate_ctx(m->ctx);
+  set_reduce_toggle(m->toggle_in);
+#ifndef NO_PROFILE
+  profile_input = m->PLA->filename;
+#endif
+  m->PLA->F = espresso(sf_save(m->F), m->PLA->D, m->PLA->R);
+#ifndef NO_PROFILE
+  profile_input = NULL;
+#endif
+  m->toggle_out = reduce_toggle();
+  deactivate_ctx(m->ctx);
+  set_reduce_toggle(save);
+}
+
+/* print_echo -- copy the comments held in a temporary file to stdout */
+static void print_echo(fp) FILE *fp;
+{
+  register int ch;
+
+  if (fp != NULL) {
+    rewind(fp);
+    while ((ch = getc(fp)) != EOF)
+      putchar(ch);
+    (void)fclose(fp);
+  }
+}
+
+static void many_espresso(PLA, out_type) pPLA PLA;
+int out_type;
+{
+  register many_t *m;
+  many_t *ring;
+  FILE *trailer;
+  int first, count, pla_type;
+  bool eof, toggle;
+
+  /* keep one PLA per thread in progress */
+  ring = ALLOC(many_t, task_threads);
+  toggle = reduce_toggle();
+  m = ring;
+  m->ctx = take_ctx(); /* the first PLA is already read */
+  m->PLA = PLA;
+  m->F = PLA->F;
+  m->echo = NULL;
+  m->toggle_in = toggle;
+  pla_type = PLA->pla_type;
+  task_start(&m->task, many_minimize, (char *)m);
+  first = 0;
+  count = 1;
+  eof = FALSE;
+  trailer = NULL; /* the comments after the last PLA */
+
+  while (count > 0) {
+    /* read ahead */
+    while (!eof && count < task_threads) {
+      m = ring + (first + count) % task_threads;
+      m->ctx = new_ctx();
+      m->echo = tmpfile(); /* hold its comments until it is printed */
+      echo_file = m->echo != NULL ? m->echo : stdout;
+      activate_ctx(m->ctx);
+      eof = read_pla(last_fp, TRUE, TRUE, pla_type, &m->PLA) == EOF;
+      deactivate_ctx(m->ctx);
+      echo_file = stdout;
+      if (eof) {
+        free_ctx(m->ctx);
+        trailer = m->echo;
+      } else {
+        pla_type = m->PLA->pla_type;
+        m->F = m->PLA->F;
+        m->toggle_in = toggle;
+        task_start(&m->task, many_minimize, (char *)m);
+        count++;
+      }
+    }
+
+    /* print the oldest one */
+    m = ring + first;
+    if (m->toggle_in != toggle) {
+      task_cancel(&m->task);
+      if (task_join(&m->task, FALSE)) {
+        activate_ctx(m->ctx);
+        free_cover(m->PLA->F);
+        deactivate_ctx(m->ctx);
+      }
+      m->toggle_in = toggle;
+      many_minimize(m);
+    } else {
+      (void)task_join(&m->task, TRUE);
+    }
+    toggle = m->toggle_out;
+    print_echo(m->echo);
+    activate_ctx(m->ctx);
+    if (print_solution) {
+      fprint_pla(stdout, m->PLA, out_type);
+      (void)fflush(stdout);
+    }
+    free_cover(m->F);
+    free_PLA(m->PLA);
+    deactivate_ctx(m->ctx);
+    free_ctx(m->ctx);
+    first = (first + 1) % task_threads;
+    count--;
+  }
+  print_echo(trailer);
+  set_reduce_toggle(toggle);
+  FREE(ring);
+}
+
+/*
+ *  batch_espresso -- -Dbatch: minimize a stream of PLAs read from stdin
+ *
+ *  Each job is a line with either a byte count n, followed by n bytes of
+ *  PLA text, or the name of a PLA file.  The jobs are answered in order,
+ *  each with a line holding the byte count of the result followed by the
+ *  result as -Dmany prints it, or with the line "-1" if no PLA could be
+ *  read.  stdout is flushed after every answer.  The cube structure is
+ *  kept from one job to the next while they have the same shape.
+ */
+static void batch_espresso(out_type) int out_type;
+{
+  char line[BUFSIZ], *s;
+  FILE *in, *out;
+  pPLA PLA;
+  long n;
+  int ch;
+  bool ok, toggle;
+
+  if (summary || trace || debug != 0)
+    fatal("-Dbatch cannot be used with -d, -s or -t");
+  toggle = reduce_toggle(); /* every job is minimized as if run alone */
+
+  while (fgets(line, sizeof(line), stdin) != NULL) {
+    if ((s = strchr(line, '\n')) != NULL)
+      *s = '\0';
+    if (line[0] == '\0')
+      continue;
+
+    /* get the job onto a file of its own */
+    n = strtol(line, &s, 10);
+    if (*s == '\0') {
+      if ((in = tmpfile()) == NULL)
+        fatal("-Dbatch: cannot create a temporary file");
+      for (; n > 0 && (ch = getchar()) != EOF; n--)
+        putc(ch, in);
+      rewind(in);
+    } else if ((in = fopen(line, "r")) == NULL) {
+      (void)fprintf(stderr, "%s: cannot open\n", line);
+    }
+
+    /* minimize it into another one */
+    if ((out = tmpfile()) == NULL)
+      fatal("-Dbatch: cannot create a temporary file");
+    ok = FALSE;
+#ifndef NO_PROFILE
+    profile_input = *s == '\0' ? "(stdin)" : line;
+#endif
+    if (in != NULL) {
+      echo_file = out;
+      ok = read_pla(in, TRUE, TRUE, input_type, &PLA) != EOF;
+      echo_file = stdout;
+      (void)fclose(in);
+      if (ok) {
+        set_reduce_toggle(toggle);
+        PLA->F = espresso(PLA->F, PLA->D, PLA->R);
+        if (print_solution)
+          fprint_pla(out, PLA, out_type);
+      }
+      free_PLA(PLA);
+      if (cube.fullset != NULL) {
+        keep_cube();
+      } else if (cube.part_size != NULL) {
+        FREE(cube.part_size);
+      }
+    }
+
+    /* and answer */
+    (void)printf("%ld\n", ok ? ftell(out) : -1L);
+    rewind(out);
+    while (ok && (ch = getc(out)) != EOF)
+      putchar(ch);
+    (void)fclose(out);
+    (void)fflush(stdout);
+  }
+}
+
 getPLA(opt, argc, argv, option, PLA, out_type) int opt;
 int argc;
 char *argv[];
@@ -548,11 +845,17 @@ int out_type;
     needs_offset = option_table[option].needs_offset;
   }
 
+#ifndef NO_PROFILE
+  profile_input = fname; /* for the complement taken while reading */
+#endif
   if (read_pla(fp, needs_dcset, needs_offset, input_type, PLA) == EOF) {
     (void)fprintf(stderr, "%s: Unable to find PLA on file %s\n", argv[0],
                   fname);
     exit(1);
   }
+#ifndef NO_PROFILE
+  profile_input = NULL;
+#endif
   (*PLA)->filename = util_strsav(fname);
   filename = (*PLA)->filename;
   /*    (void) fclose(fp);*/
@@ -612,15 +915,99 @@ subcommands() {
   printf("\n");
 }
 
+static void print_prime(p, fp) pcube p;
+FILE *fp;
+{ print_cube(fp, p, "01"); }
+
+/*
+ *  print_primes -- -Dzprimes: compute the primes of F + D as a ZDD, and
+ *  write their number and then (unless -x) the primes one at a time;
+ *  FALSE if the ZDD cannot be built (see zdd_primes())
+ */
+static bool print_primes(fp, PLA) FILE *fp;
+pPLA PLA;
+{
+  zdd_t *z;
+  int root;
+  double count;
+  long t = ptime();
+
+  z = zdd_new();
+  if ((root = zdd_primes(z, PLA->F, PLA->D)) < 0) {
+    zdd_free(z);
+    return FALSE;
+  }
+  count = zdd_count(z, root);
+  if (trace || summary) {
+    (void)printf("# ZPRIMES    \tTime was %s, %.0f primes\n",
+                 print_time(ptime() - t), count);
+  }
+  (void)fprintf(fp, "# %.0f primes\n", count);
+  if (print_solution) {
+    fpr_header(fp, PLA, F_type);
+    (void)fprintf(fp, ".p %.0f\n", count);
+    zdd_foreach(z, root, print_prime, (char *)fp);
+    (void)fprintf(fp, ".e\n");
+  }
+  zdd_free(z);
+  return TRUE;
+}
+
+/*
+ *  parse_budget -- read the -B argument "time=seconds,mem=bytes" into b;
+ *  the memory size may end in k, m or g
+ */
+static bool parse_budget(s, b) char *s;
+budget_t *b;
+{
+  double value;
+  int n;
+
+  while (*s != '\0') {
+    if (sscanf(s, "time=%lf%n", &value, &n) == 1 && value >= 0) {
+      b->time = (long)(value * 1000.0 + 0.5);
+      s += n;
+    } else if (sscanf(s, "mem=%lf%n", &value, &n) == 1 && value >= 0) {
+      s += n;
+      switch (*s) {
+      case 'g':
+      case 'G':
+        value *= 1024.0;
+        /* FALLTHROUGH */
+      case 'm':
+      case 'M':
+        value *= 1024.0;
+        /* FALLTHROUGH */
+      case 'k':
+      case 'K':
+        value *= 1024.0;
+        s++;
+      }
+      b->mem = (long)value;
+    } else {
+      return FALSE;
+    }
+    if (*s == ',')
+      s++;
+    else if (*s != '\0')
+      return FALSE;
+  }
+  return TRUE;
+}
+
 usage() {
   printf("%s\n\n", VERSION);
   printf("SYNOPSIS: espresso [options] [file]\n\n");
+  printf("  -B[lim]   Budget for each minimization: time=seconds,mem=bytes\n");
   printf("  -d        Enable debugging\n");
   printf("  -e[opt]   Select espresso option:\n");
   printf("                fast, ness, nirr, nunwrap, onset, pos, strong,\n");
-  printf("                eat, eatdots, kiss, random\n");
+  printf("                eat, eatdots, kiss, random, zdd, exact_limit=s,\n");
+  printf("                cluster=n\n");
+  printf("  -jn[,c]   Use n threads for lists of at least c cubes (64)\n");
   printf("  -o[type]  Select output format:\n");
   printf("                f, fd, fr, fdr, pleasure, eqntott, kiss, cons\n");
+  printf("  -Pfile    Append a JSON line per phase (time, size) to file\n");
   printf("  -rn-m     Select range for subcommands:\n");
   printf("                d1merge: first and last variables (0 ... m-1)\n");
   printf("                minterms: first and last variables (0 ... m-1)\n");
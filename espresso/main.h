@@ -9,7 +9,8 @@ enum keys {
     KEY_pair, KEY_pairall, KEY_primes, KEY_qm, KEY_reduce, KEY_sharp,
     KEY_simplify, KEY_so, KEY_so_both, KEY_stats, KEY_super_gasp, KEY_taut,
     KEY_test, KEY_equiv, KEY_union, KEY_verify, KEY_MANY_ESPRESSO,
-    KEY_separate, KEY_xor, KEY_d1merge_in, KEY_fsm,
+    KEY_separate, KEY_xor, KEY_d1merge_in, KEY_fsm, KEY_batch, KEY_zprimes,
+    KEY_cluster,
     KEY_unknown
 };
 
@@ -24,11 +25,13 @@ struct {
     /* ways to minimize functions */
     "ESPRESSO", KEY_ESPRESSO, 1, TRUE, TRUE,    /* must be first */
     "many", KEY_MANY_ESPRESSO, 1, TRUE, TRUE,
+    "batch", KEY_batch, 0, TRUE, TRUE,
     "exact", KEY_exact, 1, TRUE, TRUE,
     "qm", KEY_qm, 1, TRUE, TRUE,
     "single_output", KEY_so, 1, TRUE, TRUE,
     "so", KEY_so, 1, TRUE, TRUE,
     "so_both", KEY_so_both, 1, TRUE, TRUE,
+    "cluster", KEY_cluster, 1, FALSE, TRUE,
     "simplify", KEY_simplify, 1, FALSE, FALSE,
     "echo", KEY_echo, 1, FALSE, FALSE,
 
@@ -59,6 +62,7 @@ struct {
     "intersect", KEY_intersect, 2, FALSE, FALSE,
     "minterms", KEY_minterms, 1, FALSE, FALSE,
     "primes", KEY_primes, 1, FALSE, TRUE,
+    "zprimes", KEY_zprimes, 1, FALSE, TRUE,
     "separate", KEY_separate, 1, TRUE, TRUE,
     "sharp", KEY_sharp, 2, FALSE, FALSE,
     "union", KEY_union, 2, FALSE, FALSE,
@@ -112,5 +116,6 @@ struct {
     "pos", &pos, TRUE,
     "random", &use_random_order, TRUE,
     "strong", &use_super_gasp, TRUE,
+    "zdd", &use_zdd_primes, TRUE,
     0,
 };
@@ -1,8 +1,8 @@
 
 #include "espresso.h"
 
-static pcube Gcube;
-static pset Gminterm;
+static ESPRESSO_TLS pcube Gcube;
+static ESPRESSO_TLS pset Gminterm;
 
 pset minterms(T) pcover T;
 {
@@ -2,17 +2,30 @@
 #include "../port/port.h"
 #include "sparse_int.h"
 
+#ifndef SM_NO_POOL
+ESPRESSO_TLS sm_element *sm_element_freelist;
+ESPRESSO_TLS sm_row *sm_row_freelist;
+ESPRESSO_TLS sm_col *sm_col_freelist;
+
+/* the pools of the thread, for sm_cleanup() */
+typedef struct sm_pool_struct {
+  struct sm_pool_struct *next;
+  double align; /* the objects follow */
+} sm_pool;
+static ESPRESSO_TLS sm_pool *sm_pools;
+
 /*
- *  free-lists are only used if 'FAST_AND_LOOSE' is set; this is because
- *  we lose the debugging capability of libmm_t which trashes objects when
- *  they are free'd.  However, FAST_AND_LOOSE is much faster if matrices
- *  are created and freed frequently.
+ *  sm_pool_alloc -- storage for SM_POOL objects of the given size
  */
+char *sm_pool_alloc(size) int size;
+{
+  register sm_pool *pool;
 
-#ifdef FAST_AND_LOOSE
-sm_element *sm_element_freelist;
-sm_row *sm_row_freelist;
-sm_col *sm_col_freelist;
+  pool = (sm_pool *)ALLOC(char, sizeof(sm_pool) + SM_POOL * size);
+  pool->next = sm_pools;
+  sm_pools = pool;
+  return (char *)(pool + 1);
+}
 #endif
 
 sm_matrix *sm_alloc() {
@@ -40,21 +53,25 @@ sm_matrix *sm_alloc_size(row, col) int row, col;
 
 void sm_free(A) sm_matrix *A;
 {
-#ifdef FAST_AND_LOOSE
+#ifndef SM_NO_POOL
   register sm_row *prow;
 
-  if (A->first_row != 0) {
-    for (prow = A->first_row; prow != 0; prow = prow->next_row) {
-      /* add the elements to the free list of elements */
+  for (prow = A->first_row; prow != 0; prow = prow->next_row) {
+    /* add the elements to the free list of elements */
+    if (prow->first_col != 0) {
       prow->last_col->next_col = sm_element_freelist;
       sm_element_freelist = prow->first_col;
     }
+  }
 
-    /* Add the linked list of rows to the row-free-list */
+  /* Add the linked list of rows to the row-free-list */
+  if (A->first_row != 0) {
     A->last_row->next_row = sm_row_freelist;
     sm_row_freelist = A->first_row;
+  }
 
-    /* Add the linked list of cols to the col-free-list */
+  /* Add the linked list of cols to the col-free-list */
+  if (A->first_col != 0) {
     A->last_col->next_col = sm_col_freelist;
     sm_col_freelist = A->first_col;
   }
@@ -171,6 +188,112 @@ register int row, col;
   return element;
 }
 
+/*
+ *  insert_sorted -- insert the n elements (row[i], col[i]) into the
+ *  matrix.  When they are sorted by row and then by column, and come
+ *  after the rows already in the matrix, each one is appended to its row
+ *  and column in constant time; any other element is inserted by
+ *  sm_insert().
+ */
+void sm_insert_sorted(A, n, row, col) register sm_matrix *A;
+int n, *row, *col;
+{
+  register sm_row *prow;
+  register sm_col *pcol, *pprev;
+  register sm_element *element;
+  register int i, r, c, j, maxrow, maxcol;
+
+  maxrow = maxcol = -1;
+  for (i = 0; i < n; i++) {
+    maxrow = MAX(maxrow, row[i]);
+    maxcol = MAX(maxcol, col[i]);
+  }
+  if (maxrow >= A->rows_size || maxcol >= A->cols_size) {
+    sm_resize(A, maxrow, maxcol);
+  }
+
+  for (i = 0; i < n; i++) {
+    r = row[i];
+    c = col[i];
+    prow = A->last_row;
+    if (prow != 0 &&
+        (r < prow->row_num ||
+         (r == prow->row_num &&
+          (prow->last_col == 0 || c <= prow->last_col->col_num)))) {
+      (void)sm_insert(A, r, c);
+      continue;
+    }
+
+    /* a new last row */
+    if (prow == 0 || r > prow->row_num) {
+      prow = A->rows[r] = sm_row_alloc();
+      prow->row_num = r;
+      prow->prev_row = A->last_row;
+      if (A->last_row == 0) {
+        A->first_row = prow;
+      } else {
+        A->last_row->next_row = prow;
+      }
+      A->last_row = prow;
+      A->nrows++;
+    }
+
+    /*
+     *  a new column goes after the closest column to its left, looked
+     *  up in A->cols when it is near (else the column list is walked)
+     */
+    pcol = A->cols[c];
+    if (pcol == NIL(sm_col)) {
+      pcol = A->cols[c] = sm_col_alloc();
+      pcol->col_num = c;
+      for (j = c - 1; j >= 0 && j >= c - A->ncols && A->cols[j] == 0; j--)
+        ;
+      if (j >= 0 && A->cols[j] == 0) {
+        sorted_insert(sm_col, A->first_col, A->last_col, A->ncols, next_col,
+                      prev_col, col_num, c, pcol);
+      } else {
+        pprev = j >= 0 ? A->cols[j] : NIL(sm_col);
+        pcol->prev_col = pprev;
+        pcol->next_col = pprev ? pprev->next_col : A->first_col;
+        if (pcol->next_col == 0) {
+          A->last_col = pcol;
+        } else {
+          pcol->next_col->prev_col = pcol;
+        }
+        if (pprev == 0) {
+          A->first_col = pcol;
+        } else {
+          pprev->next_col = pcol;
+        }
+        A->ncols++;
+      }
+    }
+
+    /* the element is the last of its row and of its column */
+    sm_element_alloc(element);
+    element->row_num = r;
+    element->col_num = c;
+    element->next_col = 0;
+    element->prev_col = prow->last_col;
+    if (prow->last_col == 0) {
+      prow->first_col = element;
+    } else {
+      prow->last_col->next_col = element;
+    }
+    prow->last_col = element;
+    prow->length++;
+    element->next_row = 0;
+    element->prev_row = pcol->last_row;
+    if (pcol->last_row == 0) {
+      pcol->first_row = element;
+    } else {
+      pcol->last_row->next_row = element;
+    }
+    pcol->last_row = element;
+    pcol->length++;
+  }
+}
+
 sm_element *sm_find(A, rownum, colnum) sm_matrix *A;
 int rownum, colnum;
 {
@@ -474,28 +597,21 @@ int max;
   }
 }
 
+/*
+ *  sm_cleanup -- give back the pools of the thread; no matrix or vector
+ *  allocated by it may be left (nor be used by another thread)
+ */
 void sm_cleanup() {
-#ifdef FAST_AND_LOOSE
-  register sm_element *p, *pnext;
-  register sm_row *prow, *pnextrow;
-  register sm_col *pcol, *pnextcol;
+#ifndef SM_NO_POOL
+  register sm_pool *pool, *pnext;
 
-  for (p = sm_element_freelist; p != 0; p = pnext) {
-    pnext = p->next_col;
-    FREE(p);
+  for (pool = sm_pools; pool != 0; pool = pnext) {
+    pnext = pool->next;
+    FREE(pool);
   }
+  sm_pools = 0;
   sm_element_freelist = 0;
-
-  for (prow = sm_row_freelist; prow != 0; prow = pnextrow) {
-    pnextrow = prow->next_row;
-    FREE(prow);
-  }
   sm_row_freelist = 0;
-
-  for (pcol = sm_col_freelist; pcol != 0; pcol = pnextcol) {
-    pnextcol = pcol->next_col;
-    FREE(pcol);
-  }
   sm_col_freelist = 0;
 #endif
 }
@@ -1,19 +1,84 @@
 
+#include "espresso.h"
 #include "mincov_int.h"
+#ifndef NO_THREADS
+#include <pthread.h>
+#endif
 
 /*
  *  mincov.c
+ *
+ *  With more than one thread (-j), the branch which rejects the picked
+ *  column is offered to the worker pool (see task.c) while the branch
+ *  which accepts it is searched.  The threads share the best cover found
+ *  so far (the incumbent) to prune each other's subtrees.  A tie is
+ *  settled in favour of the cover which the serial search finds first,
+ *  so the result is the same for any number of threads.
+ *
+ *  sm_mincov_time_limit bounds the search: past it no node branches any
+ *  more, and the best cover found so far (or a greedy completion of the
+ *  current one) is returned.
  */
 
 #define USE_GIMPEL
 #define USE_INDEP_SET
+#define CANCEL_POLL 64 /* nodes between calls of task_cancelled() */
+
+long sm_mincov_time_limit = 0;
+
+/* the branches taken from the root to a node (0 = accept, 1 = reject) */
+typedef struct path_struct path_t;
+struct path_struct {
+  int length;      /* number of branches from the root */
+  set_word_t *key; /* the branches as bits, if there is an incumbent */
+};
+
+/* the best cover found by any thread */
+typedef struct incumbent_struct incumbent_t;
+struct incumbent_struct {
+#ifndef NO_THREADS
+  pthread_mutex_t lock;
+#endif
+  int cost;        /* including the columns of the Gimpel reductions */
+  int length;      /* its path */
+  set_word_t *key;
+};
+
+/* one branch of sm_mincov(), possibly run by another thread */
+typedef struct {
+  sm_matrix *A;
+  solution_t *select;
+  int *weight;
+  int lb, bound, depth;
+  stats_t stats; /* the counters of this branch only */
+  path_t path;
+  solution_t *best;
+} mincov_branch_t;
 
 static int select_column();
 
+static solution_t *mincov_join();
+
 static void select_essential();
 
 static int verify_cover();
 
+static void path_enter();
+
+static void path_leave();
+
+static int incumbent_prunes();
+
+static void incumbent_update();
+
+static void mincov_branch(b) mincov_branch_t *b;
+{
+  b->best = sm_mincov(b->A, b->select, b->weight, b->lb, b->bound, b->depth,
+                      &b->stats);
+  solution_free(b->select);
+  sm_free(b->A);
+}
+
 #define fail(why)                                                              \
   {                                                                            \
     (void)fprintf(stderr, "Fatal error: file %s, line %d\n%s\n", __FILE__,     \
@@ -28,6 +93,8 @@ int heuristic;   /* set to 1 for a heuristic covering */
 int debug_level; /* how deep in the recursion to provide info */
 {
   stats_t stats;
+  incumbent_t shared;
+  path_t root;
   solution_t *best, *select;
   sm_row *prow, *sol;
   sm_col *pcol;
@@ -50,6 +117,26 @@ int debug_level; /* how deep in the recursion to provide info */
   stats.gimpel = stats.gimpel_count = 0;
   stats.no_branching = heuristic != 0;
   stats.lower_bound = -1;
+  stats.deadline = 0;
+  stats.cancelled = 0;
+  if (sm_mincov_time_limit > 0) {
+    stats.deadline = ptime() + sm_mincov_time_limit;
+  }
+  root.length = 0;
+  root.key = NIL(set_word_t);
+  stats.path = &root;
+  stats.shared = NIL(incumbent_t);
+  if (!stats.no_branching && !stats.debug && task_active(A->nrows)) {
+#ifndef NO_THREADS
+    (void)pthread_mutex_init(&shared.lock, NULL);
+#endif
+    shared.cost = -1;
+    shared.length = 0;
+    shared.key = NIL(set_word_t);
+    stats.shared = &shared;
+    root.key = ALLOC(set_word_t, 1);
+    root.key[0] = 0;
+  }
 
   /* Check the matrix sparsity */
   nelem = 0;
@@ -66,6 +153,13 @@ int debug_level; /* how deep in the recursion to provide info */
   best = sm_mincov(dup_A, select, weight, 0, bound, 0, &stats);
   sm_free(dup_A);
   solution_free(select);
+  if (stats.shared != NIL(incumbent_t)) {
+#ifndef NO_THREADS
+    (void)pthread_mutex_destroy(&shared.lock);
+#endif
+    FREE(shared.key);
+    FREE(root.key);
+  }
 
   if (stats.debug) {
     if (stats.no_branching) {
@@ -111,8 +205,12 @@ stats_t *stats;
 {
   sm_matrix *A1, *A2, *L, *R;
   sm_element *p;
+  sm_col *pcol;
   solution_t *select1, *select2, *best, *best1, *best2, *indep;
-  int pick, lb_new, debug;
+  int pick, lb_new, debug, parallel, stop;
+  path_t accept, reject, *save_path;
+  mincov_branch_t right;
+  task_t task;
 
   /* Start out with some debugging information */
   stats->nodes++;
@@ -120,6 +218,17 @@ stats_t *stats;
     stats->max_depth = depth;
   debug = stats->debug && (depth <= stats->max_print_depth);
 
+  /* The result is not wanted any more: take every column and return
+     (task_cancelled() takes the task lock, so it is not asked each time) */
+  if (!stats->cancelled && stats->nodes % CANCEL_POLL == 0) {
+    stats->cancelled = task_cancelled();
+  }
+  if (stats->cancelled) {
+    best = solution_dup(select);
+    sm_foreach_col(A, pcol) { solution_add(best, weight, pcol->col_num); }
+    return best;
+  }
+
   /* Apply row dominance, column dominance, and select essentials */
   select_essential(A, select, weight, bound);
   if (select->cost >= bound) {
@@ -161,7 +270,7 @@ stats_t *stats;
   }
 
   /* Check for bounding based on no better solution possible */
-  if (lb_new >= bound) {
+  if (lb_new >= bound || incumbent_prunes(stats, lb_new + stats->gimpel)) {
     if (debug)
       (void)printf("bounded\n");
     best = NIL(solution_t);
@@ -169,6 +278,7 @@ stats_t *stats;
     /* Check for new best solution */
   } else if (A->nrows == 0) {
     best = solution_dup(select);
+    incumbent_update(stats, best->cost + stats->gimpel);
     if (debug)
       (void)printf("BEST\n");
     if (stats->debug && stats->component == 0) {
@@ -217,13 +327,37 @@ stats_t *stats;
     if (debug)
       (void)printf("pick=%d\n", pick);
 
+    /* Offer the branch without this column to another thread */
+    parallel = !stats->no_branching && !stats->debug && task_active(A->nrows);
+    if (parallel) {
+      right.A = sm_dup(A);
+      right.select = solution_dup(select);
+      solution_reject(right.select, right.A, weight, pick);
+      right.weight = weight;
+      right.lb = lb_new;
+      right.bound = bound;
+      right.depth = depth + 1;
+      right.stats = *stats;
+      right.stats.nodes = right.stats.comp_count = 0;
+      right.stats.gimpel_count = 0;
+      right.stats.max_depth = -1;
+      path_enter(&right.path, stats->path, 1);
+      right.stats.path = &right.path;
+      task_spawn(&task, mincov_branch, (char *)&right);
+    }
+
     /* Assume we choose this column to be in the covering set */
+    save_path = stats->path;
+    path_enter(&accept, save_path, 0);
+    stats->path = &accept;
     A1 = sm_dup(A);
     select1 = solution_dup(select);
     solution_accept(select1, A1, weight, pick);
     best1 = sm_mincov(A1, select1, weight, lb_new, bound, depth + 1, stats);
     solution_free(select1);
     sm_free(A1);
+    stats->path = save_path;
+    path_leave(&accept);
 
     /* Update the upper bound if we found a better solution */
     if (best1 != NIL(solution_t) && bound > best1->cost) {
@@ -237,16 +371,39 @@ stats_t *stats;
 
     /* Check for reaching lower bound -- if so, don't actually branch */
     if (best1 != NIL(solution_t) && best1->cost == lb_new) {
+      if (parallel) {
+        task_cancel(&task);
+        best2 = mincov_join(&task, &right, stats, FALSE);
+        if (best2 != NIL(solution_t)) {
+          solution_free(best2);
+        }
+      }
       return best1;
     }
 
-    /* Now assume we cannot have that column */
-    A2 = sm_dup(A);
-    select2 = solution_dup(select);
-    solution_reject(select2, A2, weight, pick);
-    best2 = sm_mincov(A2, select2, weight, lb_new, bound, depth + 1, stats);
-    solution_free(select2);
-    sm_free(A2);
+    /* Now assume we cannot have that column (unless out of time) */
+    stop = stats->deadline != 0 && ptime() >= stats->deadline;
+    if (parallel) {
+      if (stop) {
+        task_cancel(&task); /* but keep what it found */
+      } else if (!task.offered && right.bound > bound) {
+        right.bound = bound; /* not started, nobody else sees it */
+      }
+      best2 = mincov_join(&task, &right, stats, !stop);
+    } else if (stop) {
+      return best1;
+    } else {
+      path_enter(&reject, save_path, 1);
+      stats->path = &reject;
+      A2 = sm_dup(A);
+      select2 = solution_dup(select);
+      solution_reject(select2, A2, weight, pick);
+      best2 = sm_mincov(A2, select2, weight, lb_new, bound, depth + 1, stats);
+      solution_free(select2);
+      sm_free(A2);
+      stats->path = save_path;
+      path_leave(&reject);
+    }
 
     best = solution_choose_best(best1, best2);
   }
@@ -254,6 +411,140 @@ stats_t *stats;
   return best;
 }
 
+/* mincov_join -- the result of a spawned branch, NIL if it was not run */
+static solution_t *mincov_join(task, b, stats, run) task_t *task;
+mincov_branch_t *b;
+stats_t *stats;
+int run;
+{
+  int ran;
+
+  ran = task_join(task, run);
+  path_leave(&b->path);
+  if (!ran) {
+    solution_free(b->select);
+    sm_free(b->A);
+    return NIL(solution_t);
+  }
+  stats->nodes += b->stats.nodes;
+  stats->comp_count += b->stats.comp_count;
+  stats->gimpel_count += b->stats.gimpel_count;
+  stats->max_depth = MAX(stats->max_depth, b->stats.max_depth);
+  return b->best;
+}
+
+/*
+ *  path_enter -- p is the node below up by "branch"
+ *
+ *  When there is an incumbent, the branches to the node are also kept as
+ *  bits (branch i is bit i), so that the order of two nodes can be told
+ *  under the lock of the incumbent without walking or copying paths.
+ */
+static void path_enter(p, up, branch) path_t *p, *up;
+int branch;
+{
+  register int i, n, last;
+
+  p->length = up->length + 1;
+  p->key = NIL(set_word_t);
+  if (up->key != NIL(set_word_t)) {
+    n = p->length / BPI + 1;
+    last = up->length / BPI;
+    p->key = ALLOC(set_word_t, n);
+    for (i = 0; i < n; i++)
+      p->key[i] = i <= last ? up->key[i] : 0;
+    if (branch)
+      p->key[(p->length - 1) / BPI] |= (set_word_t)1 << ((p->length - 1) % BPI);
+  }
+}
+
+static void path_leave(p) path_t *p;
+{
+  FREE(p->key);
+}
+
+/* key_before -- TRUE if path a (of length na) leaves path b on the left */
+static int key_before(a, na, b, nb) register set_word_t *a, *b;
+int na, nb;
+{
+  register int w, i, n;
+  register set_word_t x;
+
+  n = MIN(na, nb);
+  for (w = 0; w * BPI < n; w++) {
+    if ((x = a[w] ^ b[w]) != 0) {
+      for (i = 0; (x & 1) == 0; x >>= 1)
+        i++;
+      return w * BPI + i < n && (a[w] >> i & 1) == 0;
+    }
+  }
+  return FALSE;
+}
+
+/*
+ *  The incumbent only knows covers of the whole problem, so it is not
+ *  used while solving a component on its own.  A node is pruned if its
+ *  lower bound exceeds the incumbent cost, or equals it while the
+ *  incumbent comes first in the serial order (a cover below the node
+ *  would then lose the tie).
+ */
+
+static int incumbent_prunes(stats, lb) stats_t *stats;
+int lb;
+{
+  register incumbent_t *inc = stats->shared;
+  int prune;
+
+  if (inc == NIL(incumbent_t) || stats->component != 0) {
+    return 0;
+  }
+#ifndef NO_THREADS
+  (void)pthread_mutex_lock(&inc->lock);
+#endif
+  prune = inc->cost >= 0 &&
+          (lb > inc->cost ||
+           (lb == inc->cost && key_before(inc->key, inc->length,
+                                          stats->path->key,
+                                          stats->path->length)));
+#ifndef NO_THREADS
+  (void)pthread_mutex_unlock(&inc->lock);
+#endif
+  return prune;
+}
+
+static void incumbent_update(stats, cost) stats_t *stats;
+int cost;
+{
+  register incumbent_t *inc = stats->shared;
+  register path_t *path = stats->path;
+  set_word_t *key, *old;
+  int n;
+
+  if (inc == NIL(incumbent_t) || stats->component != 0) {
+    return;
+  }
+  /* copy the key before taking the lock; keep the one which loses */
+  n = path->length / BPI + 1;
+  key = ALLOC(set_word_t, n);
+  (void)memcpy((char *)key, (char *)path->key, n * sizeof(set_word_t));
+#ifndef NO_THREADS
+  (void)pthread_mutex_lock(&inc->lock);
+#endif
+  if (inc->cost < 0 || cost < inc->cost ||
+      (cost == inc->cost &&
+       !key_before(inc->key, inc->length, path->key, path->length))) {
+    inc->cost = cost;
+    inc->length = path->length;
+    old = inc->key;
+    inc->key = key;
+    key = old;
+  }
+#ifndef NO_THREADS
+  (void)pthread_mutex_unlock(&inc->lock);
+#endif
+  FREE(key);
+}
+
 static int select_column(A, weight, indep) sm_matrix *A;
 int *weight;
 solution_t *indep;
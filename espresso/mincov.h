@@ -1,3 +1,4 @@
 /* exported */
 #include "sparse.h"
 extern sm_row *sm_minimum_cover();
+extern long sm_mincov_time_limit;	/* ms, 0 for no limit */
@@ -18,6 +18,10 @@ struct stats_struct {
     long start_time;		/* cpu time when the covering started */
     int no_branching;
     int lower_bound;
+    long deadline;		/* stop branching at this time (0 for never) */
+    int cancelled;		/* task_cancelled() was TRUE: stop at once */
+    struct path_struct *path;	/* branches taken to reach this node */
+    struct incumbent_struct *shared;	/* best cover of all threads, or 0 */
 };
 
 
@@ -35,6 +39,7 @@ extern solution_t *solution_dup();
 extern void solution_accept();
 extern void solution_reject();
 extern void solution_add();
+extern int task_cancelled();	/* task.c */
 extern solution_t *solution_choose_best();
 
 extern solution_t *sm_maximal_independent_set();
@@ -7,24 +7,47 @@ static pcover primes_consensus_merge();
 
 static pcover and_with_cofactor();
 
+/* one branch of primes_consensus(), possibly run by another thread */
+typedef struct {
+  pcube *T;      /* cube list being split */
+  pcube c;       /* cube to cofactor against */
+  int var;       /* the splitting variable */
+  pcover result; /* primes of the cofactor */
+} primes_branch_t;
+
+static void primes_branch(b) primes_branch_t *b;
+{ b->result = primes_consensus(scofactor(b->T, b->c, b->var)); }
+
 /* primes_consensus -- generate primes using consensus */
 pcover primes_consensus(T) pcube *T; /* T will be disposed of */
 {
   register pcube cl, cr;
   register int best;
   pcover Tnew, Tl, Tr;
+  primes_branch_t right;
+  task_t task;
+
+  PROFILE_IN(CUBELISTSIZE(T));
 
   if (primes_consensus_special_cases(T, &Tnew) == MAYBE) {
-    cl = new_cube();
-    cr = new_cube();
+    cl = new_temp_cube();
+    cr = new_temp_cube();
     best = binate_split_select(T, cl, cr, COMPL);
 
-    Tl = primes_consensus(scofactor(T, cl, best));
-    Tr = primes_consensus(scofactor(T, cr, best));
+    if (task_active(CUBELISTSIZE(T))) {
+      right.T = T, right.c = cr, right.var = best;
+      task_spawn(&task, primes_branch, (char *)&right);
+      Tl = primes_consensus(scofactor(T, cl, best));
+      (void)task_join(&task, TRUE);
+      Tr = right.result;
+    } else {
+      Tl = primes_consensus(scofactor(T, cl, best));
+      Tr = primes_consensus(scofactor(T, cr, best));
+    }
     Tnew = primes_consensus_merge(Tl, Tr, cl, cr);
 
-    free_cube(cl);
-    free_cube(cr);
+    free_temp_cube(cl);
+    free_temp_cube(cr);
     free_cubelist(T);
   }
 
@@ -63,23 +86,23 @@ pcover *Tnew;          /* returned only if answer determined */
   }
 
   /* Check for a column of all 0's which can be factored out */
-  ceil = set_save(cof);
+  ceil = set_copy(new_temp_cube(), cof);
   for (T1 = T + 2; (p = *T1++) != NULL;) {
     INLINEset_or(ceil, ceil, p);
   }
   if (!setp_equal(ceil, cube.fullset)) {
-    p = new_cube();
+    p = new_temp_cube();
     (void)set_diff(p, cube.fullset, ceil);
     (void)set_or(cof, cof, p);
-    free_cube(p);
+    free_temp_cube(p);
 
     A = primes_consensus(T);
     foreach_set(A, last, p) { INLINEset_and(p, p, ceil); }
     *Tnew = A;
-    set_free(ceil);
+    free_temp_cube(ceil);
     return TRUE;
   }
-  set_free(ceil);
+  free_temp_cube(ceil);
 
   /* Collect column counts, determine unate variables, etc. */
   massive_count(T);
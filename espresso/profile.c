@@ -0,0 +1,205 @@
+/*
+    profile.c -- phase profiling (-P)
+
+    Every phase run through EXEC(), EXEC_S(), EXECUTE() or PROFILE() is
+    appended to the profile file as a line of JSON:
+
+        {"event":"phase","file":"ex/rd53","phase":"EXPAND","call":2,
+         "depth":0,"wall_ms":0.412,"cpu_ms":0,"cubes_in":31,
+         "cubes_out":20,"allocs":57,"peak_bytes":10240}
+
+    "call" numbers the calls of the phase, "depth" counts the phases it
+    runs inside of (REDUCE_GASP inside GASP, ...).  "cubes_in" is the
+    size of the cover the phase started from, as reported by the phase
+    itself with PROFILE_IN() (null if it does not), "cubes_out" the size
+    of its result.  "allocs" counts the set family allocations while it
+    ran, and "peak_bytes" is the most set family storage held at once
+    during the phase (both for the thread, and the tasks it joined).
+    At exit a line of "event":"total" for each file and phase sums the
+    calls.
+
+    With NO_PROFILE (configure --disable-profile) the macros do nothing
+    and this file is empty.
+*/
+
+#include "espresso.h"
+
+#ifndef NO_PROFILE
+#include <sys/time.h>
+#ifndef NO_THREADS
+#include <pthread.h>
+
+static pthread_mutex_t profile_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+#define PROFILE_PHASES 256
+
+FILE *profile_file = NULL;
+ESPRESSO_TLS char *profile_input = NULL;
+ESPRESSO_TLS profile_t *profile_top = NULL;
+ESPRESSO_TLS profile_count_t profile_mem;
+
+/* the sums for the totals, by file and phase */
+static struct {
+  char *file;
+  char name[32];
+  long calls;
+  double wall;
+  long cpu;
+  long allocs;
+  long peak;
+} profile_sum[PROFILE_PHASES];
+static int profile_phases = 0;
+
+static double profile_clock() {
+  struct timeval tv;
+
+  (void)gettimeofday(&tv, NULL);
+  return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+/* profile_string -- write s as a JSON string */
+static void profile_string(fp, s) FILE *fp;
+register char *s;
+{
+  putc('"', fp);
+  for (; *s != '\0'; s++) {
+    if (*s == '"' || *s == '\\')
+      putc('\\', fp);
+    if ((unsigned char)*s < ' ')
+      (void)fprintf(fp, "\\u%04x", *s);
+    else
+      putc(*s, fp);
+  }
+  putc('"', fp);
+}
+
+/* profile_name -- the phase name, without the padding of the trace */
+static char *profile_name(name, buf) char *name, *buf;
+{
+  register int n;
+
+  for (n = 0; name[n] != '\0' && n < 31; n++)
+    buf[n] = name[n];
+  while (n > 0 && buf[n - 1] == ' ')
+    n--;
+  buf[n] = '\0';
+  return buf;
+}
+
+static void profile_close() {
+  register int i;
+
+  for (i = 0; i < profile_phases; i++) {
+    (void)fprintf(profile_file, "{\"event\":\"total\",\"file\":");
+    profile_string(profile_file, profile_sum[i].file);
+    (void)fprintf(profile_file, ",\"phase\":");
+    profile_string(profile_file, profile_sum[i].name);
+    (void)fprintf(profile_file,
+                  ",\"calls\":%ld,\"wall_ms\":%.3f,\"cpu_ms\":%ld,"
+                  "\"allocs\":%ld,\"peak_bytes\":%ld}\n",
+                  profile_sum[i].calls, profile_sum[i].wall,
+                  profile_sum[i].cpu, profile_sum[i].allocs,
+                  profile_sum[i].peak);
+  }
+  (void)fclose(profile_file);
+  profile_file = NULL;
+}
+
+/* profile_open -- append the records of this run to the file fname */
+bool profile_open(fname) char *fname;
+{
+  if ((profile_file = fopen(fname, "a")) == NULL)
+    return FALSE;
+  (void)atexit(profile_close);
+  return TRUE;
+}
+
+/* profile_begin -- the phase "name" starts (p is the caller's record) */
+void profile_begin(p, name) profile_t *p;
+char *name;
+{
+  p->name = name;
+  p->wall = profile_clock();
+  p->cpu = ptime();
+  p->cubes_in = -1;
+  p->allocs = profile_mem.allocs;
+  p->peak = profile_mem.peak;
+  p->up = profile_top;
+  profile_top = p;
+  profile_mem.peak = profile_mem.bytes;
+}
+
+/* profile_end -- the phase of p is over with the result S; write it out */
+void profile_end(p, S) profile_t *p;
+pcover S;
+{
+  double wall = profile_clock() - p->wall;
+  long cpu = ptime() - p->cpu;
+  long allocs = profile_mem.allocs - p->allocs;
+  long peak = profile_mem.peak;
+  char buf[32], *name = profile_name(p->name, buf), *file;
+  register profile_t *q;
+  register int i, depth;
+
+  profile_top = p->up;
+  profile_mem.peak = MAX(p->peak, peak);
+  for (depth = 0, q = p->up; q != NULL; q = q->up)
+    depth++;
+  file = profile_input != NULL ? profile_input : filename;
+  if (file == NULL)
+    file = "";
+
+#ifndef NO_THREADS
+  (void)pthread_mutex_lock(&profile_lock);
+#endif
+  for (i = 0; i < profile_phases; i++)
+    if (strcmp(profile_sum[i].name, name) == 0 &&
+        strcmp(profile_sum[i].file, file) == 0)
+      break;
+  if (i == profile_phases && profile_phases < PROFILE_PHASES) {
+    profile_sum[i].file = util_strsav(file);
+    (void)strcpy(profile_sum[profile_phases++].name, name);
+  }
+  if (i < profile_phases) {
+    profile_sum[i].calls++;
+    profile_sum[i].wall += wall;
+    profile_sum[i].cpu += cpu;
+    profile_sum[i].allocs += allocs;
+    profile_sum[i].peak = MAX(profile_sum[i].peak, peak);
+  }
+
+  (void)fprintf(profile_file, "{\"event\":\"phase\",\"file\":");
+  profile_string(profile_file, file);
+  (void)fprintf(profile_file, ",\"phase\":");
+  profile_string(profile_file, name);
+  (void)fprintf(profile_file, ",\"call\":%ld,\"depth\":%d,\"wall_ms\":%.3f,"
+                              "\"cpu_ms\":%ld,",
+                i < profile_phases ? profile_sum[i].calls : 0L, depth, wall,
+                cpu);
+  if (p->cubes_in >= 0)
+    (void)fprintf(profile_file, "\"cubes_in\":%d,", p->cubes_in);
+  else
+    (void)fprintf(profile_file, "\"cubes_in\":null,");
+  if (S != NULL)
+    (void)fprintf(profile_file, "\"cubes_out\":%d,", S->count);
+  else
+    (void)fprintf(profile_file, "\"cubes_out\":null,");
+  (void)fprintf(profile_file, "\"allocs\":%ld,\"peak_bytes\":%ld}\n", allocs,
+                peak);
+#ifndef NO_THREADS
+  (void)pthread_mutex_unlock(&profile_lock);
+#endif
+}
+
+/*
+    profile_merge -- add the storage counted while a task ran on another
+    thread (see task_run()) to this thread
+*/
+void profile_merge(m) profile_count_t *m;
+{
+  profile_mem.allocs += m->allocs;
+  profile_mem.peak = MAX(profile_mem.peak, profile_mem.bytes + m->peak);
+  profile_mem.bytes += m->bytes;
+}
+#endif /* NO_PROFILE */
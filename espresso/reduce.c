@@ -10,7 +10,7 @@
 
 #include "espresso.h"
 
-static bool toggle = TRUE;
+static ESPRESSO_TLS bool toggle = TRUE;
 
 /*
     reduce -- replace each cube in F with its reduction
@@ -49,6 +49,8 @@ IN pcover D;
 {
   register pcube last, p, cunder, *FD;
 
+  PROFILE_IN(F->count);
+
   /* Order the cubes */
   if (use_random_order)
     F = random_order(F);
@@ -93,13 +95,24 @@ pcube reduce_cube(FD, p) IN pcube *FD, p;
   return set_and(cunder, cunder, p);
 }
 
+/*
+    reduce_toggle -- the ordering strategy the next reduce() will use.
+    It alternates from call to call, and so carries over from one
+    minimization to the next; set_reduce_toggle() sets it, e.g., to run
+    the next minimization on another thread as it would run here.
+*/
+bool reduce_toggle() { return toggle; }
+
+void set_reduce_toggle(t) bool t;
+{ toggle = t; }
+
 /* sccc -- find Smallest Cube Containing the Complement of a cover */
 pcube sccc(T) INOUT pcube *T; /* T will be disposed of */
 {
   pcube r;
   register pcube cl, cr;
   register int best;
-  static int sccc_level = 0;
+  static ESPRESSO_TLS int sccc_level = 0;
 
   if (debug & REDUCE1) {
     debug_print(T, "SCCC", sccc_level++);
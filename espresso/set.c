@@ -5,9 +5,82 @@
 
 #include "espresso.h"
 
-static pset_family set_family_garbage = NULL;
+static ESPRESSO_TLS pset_family set_family_garbage = NULL;
 
-static int intcpy(d, s, n) register unsigned int *d, *s;
+/*
+ *  The data of a family of wide sets (see SETV_MIN_WORDS) is laid out so
+ *  that set[1] of every member starts on a SETV_ALIGN boundary: wsize is
+ *  rounded up to a multiple of SETV_ALIGN and the data block begins
+ *  SF_PAD words into an aligned allocation.  Narrow families are stored
+ *  densely as before.
+ */
+#define SF_ALIGN_WORDS (SETV_ALIGN / sizeof(set_word_t))
+#define SF_PAD (SF_ALIGN_WORDS - 1)
+#define SF_WIDE(wsize) ((wsize) > SETV_MIN_WORDS)
+
+/* count the set family storage for -P (see profile.c) */
+#ifndef NO_PROFILE
+#define SF_COUNT_ALLOC(n)                                                      \
+  {                                                                            \
+    profile_mem.allocs++;                                                      \
+    profile_mem.bytes += (n) * sizeof(set_word_t);                             \
+    if (profile_mem.bytes > profile_mem.peak)                                  \
+      profile_mem.peak = profile_mem.bytes;                                    \
+  }
+#define SF_COUNT_FREE(n) (profile_mem.bytes -= (n) * sizeof(set_word_t))
+#else
+#define SF_COUNT_ALLOC(n)
+#define SF_COUNT_FREE(n)
+#endif
+
+static pset sf_data_alloc(wsize, n) int wsize;
+long n;
+{
+  void *block;
+
+  SF_COUNT_ALLOC(n);
+  if (!SF_WIDE(wsize))
+    return ALLOC(set_word_t, n);
+  if (posix_memalign(&block, SETV_ALIGN, (n + SF_PAD) * sizeof(set_word_t)))
+    fatal("out of memory allocating a set family");
+  return (pset)block + SF_PAD;
+}
+
+static void sf_data_free(data, wsize, n) pset data;
+int wsize;
+long n;
+{
+  if (data != NULL)
+    SF_COUNT_FREE(n);
+  if (!SF_WIDE(wsize)) {
+    FREE(data);
+  } else if (data != NULL) {
+    free((char *)(data - SF_PAD));
+  }
+}
+
+static pset sf_data_realloc(data, wsize, oldn, n) pset data;
+int wsize;
+long oldn, n;
+{
+  pset newdata;
+
+  if (!SF_WIDE(wsize)) {
+    if (data != NULL)
+      SF_COUNT_FREE(oldn);
+    SF_COUNT_ALLOC(n);
+    return REALLOC(set_word_t, data, n);
+  }
+  newdata = sf_data_alloc(wsize, n);
+  if (data != NULL) {
+    (void)memcpy((char *)newdata, (char *)data,
+                 (MIN(oldn, n)) * sizeof(set_word_t));
+    sf_data_free(data, wsize, oldn);
+  }
+  return newdata;
+}
+
+static int intcpy(d, s, n) register set_word_t *d, *s;
 register long n;
 {
   register int i;
@@ -17,7 +90,7 @@ register long n;
 }
 
 /* bit_index -- find first bit (from LSB) in a word (MSB=bit n, LSB=bit 0) */
-int bit_index(a) register unsigned int a;
+int bit_index(a) register set_word_t a;
 {
   register int i;
   if (a == 0)
@@ -31,7 +104,7 @@ int bit_index(a) register unsigned int a;
 int set_ord(a) register pset a;
 {
   register int i, sum = 0;
-  register unsigned int val;
+  register set_word_t val;
   for (i = LOOP(a); i > 0; i--)
     if ((val = a[i]) != 0)
       sum += count_ones(val);
@@ -42,7 +115,7 @@ int set_ord(a) register pset a;
 int set_dist(a, b) register pset a, b;
 {
   register int i, sum = 0;
-  register unsigned int val;
+  register set_word_t val;
   for (i = LOOP(a); i > 0; i--)
     if ((val = a[i] & b[i]) != 0)
       sum += count_ones(val);
@@ -54,7 +127,7 @@ pset set_clear(r, size) register pset r;
 int size;
 {
   register int i = LOOPINIT(size);
-  *r = i;
+  *r = SETHEADER(i);
   do
     r[i] = 0;
   while (--i > 0);
@@ -66,11 +139,11 @@ pset set_fill(r, size) register pset r;
 register int size;
 {
   register int i = LOOPINIT(size);
-  *r = i;
-  r[i] = ~(unsigned)0;
+  *r = SETHEADER(i);
+  r[i] = ~(set_word_t)0;
   r[i] >>= i * BPI - size;
   while (--i > 0)
-    r[i] = ~(unsigned)0;
+    r[i] = ~(set_word_t)0;
   return r;
 }
 
@@ -89,6 +162,10 @@ pset set_and(r, a, b) register pset r, a, b;
 {
   register int i = LOOP(a);
   PUTLOOP(r, i);
+  if (i > SETV_MIN_WORDS) {
+    (*setv.v_and)(r + 1, a + 1, b + 1, i);
+    return r;
+  }
   do
     r[i] = a[i] & b[i];
   while (--i > 0);
@@ -100,6 +177,10 @@ pset set_or(r, a, b) register pset r, a, b;
 {
   register int i = LOOP(a);
   PUTLOOP(r, i);
+  if (i > SETV_MIN_WORDS) {
+    (*setv.v_or)(r + 1, a + 1, b + 1, i);
+    return r;
+  }
   do
     r[i] = a[i] | b[i];
   while (--i > 0);
@@ -111,6 +192,10 @@ pset set_diff(r, a, b) register pset r, a, b;
 {
   register int i = LOOP(a);
   PUTLOOP(r, i);
+  if (i > SETV_MIN_WORDS) {
+    (*setv.v_diff)(r + 1, a + 1, b + 1, i);
+    return r;
+  }
   do
     r[i] = a[i] & ~b[i];
   while (--i > 0);
@@ -150,7 +235,7 @@ pset set_merge(r, a, b, mask) register pset r, a, b, mask;
 bool set_andp(r, a, b) register pset r, a, b;
 {
   register int i = LOOP(a);
-  register unsigned int x = 0;
+  register set_word_t x = 0;
   PUTLOOP(r, i);
   do {
     r[i] = a[i] & b[i];
@@ -163,7 +248,7 @@ bool set_andp(r, a, b) register pset r, a, b;
 bool set_orp(r, a, b) register pset r, a, b;
 {
   register int i = LOOP(a);
-  register unsigned int x = 0;
+  register set_word_t x = 0;
   PUTLOOP(r, i);
   do {
     r[i] = a[i] | b[i];
@@ -188,13 +273,13 @@ bool setp_full(a, size) register pset a;
 register int size;
 {
   register int i = LOOP(a);
-  register unsigned int test;
-  test = ~(unsigned)0;
+  register set_word_t test;
+  test = ~(set_word_t)0;
   test >>= i * BPI - size;
   if (a[i] != test)
     return FALSE;
   while (--i > 0)
-    if (a[i] != (~(unsigned)0))
+    if (a[i] != (~(set_word_t)0))
       return FALSE;
   return TRUE;
 }
@@ -214,6 +299,8 @@ bool setp_equal(a, b) register pset a, b;
 bool setp_disjoint(a, b) register pset a, b;
 {
   register int i = LOOP(a);
+  if (i > SETV_MIN_WORDS)
+    return (*setv.v_disjoint)(a + 1, b + 1, i);
   do
     if (a[i] & b[i])
       return FALSE;
@@ -225,6 +312,8 @@ bool setp_disjoint(a, b) register pset a, b;
 bool setp_implies(a, b) register pset a, b;
 {
   register int i = LOOP(a);
+  if (i > SETV_MIN_WORDS)
+    return (*setv.v_implies)(a + 1, b + 1, i);
   do
     if (a[i] & ~b[i])
       return FALSE;
@@ -318,8 +407,9 @@ pset_family sf_append(A, B) pset_family A, B;
 
   if (A->sf_size != B->sf_size)
     fatal("sf_append: sf_size mismatch");
+  A->data = sf_data_realloc(A->data, A->wsize, (long)A->capacity * A->wsize,
+                            (long)(A->count + B->count) * A->wsize);
   A->capacity = A->count + B->count;
-  A->data = REALLOC(unsigned int, A->data, (long)A->capacity * A->wsize);
   intcpy(A->data + asize, B->data, bsize);
   A->count += B->count;
   A->active_count += B->active_count;
@@ -331,6 +421,8 @@ pset_family sf_append(A, B) pset_family A, B;
 pset_family sf_new(num, size) int num, size;
 {
   pset_family A;
+  if (LOOPINIT(size) > LOOPMAX)
+    fatal("set too wide for this build (configure with --enable-set64)");
   if (set_family_garbage == NULL) {
     A = ALLOC(set_family_t, 1);
   } else {
@@ -339,8 +431,10 @@ pset_family sf_new(num, size) int num, size;
   }
   A->sf_size = size;
   A->wsize = SET_SIZE(size);
+  if (SF_WIDE(A->wsize))
+    A->wsize = (A->wsize + SF_ALIGN_WORDS - 1) / SF_ALIGN_WORDS * SF_ALIGN_WORDS;
   A->capacity = num;
-  A->data = ALLOC(unsigned int, (long)A->capacity * A->wsize);
+  A->data = sf_data_alloc(A->wsize, (long)A->capacity * A->wsize);
   A->count = 0;
   A->active_count = 0;
   return A;
@@ -353,7 +447,8 @@ pset_family sf_save(A) register pset_family A;
 /* sf_free -- free the storage allocated for a set family */
 void sf_free(A) pset_family A;
 {
-  FREE(A->data);
+  sf_data_free(A->data, A->wsize, (long)A->capacity * A->wsize);
+  A->data = NULL;
   A->next = set_family_garbage;
   set_family_garbage = A;
 }
@@ -375,14 +470,29 @@ pset s;
   register pset p;
 
   if (A->count >= A->capacity) {
+    A->data = sf_data_realloc(A->data, A->wsize, (long)A->capacity * A->wsize,
+                              (long)(A->capacity + A->capacity / 2 + 1) *
+                                  A->wsize);
     A->capacity = A->capacity + A->capacity / 2 + 1;
-    A->data = REALLOC(unsigned int, A->data, (long)A->capacity * A->wsize);
   }
   p = GETSET(A, A->count++);
   INLINEset_copy(p, s);
   return A;
 }
 
+/* sf_reserve -- make room in A for n more sets, e.g., before a known
+   number of sf_addset() calls */
+pset_family sf_reserve(A, n) pset_family A;
+int n;
+{
+  if (A->count + n > A->capacity) {
+    A->data = sf_data_realloc(A->data, A->wsize, (long)A->capacity * A->wsize,
+                              (long)(A->count + n) * A->wsize);
+    A->capacity = A->count + n;
+  }
+  return A;
+}
+
 /* sf_delset -- delete a set from a set family */
 void sf_delset(A, i) pset_family A;
 int i;
@@ -480,7 +590,7 @@ pset_family sf_bm_read(fp) FILE *fp;
 
 /* ps1 -- convert a set into a printable string */
 #define largest_string 120
-static char s1[largest_string];
+static ESPRESSO_TLS char s1[largest_string];
 char *ps1(a) register pset a;
 {
   register int i, num, l, len = 0, n = NELEM(a);
@@ -532,7 +642,7 @@ void set_adjcnt(a, count, weight) register pset a;
 register int *count, weight;
 {
   register int i, base;
-  register unsigned int val;
+  register set_word_t val;
 
   for (i = LOOP(a); i > 0;) {
     for (val = a[i], base = --i << LOGBPI; val != 0; base++, val >>= 1) {
@@ -548,7 +658,7 @@ int *sf_count(A) pset_family A;
 {
   register pset p, last;
   register int i, base, *count;
-  register unsigned int val;
+  register set_word_t val;
 
   count = ALLOC(int, A->sf_size);
   for (i = A->sf_size - 1; i >= 0; i--) {
@@ -576,7 +686,7 @@ register pset r;
 {
   register pset p;
   register int i, base, *count;
-  register unsigned int val;
+  register set_word_t val;
   int weight;
   pset last;
 
@@ -668,13 +778,13 @@ int dstcol, srccol;
 {
   register pset last, p, pdest;
   register int word_test, word_set;
-  unsigned int bit_set, bit_test;
+  set_word_t bit_set, bit_test;
 
   /* CHEAT! form these constants outside the loop */
   word_test = WHICH_WORD(srccol);
-  bit_test = 1 << WHICH_BIT(srccol);
+  bit_test = BIT(srccol);
   word_set = WHICH_WORD(dstcol);
-  bit_set = 1 << WHICH_BIT(dstcol);
+  bit_set = BIT(dstcol);
 
   pdest = dst->data;
   foreach_set(src, last, p) {
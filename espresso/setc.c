@@ -37,6 +37,9 @@
     cdist01     return distance, or 2 if distance exceeds 1
     consensus   compute consensus of two cubes distance 1 apart
     force_lower expand hack (for now), related to consensus
+
+    For wide cubes the loops over the full words of binary variables in
+    cdist0, cdist and force_lower are done by the vector kernels of setv.c
 */
 
 #include "espresso.h"
@@ -60,7 +63,7 @@ bool cdist0(a, b) register pcube a, b;
 {
   { /* Check binary variables */
     register int w, last;
-    register unsigned int x;
+    register set_word_t x;
     if ((last = cube.inword) != -1) {
 
       /* Check the partial word of binary variables */
@@ -69,11 +72,15 @@ bool cdist0(a, b) register pcube a, b;
         return FALSE; /* disjoint in some variable */
 
       /* Check the full words of binary variables */
-      for (w = 1; w < last; w++) {
-        x = a[w] & b[w];
-        if (~(x | x >> 1) & DISJOINT)
+      if (last > SETV_MIN_WORDS) {
+        if (!(*setv.v_dist0)(a + 1, b + 1, last - 1))
           return FALSE; /* disjoint in some variable */
-      }
+      } else
+        for (w = 1; w < last; w++) {
+          x = a[w] & b[w];
+          if (~(x | x >> 1) & DISJOINT)
+            return FALSE; /* disjoint in some variable */
+        }
     }
   }
 
@@ -105,7 +112,7 @@ int cdist01(a, b) register pset a, b;
 
   { /* Check binary variables */
     register int w, last;
-    register unsigned int x;
+    register set_word_t x;
     if ((last = cube.inword) != -1) {
 
       /* Check the partial word of binary variables */
@@ -152,7 +159,7 @@ int cdist(a, b) register pset a, b;
 
   { /* Check binary variables */
     register int w, last;
-    register unsigned int x;
+    register set_word_t x;
     if ((last = cube.inword) != -1) {
 
       /* Check the partial word of binary variables */
@@ -161,11 +168,14 @@ int cdist(a, b) register pset a, b;
         dist = count_ones(x);
 
       /* Check the full words of binary variables */
-      for (w = 1; w < last; w++) {
-        x = a[w] & b[w];
-        if (x = ~(x | x >> 1) & DISJOINT)
-          dist += count_ones(x);
-      }
+      if (last > SETV_MIN_WORDS)
+        dist += (*setv.v_dist)(a + 1, b + 1, last - 1);
+      else
+        for (w = 1; w < last; w++) {
+          x = a[w] & b[w];
+          if (x = ~(x | x >> 1) & DISJOINT)
+            dist += count_ones(x);
+        }
     }
   }
 
@@ -195,7 +205,7 @@ IN register pset a, b;
 
   { /* Check binary variables (if any) */
     register int w, last;
-    register unsigned int x;
+    register set_word_t x;
     if ((last = cube.inword) != -1) {
 
       /* Check the partial word of binary variables */
@@ -204,11 +214,14 @@ IN register pset a, b;
         xlower[last] |= (x | (x << 1)) & a[last];
 
       /* Check the full words of binary variables */
-      for (w = 1; w < last; w++) {
-        x = a[w] & b[w];
-        if (x = ~(x | x >> 1) & DISJOINT)
-          xlower[w] |= (x | (x << 1)) & a[w];
-      }
+      if (last > SETV_MIN_WORDS)
+        (*setv.v_lower)(xlower + 1, a + 1, b + 1, last - 1);
+      else
+        for (w = 1; w < last; w++) {
+          x = a[w] & b[w];
+          if (x = ~(x | x >> 1) & DISJOINT)
+            xlower[w] |= (x | (x << 1)) & a[w];
+        }
     }
   }
 
@@ -249,7 +262,7 @@ IN register pcube a, b;
 
   { /* Check binary variables (if any) */
     register int w, last;
-    register unsigned int x;
+    register set_word_t x;
     if ((last = cube.inword) != -1) {
 
       /* Check the partial word of binary variables */
@@ -269,7 +282,7 @@ IN register pcube a, b;
   { /* Check the multiple-valued variables */
     bool empty;
     int var;
-    unsigned int x;
+    set_word_t x;
     register int w, last;
     register pcube mask;
     for (var = cube.num_binary_vars; var < cube.num_vars; var++) {
@@ -297,7 +310,7 @@ int cactive(a) register pcube a;
 
   { /* Check binary variables */
     register int w, last;
-    register unsigned int x;
+    register set_word_t x;
     if ((last = cube.inword) != -1) {
 
       /* Check the partial word of binary variables */
@@ -348,7 +361,7 @@ bool ccommon(a, b, cof) register pcube a, b, cof;
   { /* Check binary variables */
     int last;
     register int w;
-    register unsigned int x, y;
+    register set_word_t x, y;
     if ((last = cube.inword) != -1) {
 
       /* Check the partial word of binary variables */
@@ -462,7 +475,7 @@ int d1_order(a, b) pset *a, *b;
 {
   register pset a1 = *a, b1 = *b, c1 = cube.temp[0];
   register int i = LOOP(a1);
-  register unsigned int x1, x2;
+  register set_word_t x1, x2;
   do
     if ((x1 = a1[i] | c1[i]) > (x2 = b1[i] | c1[i]))
       return -1;
@@ -0,0 +1,393 @@
+/*
+    setv.c -- vector kernels for operations on wide sets
+
+    The word-at-a-time loops of set.c, setc.c and the INLINE macros of
+    espresso.h are the best choice for short sets.  When a set has more
+    than SETV_MIN_WORDS words of data they call through the table "setv"
+    instead, which setv_init() fills at startup with the best kernels the
+    processor supports:
+
+        avx512  16 32-bit lanes per step (AVX-512F)
+        avx2     8 32-bit lanes per step (AVX2)
+        c        portable fallback (one set word per step)
+
+    The environment variable ESPRESSO_SIMD (c, avx2 or avx512) restricts
+    the choice, e.g. to compare the kernels against each other.
+
+    All kernels take pointers to the first data word of each set (i.e.,
+    &set[1]) and the number of data words n.  The vector kernels work on
+    32-bit lanes whatever the set word size; the DISJOINT masks keep the
+    shifts in dist0/dist/lower from carrying between lanes.  The "binary" kernels
+    (dist0, dist, lower) apply the DISJOINT trick of setc.c to n full
+    words of binary variables:
+
+        dist0   return TRUE if no variable has a null intersection
+        dist    return the number of variables with a null intersection
+        lower   xlower |= a restricted to the variables with a null
+                intersection
+*/
+
+#include "espresso.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    BPI >= 32 && !defined(NO_SETV_SIMD)
+#define SETV_X86
+#include <immintrin.h>
+/* the vector kernels count in 32-bit lanes; LANES of them make a set word */
+#define LANES (BPI / 32)
+#define TAIL(p) ((pset)((p) + i))
+#endif
+
+/* ---------------- portable kernels ---------------- */
+
+static void c_and(r, a, b, n) register set_word_t *r, *a, *b;
+register int n;
+{
+  register int i;
+  for (i = 0; i < n; i++)
+    r[i] = a[i] & b[i];
+}
+
+static void c_or(r, a, b, n) register set_word_t *r, *a, *b;
+register int n;
+{
+  register int i;
+  for (i = 0; i < n; i++)
+    r[i] = a[i] | b[i];
+}
+
+static void c_diff(r, a, b, n) register set_word_t *r, *a, *b;
+register int n;
+{
+  register int i;
+  for (i = 0; i < n; i++)
+    r[i] = a[i] & ~b[i];
+}
+
+static bool c_implies(a, b, n) register set_word_t *a, *b;
+register int n;
+{
+  register int i;
+  for (i = 0; i < n; i++)
+    if (a[i] & ~b[i])
+      return FALSE;
+  return TRUE;
+}
+
+static bool c_disjoint(a, b, n) register set_word_t *a, *b;
+register int n;
+{
+  register int i;
+  for (i = 0; i < n; i++)
+    if (a[i] & b[i])
+      return FALSE;
+  return TRUE;
+}
+
+static bool c_dist0(a, b, n) register set_word_t *a, *b;
+register int n;
+{
+  register int i;
+  register set_word_t x;
+  for (i = 0; i < n; i++) {
+    x = a[i] & b[i];
+    if (~(x | x >> 1) & DISJOINT)
+      return FALSE;
+  }
+  return TRUE;
+}
+
+static int c_dist(a, b, n) register set_word_t *a, *b;
+register int n;
+{
+  register int i, dist = 0;
+  register set_word_t x;
+  for (i = 0; i < n; i++) {
+    x = a[i] & b[i];
+    if (x = ~(x | x >> 1) & DISJOINT)
+      dist += count_ones(x);
+  }
+  return dist;
+}
+
+static void c_lower(xlower, a, b, n) register set_word_t *xlower, *a, *b;
+register int n;
+{
+  register int i;
+  register set_word_t x;
+  for (i = 0; i < n; i++) {
+    x = a[i] & b[i];
+    if (x = ~(x | x >> 1) & DISJOINT)
+      xlower[i] |= (x | (x << 1)) & a[i];
+  }
+}
+
+#ifdef SETV_X86
+
+/* ---------------- AVX2 kernels (8 lanes per step) ---------------- */
+
+#define AVX2 __attribute__((target("avx2,popcnt")))
+#define LD8(p) _mm256_loadu_si256((__m256i *)(p))
+#define ST8(p, v) _mm256_storeu_si256((__m256i *)(p), v)
+
+/* null intersection selector: ~(x | x >> 1) & DISJOINT */
+#define NULL8(x, d) _mm256_andnot_si256(_mm256_or_si256(x, \
+    _mm256_srli_epi32(x, 1)), d)
+
+AVX2 static void avx2_and(r, a, b, n) unsigned int *r, *a, *b;
+int n;
+{
+  int i;
+  n *= LANES;
+  for (i = 0; i + 8 <= n; i += 8)
+    ST8(r + i, _mm256_and_si256(LD8(a + i), LD8(b + i)));
+  for (; i < n; i++)
+    r[i] = a[i] & b[i];
+}
+
+AVX2 static void avx2_or(r, a, b, n) unsigned int *r, *a, *b;
+int n;
+{
+  int i;
+  n *= LANES;
+  for (i = 0; i + 8 <= n; i += 8)
+    ST8(r + i, _mm256_or_si256(LD8(a + i), LD8(b + i)));
+  for (; i < n; i++)
+    r[i] = a[i] | b[i];
+}
+
+AVX2 static void avx2_diff(r, a, b, n) unsigned int *r, *a, *b;
+int n;
+{
+  int i;
+  n *= LANES;
+  for (i = 0; i + 8 <= n; i += 8)
+    ST8(r + i, _mm256_andnot_si256(LD8(b + i), LD8(a + i)));
+  for (; i < n; i++)
+    r[i] = a[i] & ~b[i];
+}
+
+AVX2 static bool avx2_implies(a, b, n) unsigned int *a, *b;
+int n;
+{
+  int i;
+  n *= LANES;
+  for (i = 0; i + 8 <= n; i += 8)
+    if (!_mm256_testc_si256(LD8(b + i), LD8(a + i)))
+      return FALSE;
+  return c_implies(TAIL(a), TAIL(b), (n - i) / LANES);
+}
+
+AVX2 static bool avx2_disjoint(a, b, n) unsigned int *a, *b;
+int n;
+{
+  int i;
+  n *= LANES;
+  for (i = 0; i + 8 <= n; i += 8)
+    if (!_mm256_testz_si256(LD8(a + i), LD8(b + i)))
+      return FALSE;
+  return c_disjoint(TAIL(a), TAIL(b), (n - i) / LANES);
+}
+
+AVX2 static bool avx2_dist0(a, b, n) unsigned int *a, *b;
+int n;
+{
+  __m256i d = _mm256_set1_epi32(0x55555555), x;
+  int i;
+  n *= LANES;
+  for (i = 0; i + 8 <= n; i += 8) {
+    x = _mm256_and_si256(LD8(a + i), LD8(b + i));
+    if (!_mm256_testz_si256(NULL8(x, d), NULL8(x, d)))
+      return FALSE;
+  }
+  return c_dist0(TAIL(a), TAIL(b), (n - i) / LANES);
+}
+
+AVX2 static int avx2_dist(a, b, n) unsigned int *a, *b;
+int n;
+{
+  __m256i d = _mm256_set1_epi32(0x55555555), x;
+  unsigned long long q[4];
+  int i, dist = 0;
+  n *= LANES;
+  for (i = 0; i + 8 <= n; i += 8) {
+    x = _mm256_and_si256(LD8(a + i), LD8(b + i));
+    x = NULL8(x, d);
+    if (!_mm256_testz_si256(x, x)) {
+      ST8(q, x);
+      dist += __builtin_popcountll(q[0]) + __builtin_popcountll(q[1]) +
+              __builtin_popcountll(q[2]) + __builtin_popcountll(q[3]);
+    }
+  }
+  return dist + c_dist(TAIL(a), TAIL(b), (n - i) / LANES);
+}
+
+AVX2 static void avx2_lower(xlower, a, b, n) unsigned int *xlower, *a, *b;
+int n;
+{
+  __m256i d = _mm256_set1_epi32(0x55555555), va, x;
+  int i;
+  n *= LANES;
+  for (i = 0; i + 8 <= n; i += 8) {
+    va = LD8(a + i);
+    x = NULL8(_mm256_and_si256(va, LD8(b + i)), d);
+    x = _mm256_and_si256(_mm256_or_si256(x, _mm256_slli_epi32(x, 1)), va);
+    ST8(xlower + i, _mm256_or_si256(LD8(xlower + i), x));
+  }
+  c_lower(TAIL(xlower), TAIL(a), TAIL(b), (n - i) / LANES);
+}
+
+/* ---------------- AVX-512 kernels (16 lanes per step) ---------------- */
+
+#define AVX512 __attribute__((target("avx512f,popcnt")))
+#define LD16(p) _mm512_loadu_si512((void *)(p))
+#define ST16(p, v) _mm512_storeu_si512((void *)(p), v)
+#define NULL16(x, d) _mm512_andnot_si512(_mm512_or_si512(x, \
+    _mm512_srli_epi32(x, 1)), d)
+
+AVX512 static void avx512_and(r, a, b, n) unsigned int *r, *a, *b;
+int n;
+{
+  int i;
+  n *= LANES;
+  for (i = 0; i + 16 <= n; i += 16)
+    ST16(r + i, _mm512_and_si512(LD16(a + i), LD16(b + i)));
+  for (; i < n; i++)
+    r[i] = a[i] & b[i];
+}
+
+AVX512 static void avx512_or(r, a, b, n) unsigned int *r, *a, *b;
+int n;
+{
+  int i;
+  n *= LANES;
+  for (i = 0; i + 16 <= n; i += 16)
+    ST16(r + i, _mm512_or_si512(LD16(a + i), LD16(b + i)));
+  for (; i < n; i++)
+    r[i] = a[i] | b[i];
+}
+
+AVX512 static void avx512_diff(r, a, b, n) unsigned int *r, *a, *b;
+int n;
+{
+  int i;
+  n *= LANES;
+  for (i = 0; i + 16 <= n; i += 16)
+    ST16(r + i, _mm512_andnot_si512(LD16(b + i), LD16(a + i)));
+  for (; i < n; i++)
+    r[i] = a[i] & ~b[i];
+}
+
+AVX512 static bool avx512_implies(a, b, n) unsigned int *a, *b;
+int n;
+{
+  int i;
+  n *= LANES;
+  for (i = 0; i + 16 <= n; i += 16)
+    if (_mm512_test_epi32_mask(_mm512_andnot_si512(LD16(b + i), LD16(a + i)),
+                               _mm512_set1_epi32(-1)))
+      return FALSE;
+  return c_implies(TAIL(a), TAIL(b), (n - i) / LANES);
+}
+
+AVX512 static bool avx512_disjoint(a, b, n) unsigned int *a, *b;
+int n;
+{
+  int i;
+  n *= LANES;
+  for (i = 0; i + 16 <= n; i += 16)
+    if (_mm512_test_epi32_mask(LD16(a + i), LD16(b + i)))
+      return FALSE;
+  return c_disjoint(TAIL(a), TAIL(b), (n - i) / LANES);
+}
+
+AVX512 static bool avx512_dist0(a, b, n) unsigned int *a, *b;
+int n;
+{
+  __m512i d = _mm512_set1_epi32(0x55555555), x;
+  int i;
+  n *= LANES;
+  for (i = 0; i + 16 <= n; i += 16) {
+    x = _mm512_and_si512(LD16(a + i), LD16(b + i));
+    x = NULL16(x, d);
+    if (_mm512_test_epi32_mask(x, x))
+      return FALSE;
+  }
+  return c_dist0(TAIL(a), TAIL(b), (n - i) / LANES);
+}
+
+AVX512 static int avx512_dist(a, b, n) unsigned int *a, *b;
+int n;
+{
+  __m512i d = _mm512_set1_epi32(0x55555555), x;
+  unsigned long long q[8];
+  int i, j, dist = 0;
+  n *= LANES;
+  for (i = 0; i + 16 <= n; i += 16) {
+    x = _mm512_and_si512(LD16(a + i), LD16(b + i));
+    x = NULL16(x, d);
+    if (_mm512_test_epi32_mask(x, x)) {
+      ST16(q, x);
+      for (j = 0; j < 8; j++)
+        dist += __builtin_popcountll(q[j]);
+    }
+  }
+  return dist + c_dist(TAIL(a), TAIL(b), (n - i) / LANES);
+}
+
+AVX512 static void avx512_lower(xlower, a, b, n) unsigned int *xlower, *a, *b;
+int n;
+{
+  __m512i d = _mm512_set1_epi32(0x55555555), va, x;
+  int i;
+  n *= LANES;
+  for (i = 0; i + 16 <= n; i += 16) {
+    va = LD16(a + i);
+    x = NULL16(_mm512_and_si512(va, LD16(b + i)), d);
+    x = _mm512_and_si512(_mm512_or_si512(x, _mm512_slli_epi32(x, 1)), va);
+    ST16(xlower + i, _mm512_or_si512(LD16(xlower + i), x));
+  }
+  c_lower(TAIL(xlower), TAIL(a), TAIL(b), (n - i) / LANES);
+}
+
+#endif /* SETV_X86 */
+
+/* the kernels in use; valid (portable) even before setv_init() is called */
+setv_t setv = {"c",        c_and,   c_or,    c_diff, c_implies,
+               c_disjoint, c_dist0, c_dist, c_lower};
+
+static setv_t setv_c = {"c",        c_and,   c_or,    c_diff, c_implies,
+                        c_disjoint, c_dist0, c_dist, c_lower};
+
+#ifdef SETV_X86
+static setv_t setv_avx2 = {"avx2",        avx2_and,   avx2_or,
+                           avx2_diff,     avx2_implies, avx2_disjoint,
+                           avx2_dist0,    avx2_dist,  avx2_lower};
+
+static setv_t setv_avx512 = {"avx512",      avx512_and,   avx512_or,
+                             avx512_diff,   avx512_implies, avx512_disjoint,
+                             avx512_dist0,  avx512_dist,  avx512_lower};
+#endif
+
+/*
+    setv_init -- select the kernels for this processor (call once at
+    startup, before any thread is started)
+*/
+void setv_init() {
+  char *want = getenv("ESPRESSO_SIMD");
+
+  setv = setv_c;
+#ifdef SETV_X86
+  __builtin_cpu_init();
+  if (want != NULL && strcmp(want, "c") == 0)
+    return;
+  if (__builtin_cpu_supports("avx512f") &&
+      (want == NULL || strcmp(want, "avx512") == 0)) {
+    setv = setv_avx512;
+  } else if (__builtin_cpu_supports("avx2") &&
+             (want == NULL || strcmp(want, "avx2") == 0 ||
+              strcmp(want, "avx512") == 0)) {
+    setv = setv_avx2;
+  }
+#endif
+}
@@ -55,6 +55,8 @@ pcover mv_reduce(F, D) pcover F, D;
   pcover F1, D1;
   pcube *F_cube_table;
 
+  PROFILE_IN(F->count);
+
   /* loop for each multiple-valued variable */
   for (var = 0; var < cube.num_vars; var++) {
 
@@ -103,7 +103,7 @@ struct sm_matrix_struct {
 extern sm_matrix *sm_alloc(), *sm_alloc_size(), *sm_dup();
 extern void sm_free(), sm_delrow(), sm_delcol(), sm_resize();
 extern void sm_write(), sm_print(), sm_dump(), sm_cleanup();
-extern void sm_copy_row(), sm_copy_col();
+extern void sm_copy_row(), sm_copy_col(), sm_insert_sorted();
 extern void sm_remove(), sm_remove_element();
 extern sm_element *sm_insert(), *sm_find();
 extern sm_row *sm_longest_row();
@@ -0,0 +1,343 @@
+/*
+    task.c -- fork/join parallelism for the minimizer
+
+    complement(), tautology() and primes_consensus() split a cube list
+    into two cofactors which are solved independently.  When espresso
+    runs with more than one thread (-j), the second branch of a large
+    enough split (at least task_cutoff cubes) is offered to a pool of
+    worker threads with task_spawn(), the first branch is solved by the
+    caller, and task_join() waits for (or, when nobody took it, runs) the
+    second one.  Results are always combined in the serial order, so the
+    output is the same for any number of threads.  expand() uses the
+    same pool to expand several cubes at once (see expand_parallel()).
+    Independent problems with a minimizer context of their own (-Dmany)
+    are started with task_start().  Work whose result is no longer
+    wanted can be told to stop early with task_cancel().
+
+    A thread waiting in task_join() does not sleep while there is queued
+    work for the same minimizer: it steals and runs that work instead.
+    Below the cutoff, and whenever no worker is idle, branches are run
+    serially by the caller.
+
+    Every thread needs its own cube.temp scratch cubes and cdata arrays.
+    A worker adopts the cube structure of the thread which spawned the
+    task (the masks and other read-only fields are shared) and keeps
+    private copies of the scratch parts.  A task runs under the budget
+    (see budget_t) of the thread which spawned it.
+*/
+
+#include "espresso.h"
+
+#ifndef NO_THREADS
+#include <pthread.h>
+#include <sys/time.h>
+
+static pthread_mutex_t task_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t task_work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t task_done = PTHREAD_COND_INITIALIZER;
+static task_t *task_queue = NULL; /* tasks nobody has started */
+static int task_idle = 0;         /* workers waiting for work */
+static int task_queued = 0;       /* length of task_queue */
+static int task_workers = 0;      /* workers started */
+static long task_cpu0;            /* processor time at task_init() */
+static struct timeval task_epoch; /* ... and the time of day */
+
+/* the task this thread is running, NULL outside of tasks */
+static ESPRESSO_TLS task_t *task_current = NULL;
+
+/* scratch parts of the cube structure owned by a worker */
+static ESPRESSO_TLS pcube *task_temp = NULL;
+static ESPRESSO_TLS int task_size = -1, task_vars = -1;
+
+/* task_adopt -- take over the cube structure of the spawning thread */
+static void task_adopt(parent) struct cube_struct *parent;
+{
+  register int i;
+
+  if (parent->size != task_size || parent->num_vars != task_vars) {
+    if (task_temp != NULL) {
+      for (i = 0; i < CUBE_TEMP; i++)
+        set_free(task_temp[i]);
+      FREE(task_temp);
+      FREE(cdata.part_zeros);
+      FREE(cdata.var_zeros);
+      FREE(cdata.parts_active);
+      FREE(cdata.is_unate);
+    }
+    task_size = parent->size;
+    task_vars = parent->num_vars;
+    task_temp = ALLOC(pcube, CUBE_TEMP);
+    for (i = 0; i < CUBE_TEMP; i++)
+      task_temp[i] = set_new(task_size);
+    cdata.part_zeros = ALLOC(int, task_size);
+    cdata.var_zeros = ALLOC(int, task_vars);
+    cdata.parts_active = ALLOC(int, task_vars);
+    cdata.is_unate = ALLOC(bool, task_vars);
+  }
+  cube = *parent; /* structure copy ! */
+  cube.temp = task_temp;
+}
+
+/* task_unqueue -- remove t from the queue (lock held); FALSE if not there */
+static bool task_unqueue(t) task_t *t;
+{
+  register task_t **tp;
+
+  for (tp = &task_queue; *tp != NULL; tp = &(*tp)->next)
+    if (*tp == t) {
+      *tp = t->next;
+      task_queued--;
+      return TRUE;
+    }
+  return FALSE;
+}
+
+/* task_run -- run a task taken from the queue (lock held on entry/exit) */
+static void task_run(t) task_t *t;
+{
+  task_t *save = task_current;
+  budget_t *save_budget = budget;
+#ifndef NO_PROFILE
+  profile_count_t save_mem;
+#endif
+
+  t->state = TASK_RUNNING;
+  (void)pthread_mutex_unlock(&task_lock);
+  task_current = t;
+  budget = t->budget;
+#ifndef NO_PROFILE
+  /* count its storage apart, for the thread which joins it */
+  save_mem = profile_mem;
+  profile_mem.allocs = profile_mem.bytes = profile_mem.peak = 0;
+#endif
+  (*t->fn)(t->arg);
+#ifndef NO_PROFILE
+  t->mem = profile_mem;
+  profile_mem = save_mem;
+#endif
+  budget = save_budget;
+  task_current = save;
+  (void)pthread_mutex_lock(&task_lock);
+  t->state = TASK_DONE;
+  (void)pthread_cond_broadcast(&task_done);
+}
+
+static void *task_worker(arg) void *arg;
+{
+  register task_t *t;
+
+  (void)pthread_mutex_lock(&task_lock);
+  for (;;) {
+    while (task_queue == NULL) {
+      task_idle++;
+      (void)pthread_cond_wait(&task_work, &task_lock);
+      task_idle--;
+    }
+    t = task_queue;
+    task_queue = t->next;
+    task_queued--;
+    if (t->parent != NULL)
+      task_adopt(t->parent);
+    task_run(t);
+  }
+  /* NOTREACHED */
+  return NULL;
+}
+#endif /* NO_THREADS */
+
+/*
+    task_init -- start the worker threads for "n" threads in total
+    (call once, before the first minimization)
+*/
+void task_init(n) int n;
+{
+#ifndef NO_THREADS
+  pthread_t thread;
+  pthread_attr_t attr;
+
+  task_cpu0 = util_cpu_time();
+  (void)gettimeofday(&task_epoch, (struct timezone *)NULL);
+  (void)pthread_attr_init(&attr);
+  (void)pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  (void)pthread_attr_setstacksize(&attr, (size_t)64 * 1024 * 1024);
+  for (; task_workers < n - 1; task_workers++)
+    if (pthread_create(&thread, &attr, task_worker, NULL) != 0)
+      break;
+  (void)pthread_attr_destroy(&attr);
+#endif
+}
+
+/*
+    task_time -- the clock behind ptime(): the processor time used, or,
+    once worker threads run (whose processor times add up), the time
+    elapsed since task_init() on top of the processor time used before
+*/
+long task_time()
+{
+#ifndef NO_THREADS
+  struct timeval now;
+
+  if (task_workers > 0) {
+    (void)gettimeofday(&now, (struct timezone *)NULL);
+    return task_cpu0 + (now.tv_sec - task_epoch.tv_sec) * 1000 +
+           (now.tv_usec - task_epoch.tv_usec) / 1000;
+  }
+#endif
+  return util_cpu_time();
+}
+
+/*
+    task_independent -- TRUE if independent minimizations (the outputs of
+    -Dso, the PLAs of -Dmany) may run side by side; not when their trace
+    (-s, -t, -d) or the random number sequence (-erandom) must follow the
+    serial order
+*/
+bool task_independent()
+{
+  return task_threads > 1 && debug == 0 && !summary && !trace &&
+         !use_random_order;
+}
+
+/* task_active -- TRUE if a cube list of n cubes is worth splitting off */
+bool task_active(n) int n;
+{
+#ifndef NO_THREADS
+  return task_workers > 0 && n >= task_cutoff && debug == 0;
+#else
+  return FALSE;
+#endif
+}
+
+/* task_offer -- queue t for an idle worker, if there is one */
+static void task_offer(t, fn, arg, parent) task_t *t;
+void (*fn)();
+char *arg;
+struct cube_struct *parent;
+{
+  t->fn = fn;
+  t->arg = arg;
+  t->parent = parent;
+  t->state = TASK_DEFERRED;
+  t->offered = FALSE;
+  t->cancelled = FALSE;
+  t->up = task_current;
+  t->budget = budget;
+#ifndef NO_THREADS
+  (void)pthread_mutex_lock(&task_lock);
+  if (task_idle > task_queued) {
+    t->state = TASK_QUEUED;
+    t->offered = TRUE;
+    t->next = task_queue;
+    task_queue = t;
+    task_queued++;
+    (void)pthread_cond_signal(&task_work);
+  }
+  (void)pthread_mutex_unlock(&task_lock);
+#endif
+}
+
+/*
+    task_spawn -- offer fn(arg) to an idle worker; if there is none the
+    task is left for task_join() to run in the calling thread
+*/
+void task_spawn(t, fn, arg) task_t *t;
+void (*fn)();
+char *arg;
+{ task_offer(t, fn, arg, &cube); }
+
+/*
+    task_start -- as task_spawn(), for work which brings its own minimizer
+    context (see activate_ctx()) rather than running on the cube structure
+    of the calling thread
+*/
+void task_start(t, fn, arg) task_t *t;
+void (*fn)();
+char *arg;
+{ task_offer(t, fn, arg, (struct cube_struct *)NULL); }
+
+/*
+    task_join -- wait for a spawned task; if "run" is FALSE a task which
+    has not been started yet is dropped instead of being run.  Returns
+    TRUE if the task was run.
+*/
+bool task_join(t, run) task_t *t;
+bool run;
+{
+  register task_t *s;
+#ifndef NO_THREADS
+  int state;
+
+  if (t->offered) {
+    (void)pthread_mutex_lock(&task_lock);
+    if (t->state == TASK_QUEUED && task_unqueue(t))
+      t->state = TASK_DEFERRED;
+    while (t->state == TASK_RUNNING) {
+      /* help with queued work of the same minimizer while waiting */
+      for (s = task_queue; s != NULL; s = s->next)
+        if (s->parent == NULL || s->parent->fullset == cube.fullset)
+          break;
+      if (s != NULL) {
+        (void)task_unqueue(s);
+        task_run(s);
+      } else {
+        (void)pthread_cond_wait(&task_done, &task_lock);
+      }
+    }
+    state = t->state;
+    (void)pthread_mutex_unlock(&task_lock);
+    if (state == TASK_DONE) {
+#ifndef NO_PROFILE
+      profile_merge(&t->mem);
+#endif
+      return TRUE;
+    }
+  }
+#endif
+  if (!run)
+    return FALSE;
+  s = task_current;
+  task_current = t;
+  (*t->fn)(t->arg);
+  task_current = s;
+  t->state = TASK_DONE;
+  return TRUE;
+}
+
+/*
+    task_cancel -- ask a spawned task (and the tasks it spawns) to finish
+    as soon as it can; its result is of no use then, but stays a valid
+    cover.  Follow with task_join(t, FALSE).
+*/
+void task_cancel(t) task_t *t;
+{
+#ifndef NO_THREADS
+  (void)pthread_mutex_lock(&task_lock);
+#endif
+  t->cancelled = TRUE;
+#ifndef NO_THREADS
+  (void)pthread_mutex_unlock(&task_lock);
+#endif
+}
+
+/*
+    task_cancelled -- TRUE if the work of this thread has been cancelled;
+    polled where the minimizer could spend a long time (sm_mincov(), the
+    main loop of espresso())
+*/
+bool task_cancelled()
+{
+  register task_t *t;
+  bool cancelled = FALSE;
+
+  if (task_current != NULL) {
+#ifndef NO_THREADS
+    (void)pthread_mutex_lock(&task_lock);
+#endif
+    for (t = task_current; t != NULL && !cancelled; t = t->up)
+      cancelled = t->cancelled;
+#ifndef NO_THREADS
+    (void)pthread_mutex_unlock(&task_lock);
+#endif
+  }
+  return cancelled;
+}
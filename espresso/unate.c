@@ -12,7 +12,8 @@ static int abs_select_restricted();
 pcover map_cover_to_unate(T)
 pcube *T;
 {
-    register unsigned int word_test, word_set, bit_test, bit_set;
+    register unsigned int word_test, word_set;
+    register set_word_t bit_test, bit_set;
     register pcube p, pA;
     pset_family A;
     pcube *T1;
@@ -31,9 +32,9 @@ pcube *T;
 
 	    /* Copy a column from T to A */
 	    word_test = WHICH_WORD(i);
-	    bit_test = 1 << WHICH_BIT(i);
+	    bit_test = BIT(i);
 	    word_set = WHICH_WORD(ncol);
-	    bit_set = 1 << WHICH_BIT(ncol);
+	    bit_set = BIT(ncol);
 
 	    pA = A->data;
 	    for(T1 = T+2; (p = *T1++) != 0; ) {
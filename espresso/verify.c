@@ -4,15 +4,200 @@
 
 #include "espresso.h"
 
+/*
+ *  Before the proof, verify() simulates the covers on a few thousand
+ *  minterms, 64 at a time: the minterms are the bit positions of a word
+ *  per part of the input variables, which has the bits of the minterms
+ *  taking that value.  A cube is then an AND over its variables of the
+ *  OR of the words of its parts.  Half of the minterms are chosen at
+ *  random in the whole space, the other half in random cubes of the two
+ *  covers (so they land where the functions are), and the first two are
+ *  the corners with every variable at its first and at its last value.
+ *  A minterm of one cover but not of the other (nor of the DC-set) is a
+ *  counterexample, found without complementing anything.
+ */
+typedef unsigned long long sim_word_t;
+
+#define SIM_WORDS 64       /* 4096 minterms */
+#define SIM_WORK (1L << 27) /* most part lookups of the simulation */
+
+static sim_word_t sim_random(state) sim_word_t *state;
+{
+  /* xorshift64*, with a fixed seed so that verify is repeatable */
+  *state ^= *state >> 12;
+  *state ^= *state << 25;
+  *state ^= *state >> 27;
+  return *state * 2685821657736338717ULL;
+}
+
+/* sim_minterms -- choose the 64 minterms of word number n */
+static void sim_minterms(W, F, Fold, n, state) sim_word_t *W;
+pcover F, Fold;
+int n;
+sim_word_t *state;
+{
+  register int b, i, var, k, parts;
+  sim_word_t bit;
+  pcube c;
+
+  for (i = 0; i < cube.size; i++)
+    W[i] = 0;
+  for (b = 0; b < 64; b++) {
+    bit = (sim_word_t)1 << b;
+    c = NULL;
+    if ((b & 1) == 0 && F->count + Fold->count > 0) {
+      k = sim_random(state) % (F->count + Fold->count);
+      c = k < F->count ? GETSET(F, k) : GETSET(Fold, k - F->count);
+    }
+    for (var = 0; var < cube.num_vars; var++) {
+      if (var == cube.output)
+        continue;
+      if (n == 0 && b < 2) {
+        i = b == 0 ? cube.first_part[var] : cube.last_part[var];
+      } else if (c == NULL) {
+        i = cube.first_part[var] +
+            sim_random(state) % cube.part_size[var];
+      } else {
+        /* one of the parts of the cube in this variable */
+        for (parts = 0, i = cube.first_part[var]; i <= cube.last_part[var];
+             i++)
+          if (is_in_set(c, i))
+            parts++;
+        k = parts > 0 ? sim_random(state) % parts : 0;
+        for (i = cube.first_part[var]; i < cube.last_part[var]; i++)
+          if (is_in_set(c, i) && k-- == 0)
+            break;
+      }
+      W[i] |= bit;
+    }
+  }
+}
+
+/* sim_eval -- OR into acc (by output) the minterms of W which T contains */
+static void sim_eval(T, W, acc) pcover T;
+sim_word_t *W, *acc;
+{
+  register int var, i;
+  register sim_word_t e, v;
+  pcube p, last;
+
+  foreach_set(T, last, p) {
+    e = ~(sim_word_t)0;
+    for (var = 0; var < cube.num_binary_vars && e != 0; var++) {
+      switch (GETINPUT(p, var)) {
+      case ZERO:
+        e &= W[2 * var];
+        break;
+      case ONE:
+        e &= W[2 * var + 1];
+        break;
+      case TWO:
+        break;
+      default:
+        e = 0;
+      }
+    }
+    for (; var < cube.num_vars && e != 0; var++) {
+      if (var == cube.output)
+        continue;
+      v = 0;
+      for (i = cube.first_part[var]; i <= cube.last_part[var]; i++)
+        if (is_in_set(p, i))
+          v |= W[i];
+      e &= v;
+    }
+    if (e == 0)
+      continue;
+    if (cube.output == -1)
+      acc[0] |= e;
+    else
+      for (i = cube.first_part[cube.output]; i <= cube.last_part[cube.output];
+           i++)
+        if (is_in_set(p, i))
+          acc[i - cube.first_part[cube.output]] |= e;
+  }
+}
+
+/*
+ *  sim_verify -- look for a minterm of F not in Fold u Dold, or of Fold
+ *  not in F u Dold, by simulation; TRUE (after reporting it) if found
+ */
+static bool sim_verify(F, Fold, Dold) pcover F, Fold, Dold;
+{
+  sim_word_t *W, *acc, diff, state;
+  int n, words, nout, o, b, var, i;
+  long work;
+  bool found = FALSE;
+  pcube p;
+
+  work = (long)(F->count + Fold->count + (Dold ? Dold->count : 0) + 64) *
+         cube.num_vars;
+  for (words = SIM_WORDS; words > 1 && words * work > SIM_WORK; words /= 2)
+    ;
+  nout = cube.output == -1 ? 1 : cube.part_size[cube.output];
+  W = ALLOC(sim_word_t, cube.size);
+  acc = ALLOC(sim_word_t, 3 * nout);
+  state = 0x9e3779b97f4a7c15ULL;
+
+  for (n = 0; n < words && !found; n++) {
+    sim_minterms(W, F, Fold, n, &state);
+    for (o = 0; o < 3 * nout; o++)
+      acc[o] = 0;
+    sim_eval(F, W, acc);
+    sim_eval(Fold, W, acc + nout);
+    if (Dold != NULL)
+      sim_eval(Dold, W, acc + 2 * nout);
+
+    for (o = 0; o < nout; o++)
+      if ((diff = (acc[o] ^ acc[nout + o]) & ~acc[2 * nout + o]) != 0)
+        break;
+    if (o == nout)
+      continue;
+
+    /* report the first minterm which differs */
+    for (b = 0; (diff & ((sim_word_t)1 << b)) == 0; b++)
+      ;
+    if (acc[o] & ((sim_word_t)1 << b))
+      printf("some minterm in F is not covered by Fold u Dold\n");
+    else
+      printf("some minterm in Fold is not covered by F u Dold\n");
+    p = new_cube();
+    (void)set_clear(p, cube.size);
+    for (var = 0; var < cube.num_vars; var++)
+      if (var != cube.output)
+        for (i = cube.first_part[var]; i <= cube.last_part[var]; i++)
+          if (W[i] & ((sim_word_t)1 << b))
+            set_insert(p, i);
+    if (cube.output != -1)
+      set_insert(p, cube.first_part[cube.output] + o);
+    printf("%s\n", pc1(p));
+    free_cube(p);
+    found = TRUE;
+  }
+
+  FREE(W);
+  FREE(acc);
+  return found;
+}
+
 /*
  *  verify -- check that all minterms of F are contained in (Fold u Dold)
  *  and that all minterms of Fold are contained in (F u Dold).
+ *
+ *  A difference found by simulation ends the check, unless all of the
+ *  cubes in error are wanted (verbose_debug).
  */
 bool verify(F, Fold, Dold) pcover F, Fold, Dold;
 {
   pcube p, last, *FD;
   bool verify_error = FALSE;
 
+  if (sim_verify(F, Fold, Dold)) {
+    if (!verbose_debug)
+      return TRUE;
+    verify_error = TRUE;
+  }
+
   /* Make sure the function didn't grow too large */
   FD = cube2list(Fold, Dold);
   foreach_set(F, last, p) if (!cube_is_covered(FD, p)) {
@@ -0,0 +1,492 @@
+/*
+    zdd.c -- implicit prime implicants
+
+    primes_consensus() lists the prime implicants of a function as a
+    cover, which is out of reach for functions with millions of primes.
+    Here the function is turned into a binary decision diagram (BDD) and
+    its primes are computed as a zero-suppressed decision diagram (ZDD)
+    by the recursion of Coudert and Madre:
+
+        Primes(f) = Pd + x'.(Primes(f0) - Pd) + x.(Primes(f1) - Pd)
+
+    where f0 and f1 are the cofactors of f by its top variable x, and
+    Pd = Primes(f0.f1).  A prime is read as the set of its literals: the
+    ZDD has a variable for x' and for x of every input, and one for "not
+    in output j" of every output.  The multiple-output prime (c, S) is
+    the prime c.PROD(j not in S) y'_j of the single-output function
+    PROD(j) (y'_j + f_j), with the y_j ordered after the inputs.
+
+    The primes can be counted (zdd_count()) and listed one at a time
+    (zdd_foreach()) without ever building the cover; zdd_cover() builds
+    it.  Only binary-valued inputs are handled (besides the output part).
+
+    BDD and ZDD nodes share one table: a node is a (var, lo, hi) triple,
+    read as a BDD or as a ZDD by the function which uses it.  Nodes are
+    never freed before zdd_free().  The size of a BDD depends heavily on
+    the order of the inputs, and no reordering is done: when the table
+    reaches ZDD_MAX_NODES nodes, or the operations take ZDD_MAX_STEPS
+    recursive steps, the computation is abandoned, and the caller falls
+    back to primes_consensus().
+*/
+
+#include "espresso.h"
+
+#define ZDD_LEAF 0x7fffffff   /* var of the two terminals */
+#define ZDD_MAX_NODES (1 << 23) /* about 300 MB with the tables */
+#define ZDD_MAX_STEPS (1L << 25)
+
+#define OP_AND 1
+#define OP_OR 2
+#define OP_DIFF 3
+
+typedef struct {
+  int var;
+  int lo, hi;
+  int next; /* hash chain, 0 at the end */
+} zdd_node_t;
+
+typedef struct {
+  int op, a, b, r;
+} zdd_entry_t;
+
+struct zdd_struct {
+  zdd_node_t *node; /* 0 is false (the empty family), 1 is true ({{}}) */
+  int count, max;
+  int *bucket; /* unique table, mask + 1 chains */
+  zdd_entry_t *cache; /* lossy operation cache, mask + 1 entries */
+  int mask;
+  int *prime; /* Primes() of each BDD node, -1 if not known */
+  int inputs, outputs;
+  long steps;    /* cache misses of bdd_apply() and zdd_diff() */
+  bool overflow; /* a limit was reached, all results are junk */
+};
+
+#define HASH(a, b, c)                                                          \
+  ((unsigned)(a)*12582917u + (unsigned)(b)*4256249u + (unsigned)(c)*741457u)
+
+static void zdd_grow(z) register zdd_t *z;
+{
+  register int i, h;
+
+  if (z->count == z->max) {
+    z->max *= 2;
+    z->node = REALLOC(zdd_node_t, z->node, z->max);
+    z->prime = REALLOC(int, z->prime, z->max);
+    for (i = z->count; i < z->max; i++)
+      z->prime[i] = -1;
+  }
+  if (z->count > z->mask) {
+    FREE(z->bucket);
+    FREE(z->cache);
+    z->mask = 2 * z->mask + 1;
+    z->bucket = ALLOC(int, z->mask + 1);
+    z->cache = ALLOC(zdd_entry_t, z->mask + 1);
+    (void)memset((char *)z->bucket, 0, (z->mask + 1) * sizeof(int));
+    (void)memset((char *)z->cache, 0, (z->mask + 1) * sizeof(zdd_entry_t));
+    for (i = 2; i < z->count; i++) {
+      h = HASH(z->node[i].var, z->node[i].lo, z->node[i].hi) & z->mask;
+      z->node[i].next = z->bucket[h];
+      z->bucket[h] = i;
+    }
+  }
+}
+
+/* zdd_mk -- the unique node (var, lo, hi) */
+static int zdd_mk(z, var, lo, hi) register zdd_t *z;
+int var, lo, hi;
+{
+  register int i, h;
+  register zdd_node_t *n;
+
+  h = HASH(var, lo, hi) & z->mask;
+  for (i = z->bucket[h]; i != 0; i = n->next) {
+    n = z->node + i;
+    if (n->var == var && n->lo == lo && n->hi == hi)
+      return i;
+  }
+  if (z->count >= ZDD_MAX_NODES) {
+    z->overflow = TRUE;
+    return 0;
+  }
+  zdd_grow(z);
+  h = HASH(var, lo, hi) & z->mask;
+  i = z->count++;
+  n = z->node + i;
+  n->var = var;
+  n->lo = lo;
+  n->hi = hi;
+  n->next = z->bucket[h];
+  z->bucket[h] = i;
+  return i;
+}
+
+/* a BDD node is redundant if both branches agree ... */
+#define bdd_node(z, var, lo, hi) ((lo) == (hi) ? (lo) : zdd_mk(z, var, lo, hi))
+
+/* ... a ZDD node if no set contains its variable */
+#define zdd_node(z, var, lo, hi) ((hi) == 0 ? (lo) : zdd_mk(z, var, lo, hi))
+
+static int cache_find(z, op, a, b) register zdd_t *z;
+int op, a, b;
+{
+  register zdd_entry_t *e = z->cache + (HASH(op, a, b) & z->mask);
+
+  return e->op == op && e->a == a && e->b == b ? e->r : -1;
+}
+
+static void cache_save(z, op, a, b, r) register zdd_t *z;
+int op, a, b, r;
+{
+  register zdd_entry_t *e = z->cache + (HASH(op, a, b) & z->mask);
+
+  e->op = op, e->a = a, e->b = b, e->r = r;
+}
+
+/* bdd_apply -- f AND g (op OP_AND) or f OR g (op OP_OR) */
+static int bdd_apply(z, op, f, g) register zdd_t *z;
+int op, f, g;
+{
+  int t, r, v, f0, f1, g0, g1, lo, hi;
+
+  if (z->overflow)
+    return 0;
+  if (op == OP_AND) {
+    if (f == 0 || g == 0)
+      return 0;
+    if (f == 1)
+      return g;
+    if (g == 1 || f == g)
+      return f;
+  } else {
+    if (f == 1 || g == 1)
+      return 1;
+    if (f == 0)
+      return g;
+    if (g == 0 || f == g)
+      return f;
+  }
+  if (f > g)
+    t = f, f = g, g = t;
+  if ((r = cache_find(z, op, f, g)) >= 0)
+    return r;
+  if (++z->steps > ZDD_MAX_STEPS) {
+    z->overflow = TRUE;
+    return 0;
+  }
+
+  v = MIN(z->node[f].var, z->node[g].var);
+  if (z->node[f].var == v)
+    f0 = z->node[f].lo, f1 = z->node[f].hi;
+  else
+    f0 = f1 = f;
+  if (z->node[g].var == v)
+    g0 = z->node[g].lo, g1 = z->node[g].hi;
+  else
+    g0 = g1 = g;
+  lo = bdd_apply(z, op, f0, g0);
+  hi = bdd_apply(z, op, f1, g1);
+  r = bdd_node(z, v, lo, hi);
+  cache_save(z, op, f, g, r);
+  return r;
+}
+
+/* zdd_diff -- the sets of P which are not in Q */
+static int zdd_diff(z, P, Q) register zdd_t *z;
+int P, Q;
+{
+  int r, vp, vq, hi;
+
+  if (z->overflow)
+    return 0;
+  if (P == 0 || P == Q)
+    return 0;
+  if (Q == 0)
+    return P;
+  if ((r = cache_find(z, OP_DIFF, P, Q)) >= 0)
+    return r;
+  if (++z->steps > ZDD_MAX_STEPS) {
+    z->overflow = TRUE;
+    return 0;
+  }
+
+  vp = z->node[P].var;
+  vq = z->node[Q].var;
+  if (vp < vq) {
+    r = zdd_diff(z, z->node[P].lo, Q);
+    hi = z->node[P].hi;
+    r = zdd_node(z, vp, r, hi);
+  } else if (vp > vq) {
+    r = zdd_diff(z, P, z->node[Q].lo);
+  } else {
+    r = zdd_diff(z, z->node[P].lo, z->node[Q].lo);
+    hi = zdd_diff(z, z->node[P].hi, z->node[Q].hi);
+    r = zdd_node(z, vp, r, hi);
+  }
+  cache_save(z, OP_DIFF, P, Q, r);
+  return r;
+}
+
+/* zdd_prime -- the primes of the BDD f, as a ZDD */
+static int zdd_prime(z, f) register zdd_t *z;
+int f;
+{
+  int v, f0, f1, Pd, P0, P1, r;
+
+  if (f <= 1)
+    return f; /* no primes, or the universe */
+  if (z->overflow)
+    return 0;
+  if (z->prime[f] >= 0)
+    return z->prime[f];
+
+  v = z->node[f].var;
+  f0 = z->node[f].lo;
+  f1 = z->node[f].hi;
+  Pd = zdd_prime(z, bdd_apply(z, OP_AND, f0, f1));
+  P0 = zdd_diff(z, zdd_prime(z, f0), Pd);
+  P1 = zdd_diff(z, zdd_prime(z, f1), Pd);
+  if (v < z->inputs) {
+    r = zdd_node(z, 2 * v + 1, Pd, P1);
+    r = zdd_node(z, 2 * v, r, P0);
+  } else {
+    /* y_j only occurs negated: f1 <= f0, so P1 is empty */
+    r = zdd_node(z, z->inputs + v, Pd, P0);
+  }
+  z->prime[f] = r;
+  return r;
+}
+
+/* bdd_cube -- the BDD of the input part of a cube */
+static int bdd_cube(z, p) register zdd_t *z;
+register pcube p;
+{
+  register int v, r;
+  bool b0, b1;
+
+  r = 1;
+  for (v = z->inputs - 1; v >= 0; v--) {
+    b0 = is_in_set(p, 2 * v) != 0;
+    b1 = is_in_set(p, 2 * v + 1) != 0;
+    if (!b0 && !b1)
+      return 0;
+    if (!b1)
+      r = bdd_node(z, v, r, 0);
+    else if (!b0)
+      r = bdd_node(z, v, 0, r);
+  }
+  return r;
+}
+
+/* bdd_or_list -- the OR of the BDDs f[0..n), pairwise (f is destroyed) */
+static int bdd_or_list(z, f, n) zdd_t *z;
+int *f, n;
+{
+  register int i;
+
+  if (n == 0)
+    return 0;
+  while (n > 1) {
+    for (i = 0; i + 1 < n; i += 2)
+      f[i / 2] = bdd_apply(z, OP_OR, f[i], f[i + 1]);
+    if (n % 2 != 0)
+      f[n / 2] = f[n - 1];
+    n = (n + 1) / 2;
+  }
+  return f[0];
+}
+
+/* zdd_new -- an empty manager */
+zdd_t *zdd_new() {
+  register zdd_t *z;
+
+  z = ALLOC(zdd_t, 1);
+  z->max = 1024;
+  z->node = ALLOC(zdd_node_t, z->max);
+  z->prime = ALLOC(int, z->max);
+  (void)memset((char *)z->prime, -1, z->max * sizeof(int));
+  z->mask = 1023;
+  z->bucket = ALLOC(int, z->mask + 1);
+  z->cache = ALLOC(zdd_entry_t, z->mask + 1);
+  (void)memset((char *)z->bucket, 0, (z->mask + 1) * sizeof(int));
+  (void)memset((char *)z->cache, 0, (z->mask + 1) * sizeof(zdd_entry_t));
+  z->node[0].var = z->node[1].var = ZDD_LEAF;
+  z->node[0].lo = z->node[0].hi = 0;
+  z->node[1].lo = z->node[1].hi = 1;
+  z->count = 2;
+  z->inputs = z->outputs = 0;
+  z->steps = 0;
+  z->overflow = FALSE;
+  return z;
+}
+
+void zdd_free(z) zdd_t *z;
+{
+  FREE(z->node);
+  FREE(z->prime);
+  FREE(z->bucket);
+  FREE(z->cache);
+  FREE(z);
+}
+
+/*
+    zdd_primes -- the primes of F + D as a ZDD of z; -1 if the cube
+    structure has a multiple-valued input variable, or if the diagrams
+    grow too large
+*/
+int zdd_primes(z, F, D) zdd_t *z;
+pcover F, D;
+{
+  register pcube p, last;
+  register int i, j, n;
+  int *f, *g, out, H, S;
+  pcover T[2];
+  int k;
+
+  if (cube.num_binary_vars != cube.num_vars - (cube.output != -1))
+    return -1;
+  z->inputs = cube.num_binary_vars;
+  z->outputs = cube.output == -1 ? 0 : cube.part_size[cube.output];
+
+  /* the input part of every cube */
+  n = F->count + D->count;
+  f = ALLOC(int, n + 1);
+  g = ALLOC(int, n + 1);
+  T[0] = F, T[1] = D;
+  n = 0;
+  for (k = 0; k < 2; k++)
+    foreach_set(T[k], last, p) { f[n++] = bdd_cube(z, p); }
+
+  /* H = PROD(j) (y'_j + f_j), or the function itself without outputs */
+  if (z->outputs == 0) {
+    for (j = 0; j < n; j++)
+      g[j] = f[j];
+    H = bdd_or_list(z, g, n);
+  } else {
+    H = 1;
+    out = cube.first_part[cube.output];
+    for (j = z->outputs - 1; j >= 0; j--) {
+      n = i = 0;
+      for (k = 0; k < 2; k++)
+        foreach_set(T[k], last, p) {
+          if (is_in_set(p, out + j))
+            g[n++] = f[i];
+          i++;
+        }
+      H = bdd_apply(z, OP_AND, H,
+                    bdd_apply(z, OP_OR, bdd_node(z, z->inputs + j, 1, 0),
+                              bdd_or_list(z, g, n)));
+    }
+  }
+  FREE(f);
+  FREE(g);
+
+  /* drop the prime which is in no output */
+  S = 1;
+  for (j = z->outputs - 1; j >= 0; j--)
+    S = zdd_node(z, 2 * z->inputs + j, 0, S);
+  H = zdd_diff(z, zdd_prime(z, H), z->outputs > 0 ? S : 0);
+  return z->overflow ? -1 : H;
+}
+
+static double zdd_count_rec(z, P, memo) register zdd_t *z;
+int P;
+double *memo;
+{
+  if (P <= 1)
+    return (double)P;
+  if (memo[P] < 0)
+    memo[P] = zdd_count_rec(z, z->node[P].lo, memo) +
+              zdd_count_rec(z, z->node[P].hi, memo);
+  return memo[P];
+}
+
+/* zdd_count -- the number of sets (primes) in P */
+double zdd_count(z, P) zdd_t *z;
+int P;
+{
+  register int i;
+  double *memo, count;
+
+  memo = ALLOC(double, z->count);
+  for (i = 0; i < z->count; i++)
+    memo[i] = -1.0;
+  count = zdd_count_rec(z, P, memo);
+  FREE(memo);
+  return count;
+}
+
+static void zdd_walk(z, P, p, fn, arg) register zdd_t *z;
+int P;
+pcube p;
+void (*fn)();
+char *arg;
+{
+  int var, hi, part;
+
+  if (P == 0)
+    return;
+  if (P == 1) {
+    (*fn)(p, arg);
+    return;
+  }
+  var = z->node[P].var;
+  hi = z->node[P].hi;
+  zdd_walk(z, z->node[P].lo, p, fn, arg);
+
+  /* the literal x'_v (var 2v) removes the part of x_v = 1, and so on */
+  if (var < 2 * z->inputs)
+    part = var ^ 1;
+  else
+    part = cube.first_part[cube.output] + var - 2 * z->inputs;
+  set_remove(p, part);
+  zdd_walk(z, hi, p, fn, arg);
+  set_insert(p, part);
+}
+
+/*
+    zdd_foreach -- call fn(c, arg) for each prime c of P, given as a
+    scratch cube which fn must not keep
+*/
+void zdd_foreach(z, P, fn, arg) zdd_t *z;
+int P;
+void (*fn)();
+char *arg;
+{
+  pcube p = new_cube();
+
+  (void)set_copy(p, cube.fullset);
+  SET(p, PRIME);
+  zdd_walk(z, P, p, fn, arg);
+  free_cube(p);
+}
+
+static void zdd_add(p, F) pcube p;
+pcover *F;
+{ *F = sf_addset(*F, p); }
+
+/* zdd_cover -- the primes of P as a cover */
+pcover zdd_cover(z, P) zdd_t *z;
+int P;
+{
+  pcover F;
+
+  F = new_cover((int)MIN(zdd_count(z, P), 1e6) + 1);
+  zdd_foreach(z, P, zdd_add, (char *)&F);
+  return F;
+}
+
+/*
+    zdd_prime_cover -- the primes of F + D as a cover, built from the ZDD;
+    NULL if they cannot be computed that way (see zdd_primes())
+*/
+pcover zdd_prime_cover(F, D) pcover F, D;
+{
+  zdd_t *z = zdd_new();
+  pcover P = NULL;
+  int root;
+
+  if ((root = zdd_primes(z, F, D)) >= 0)
+    P = zdd_cover(z, root);
+  zdd_free(z);
+  return P;
+}
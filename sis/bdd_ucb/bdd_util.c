@@ -520,14 +520,14 @@ bdd_manager *manager;
         + (manager->heap.cache.consttable.nentries * sizeof(bdd_constcache_entry));
 
     /*
-     * Memory used by the adhoc table: table + buckets + entries.
+     * Memory used by the adhoc table: table + slots + keys.
      */
     if (manager->heap.cache.adhoc.table == NIL(st_table)) {
         stats->memory.adhoc_cache = 0;
     } else {
         stats->memory.adhoc_cache = (sizeof(st_table) 
-            + (manager->heap.cache.adhoc.table->num_bins * sizeof(st_table_entry *))
-            + (st_count(manager->heap.cache.adhoc.table) * (sizeof(st_table_entry) + sizeof(bdd_adhoccache_key))) );
+            + (manager->heap.cache.adhoc.table->num_bins * (sizeof(st_table_entry) + 1))
+            + (st_count(manager->heap.cache.adhoc.table) * sizeof(bdd_adhoccache_key)) );
     }
 
     /*
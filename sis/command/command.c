@@ -54,8 +54,9 @@ int com_execute(network, command)
 static int com_dispatch(network, argc, argv)
 	network_t **network;int argc;char **argv; {
 	int status;
-	char *value;
+	char *value, *undo;
 	command_descr_t *descr;
+	network_t *replaced;
 
 	if (argc == 0) { /* empty command */
 		return 0;
@@ -70,17 +71,31 @@ static int com_dispatch(network, argc, argv)
 	if (setjmp(env)) {
 		/* return from control-c -- restore the network */
 		if (descr->changes_network) {
-			*network = backup_network;
-			backup_network = NIL(network_t);
+			if (network_journal_undo(network, &replaced)) {
+				network_journal_end();
+			} else if (backup_network != NIL(network_t)) {
+				*network = backup_network;
+				backup_network = NIL(network_t);
+			}
 		}
 		return 1;
 	}
 
 	if (descr->changes_network) {
+		/* "set undo off" saves nothing; "set undo copy" copies the network */
+		undo = com_get_flag("undo");
+		network_journal_end();
 		if (backup_network != NIL(network_t)) {
 			network_free(backup_network);
+			backup_network = NIL(network_t);
+		}
+		if (undo == NIL(char)
+				|| (strcmp(undo, "off") != 0 && strcmp(undo, "0") != 0)) {
+			if ((undo != NIL(char) && strcmp(undo, "copy") == 0)
+					|| !network_journal_begin(*network)) {
+				backup_network = network_dup(*network);
+			}
 		}
-		backup_network = network_dup(*network);
 	}
 
 	(void) signal(SIGINT, sigterm);
@@ -301,6 +301,7 @@ end_command (void)
     avl_free_table(flag_table, free, free);
     avl_free_table(command_table, (void (*)()) 0, com_command_free);
     avl_free_table(alias_table, (void (*)()) 0, com_alias_free);
+    network_journal_end();
     if (backup_network != NIL(network_t)) {
 	network_free(backup_network);
     }
@@ -9,13 +9,25 @@ network_t **network;
 int argc;
 char **argv;
 {
-    network_t *temp;
+    network_t *temp, *replaced;
 
     if (argc != 1) {
 	(void) fprintf(miserr, "usage: undo\n");
 	return 1;
     }
 
+    /* the journal of the last command, if there is one */
+    if (network_journal_undo(network, &replaced)) {
+	if (replaced != NIL(network_t)) {
+	    /* the command made a new network; keep it for the next undo */
+	    if (backup_network != NIL(network_t)) {
+		network_free(backup_network);
+	    }
+	    backup_network = replaced;
+	}
+	return 0;
+    }
+
     if (backup_network == NIL(network_t)) {
 	(void) fprintf(miserr, "undo: no network currently saved\n");
 	return 1;
@@ -42,7 +42,7 @@ pcube *T;			/* T will be disposed of */
     register int best;
     pcover Tbar, Tl, Tr;
     int lifting;
-    static int compl_level = 0;
+    static ESPRESSO_TLS int compl_level = 0;
 
     if (debug & COMPL)
 	debug_print(T, "COMPLEMENT", compl_level++);
@@ -420,7 +420,7 @@ pcover *Tbar;
     register int best;
     pcover Tl, Tr, Tlbar, Trbar;
     int lifting;
-    static int simplify_level = 0;
+    static ESPRESSO_TLS int simplify_level = 0;
 
     if (debug & COMPL)
 	debug_print(T, "SIMPCOMP", simplify_level++);
@@ -559,7 +559,7 @@ pcube *T;			/* T will be disposed of */
     register int best;
     pcover Tbar, Tl, Tr;
     int lifting;
-    static int simplify_level = 0;
+    static ESPRESSO_TLS int simplify_level = 0;
 
     if (debug & COMPL) {
 	debug_print(T, "SIMPLIFY", simplify_level++);
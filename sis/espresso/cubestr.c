@@ -1,6 +1,7 @@
 
 /*
-    Module: cubestr.c -- routines for managing the global cube structure
+    Module: cubestr.c -- routines for managing the cube structure and the
+    minimizer contexts which carry it
 */
 
 #include "espresso.h"
@@ -142,3 +143,93 @@ void restore_cube_struct()
     cube = temp_cube_save;              /* structure copy ! */
     cdata = temp_cdata_save;            /*      ""          */
 }
+
+
+/*
+    new_ctx -- allocate an empty minimizer context
+
+    The cube structure of the new context is not set up; activate the
+    context, fill in num_vars, num_binary_vars and part_size as for
+    cube_setup(), call cube_setup() and deactivate it again.
+*/
+pctx new_ctx()
+{
+    register pctx ctx;
+
+    ctx = ALLOC(espresso_ctx_t, 1);
+    (void) memset((char *) ctx, 0, sizeof(espresso_ctx_t));
+    ctx->active = FALSE;
+    return ctx;
+}
+
+
+/*
+    free_ctx -- release a minimizer context, including its cube structure
+    and the part_size array
+*/
+void free_ctx(ctx)
+pctx ctx;
+{
+    if (ctx->active)
+	fatal("free_ctx: context is still active");
+    if (ctx->cube.fullset != NULL) {
+	activate_ctx(ctx);
+	setdown_cube();
+	deactivate_ctx(ctx);
+    }
+    if (ctx->cube.part_size != NULL)
+	FREE(ctx->cube.part_size);
+    FREE(ctx);
+}
+
+
+/*
+    activate_ctx -- make ctx the current minimizer state of this thread
+
+    The state which was current is saved in the context and restored by
+    the matching deactivate_ctx().
+*/
+void activate_ctx(ctx)
+pctx ctx;
+{
+    register int i;
+
+    if (ctx->active)
+	fatal("activate_ctx: context is already active");
+    ctx->save_cube = cube;		/* structure copy ! */
+    ctx->save_cdata = cdata;		/*      ""          */
+    cube = ctx->cube;
+    cdata = ctx->cdata;
+    for(i = 0; i < TIME_COUNT; i++) {
+	ctx->save_time[i] = total_time[i];
+	ctx->save_calls[i] = total_calls[i];
+	total_time[i] = ctx->total_time[i];
+	total_calls[i] = ctx->total_calls[i];
+    }
+    ctx->active = TRUE;
+}
+
+
+/*
+    deactivate_ctx -- store the current minimizer state back into ctx and
+    restore the state which was current before activate_ctx(ctx)
+*/
+void deactivate_ctx(ctx)
+pctx ctx;
+{
+    register int i;
+
+    if (! ctx->active)
+	fatal("deactivate_ctx: context is not active");
+    ctx->cube = cube;			/* structure copy ! */
+    ctx->cdata = cdata;			/*      ""          */
+    cube = ctx->save_cube;
+    cdata = ctx->save_cdata;
+    for(i = 0; i < TIME_COUNT; i++) {
+	ctx->total_time[i] = total_time[i];
+	ctx->total_calls[i] = total_calls[i];
+	total_time[i] = ctx->save_time[i];
+	total_calls[i] = ctx->save_calls[i];
+    }
+    ctx->active = FALSE;
+}
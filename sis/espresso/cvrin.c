@@ -6,9 +6,9 @@
 
 #include "sis.h"
 
-static bool line_length_error;
+static ESPRESSO_TLS bool line_length_error;
 static bool last_was_newline;
-static int lineno;
+static ESPRESSO_TLS int lineno;
 
 static int io_getc (fp)
 FILE *fp;
@@ -458,6 +458,132 @@ fatal("num_binary_vars (second field of .mv) cannot be negative");
 	    read_cube(fp, PLA);
     }
     goto loop;
+}
+
+/* bin_read -- read n bytes of a binary PLA, or give up */
+static void bin_read(fp, p, n)
+FILE *fp;
+char *p;
+long n;
+{
+    if (n > 0 && fread(p, 1, (size_t) n, fp) != (size_t) n)
+	fatal("binary PLA is truncated");
+}
+
+/* bin_skip_pad -- skip the padding after n bytes of a binary PLA */
+static void bin_skip_pad(fp, n)
+FILE *fp;
+long n;
+{
+    char pad[8];
+
+    bin_read(fp, pad, (8 - n % 8) % 8);
+}
+
+/*
+ *  read_pla_binary -- read a PLA in the binary cover format written by
+ *  fpr_binary(); returns FALSE, having read nothing, if the next byte of
+ *  fp does not start one
+ *
+ *  The cube structure is set up from the header (or, when it already is,
+ *  must have the same shape), and each cover is read with one fread()
+ *  straight into its sets.
+ */
+static bool read_pla_binary(fp, PLA)
+FILE *fp;
+pPLA PLA;
+{
+    pla_binary_t h;
+    pcover T[3];
+    register pcube p, last;
+    int ch, i, var, len, *part_size;
+    long label_bytes;
+    char msg[80];
+
+    if ((ch = getc(fp)) == EOF)
+	return FALSE;
+    (void) ungetc(ch, fp);
+    if (ch != (PLA_BINARY_MAGIC[0] & 0xff))
+	return FALSE;
+
+    bin_read(fp, (char *) &h, (long) sizeof(h));
+    if (memcmp(h.magic, PLA_BINARY_MAGIC, sizeof(h.magic)) != 0)
+	fatal("not a binary PLA (bad magic number)");
+    if (h.byte_order != PLA_BINARY_ORDER)
+	fatal("binary PLA was written on a machine of another byte order");
+    if (h.version != PLA_BINARY_VERSION || h.word_bits != BPI) {
+	(void) sprintf(msg,
+	    "binary PLA has version %d and %d-bit sets, need %d and %d-bit sets",
+	    h.version, h.word_bits, PLA_BINARY_VERSION, BPI);
+	fatal(msg);
+    }
+    if (h.covers == 0 || (h.covers & ~FDR_type) != 0 || h.num_vars <= 0 ||
+	    h.num_binary_vars < 0 || h.num_binary_vars > h.num_vars ||
+	    h.count[0] < 0 || h.count[1] < 0 || h.count[2] < 0)
+	fatal("binary PLA has a bad header");
+
+    part_size = ALLOC(int, h.num_vars);
+    bin_read(fp, (char *) part_size, (long) h.num_vars * sizeof(int));
+    bin_skip_pad(fp, (long) h.num_vars * sizeof(int));
+    for(var = 0; var < h.num_vars; var++)
+	if (part_size[var] < (var < h.num_binary_vars ? 2 : 1))
+	    fatal("binary PLA has a bad variable size");
+    if (cube.fullset == NULL) {
+	if (cube.part_size != NULL)
+	    FREE(cube.part_size);
+	cube.num_vars = h.num_vars;
+	cube.num_binary_vars = h.num_binary_vars;
+	cube.part_size = part_size;
+	cube_setup();
+    } else {
+	if (cube.num_vars != h.num_vars ||
+		cube.num_binary_vars != h.num_binary_vars)
+	    fatal("binary PLA does not match the size of the previous PLA");
+	for(var = 0; var < h.num_vars; var++)
+	    if (ABS(cube.part_size[var]) != part_size[var])
+		fatal("binary PLA does not match the size of the previous PLA");
+	FREE(part_size);
+    }
+    if (h.wsize != SET_SIZE(cube.size))
+	fatal("binary PLA has a bad set size");
+
+    PLA_labels(PLA);
+    label_bytes = 0;
+    for(i = 0; i < cube.size; i++) {
+	bin_read(fp, (char *) &len, (long) sizeof(int));
+	label_bytes += sizeof(int);
+	if (len >= 0) {
+	    if (len > h.label_bytes)
+		fatal("binary PLA has a bad label");
+	    PLA->label[i] = ALLOC(char, len + 1);
+	    bin_read(fp, PLA->label[i], (long) len);
+	    PLA->label[i][len] = '\0';
+	    label_bytes += len;
+	}
+    }
+    if (label_bytes != h.label_bytes)
+	fatal("binary PLA has a bad label table");
+    bin_skip_pad(fp, label_bytes);
+
+    for(i = 0; i < 3; i++) {
+	T[i] = new_cover(MAX(h.count[i], 1));
+	if ((h.covers & (i == 0 ? F_type : i == 1 ? D_type : R_type)) == 0)
+	    continue;
+	T[i]->count = h.count[i];
+	bin_read(fp, (char *) T[i]->data,
+	    (long) h.count[i] * h.wsize * sizeof(unsigned int));
+	/* the flags were those of the writer; start afresh */
+	foreach_set(T[i], last, p) {
+	    if (LOOP(p) != LOOPINIT(cube.size))
+		fatal("binary PLA has a bad set");
+	    p[0] = LOOP(p);
+	}
+    }
+    PLA->F = T[0];
+    PLA->D = T[1];
+    PLA->R = T[2];
+    PLA->pla_type = h.covers & FDR_type;
+    return TRUE;
 }
 /*
     read_pla -- read a PLA from a file
@@ -513,7 +639,8 @@ OUT pPLA *PLA_return;
 
     /* Read the pla */
     time = ptime();
-    parse_pla(fp, PLA);
+    if (! read_pla_binary(fp, PLA))
+	parse_pla(fp, PLA);
 
     /* Check for nothing on the file -- implies reached EOF */
     if (PLA->F == NULL) {
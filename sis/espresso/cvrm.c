@@ -390,8 +390,8 @@ int (*func1)();
     }
 }
 
-static pcover Fmin;
-static pcube phase;
+static ESPRESSO_TLS pcover Fmin;
+static ESPRESSO_TLS pcube phase;
 
 /*
  *  minimize each output function individually
@@ -48,7 +48,7 @@ INOUT pcost cost;
 char *fmt_cost(cost)
 IN pcost cost;
 {
-    static char s[200];
+    static ESPRESSO_TLS char s[200];
 
     if (cube.num_binary_vars == cube.num_vars - 1)
 	(void) sprintf(s, "c=%d(%d) in=%d out=%d tot=%d",
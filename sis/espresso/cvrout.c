@@ -14,6 +14,11 @@ IN int output_type;
     int num;
     register pcube last, p;
 
+    if ((output_type & BINARY_type) != 0) {
+	fpr_binary(fp, PLA, output_type & FDR_type);
+	return;
+    }
+
     if ((output_type & CONSTRAINTS_type) != 0) {
 	output_symbolic_constraints(fp, PLA, 0);
 	output_type &= ~ CONSTRAINTS_type;
@@ -72,6 +77,72 @@ IN int output_type;
     }
 }
 
+/* fpr_pad -- write zero bytes up to the next multiple of 8 of n */
+static void fpr_pad(fp, n)
+FILE *fp;
+long n;
+{
+    for(; n % 8 != 0; n++)
+	putc('\0', fp);
+}
+
+/*
+ *  fpr_binary -- write the covers of output_type (F_type, D_type, R_type)
+ *  in the binary cover format (see pla_binary_t in espresso.h)
+ */
+void fpr_binary(fp, PLA, output_type)
+FILE *fp;
+pPLA PLA;
+int output_type;
+{
+    pla_binary_t h;
+    pcover T[3];
+    int i, len, *part_size;
+
+    T[0] = (output_type & F_type) ? PLA->F : NULL;
+    T[1] = (output_type & D_type) ? PLA->D : NULL;
+    T[2] = (output_type & R_type) ? PLA->R : NULL;
+
+    (void) memset((char *) &h, 0, sizeof(h));
+    (void) memcpy(h.magic, PLA_BINARY_MAGIC, sizeof(h.magic));
+    h.version = PLA_BINARY_VERSION;
+    h.byte_order = PLA_BINARY_ORDER;
+    h.word_bits = BPI;
+    h.covers = output_type & FDR_type;
+    h.num_vars = cube.num_vars;
+    h.num_binary_vars = cube.num_binary_vars;
+    h.wsize = SET_SIZE(cube.size);
+    for(i = 0; i < 3; i++)
+	h.count[i] = T[i] != NULL ? T[i]->count : 0;
+    if (PLA->label != NULL)
+	for(i = 0; i < cube.size; i++)
+	    if (PLA->label[i] != NULL)
+		h.label_bytes += strlen(PLA->label[i]);
+    h.label_bytes += cube.size * sizeof(int);
+
+    (void) fwrite((char *) &h, sizeof(h), 1, fp);
+    part_size = ALLOC(int, cube.num_vars);
+    for(i = 0; i < cube.num_vars; i++)
+	part_size[i] = ABS(cube.part_size[i]);
+    (void) fwrite((char *) part_size, sizeof(int), cube.num_vars, fp);
+    fpr_pad(fp, (long) cube.num_vars * sizeof(int));
+    FREE(part_size);
+
+    for(i = 0; i < cube.size; i++) {
+	len = PLA->label != NULL && PLA->label[i] != NULL ?
+	    strlen(PLA->label[i]) : -1;
+	(void) fwrite((char *) &len, sizeof(int), 1, fp);
+	if (len > 0)
+	    (void) fwrite(PLA->label[i], 1, len, fp);
+    }
+    fpr_pad(fp, (long) h.label_bytes);
+
+    for(i = 0; i < 3; i++)
+	if (h.count[i] > 0)
+	    (void) fwrite((char *) T[i]->data, sizeof(unsigned int),
+		(size_t) h.count[i] * h.wsize, fp);
+}
+
 void fpr_header(fp, PLA, output_type)
 FILE *fp;
 pPLA PLA;
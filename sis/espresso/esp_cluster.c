@@ -0,0 +1,326 @@
+/*
+    module: esp_cluster.c
+    purpose: minimize a wide multi-output function by output clusters
+
+    The outputs are grouped into clusters of at most "size" outputs which
+    share the most inputs, and every cluster is minimized as a function
+    of its own, over only the inputs its outputs depend on (in a context
+    of its own, see new_ctx()).  The covers of the clusters are put back
+    together, with the terms found by more than one cluster merged into
+    one multi-output term, and made irredundant as a whole.  The offset
+    of the whole function is never computed.
+*/
+
+#include "espresso.h"
+
+typedef struct {
+    int nout, *out;		/* the outputs of the cluster */
+    int nvar, *var;		/* the inputs they depend on */
+    int size, *part;		/* the part of the function for each part */
+    pcube rest;			/* the other parts of a cube of the function */
+    pcover result;		/* the minimized cover, in the cluster's ctx */
+    pctx ctx;			/* the cube structure of the cluster */
+} cluster_t;
+
+static pcube cluster_mask;	/* see cluster_compare() */
+
+
+/* output_support -- the inputs each output of F u D depends on */
+static pset *
+output_support(F, D)
+pcover F, D;
+{
+    register pcube p, last;
+    register int var, i;
+    pcover T;
+    pset *support, vars;
+    int pass;
+
+    support = ALLOC(pset, cube.part_size[cube.output]);
+    for(i = 0; i < cube.part_size[cube.output]; i++)
+	support[i] = set_new(cube.num_vars);
+    vars = set_new(cube.num_vars);
+    for(pass = 0; pass < 2; pass++) {
+	T = pass == 0 ? F : D;
+	foreach_set(T, last, p) {
+	    (void) set_clear(vars, cube.num_vars);
+	    for(var = 0; var < cube.output; var++)
+		if (! setp_implies(cube.var_mask[var], p))
+		    set_insert(vars, var);
+	    for(i = 0; i < cube.part_size[cube.output]; i++)
+		if (is_in_set(p, cube.first_part[cube.output] + i))
+		    (void) set_or(support[i], support[i], vars);
+	}
+    }
+    set_free(vars);
+    return support;
+}
+
+
+/*
+    make_clusters -- group the outputs, "size" at a time; each cluster
+    starts with the free output which depends on the most inputs, and
+    takes the outputs which add the fewest new inputs for the most inputs
+    shared with it
+*/
+static cluster_t *
+make_clusters(support, size, nclusters)
+pset *support;
+int size, *nclusters;
+{
+    cluster_t *clusters, *c;
+    pset vars, taken;
+    int n, i, best, score, best_score, shared;
+
+    n = cube.part_size[cube.output];
+    clusters = ALLOC(cluster_t, (n + size - 1) / size);
+    taken = set_new(n);
+    vars = set_new(cube.num_vars);
+    *nclusters = 0;
+    for(;;) {
+	best = -1;
+	for(i = 0; i < n; i++)
+	    if (! is_in_set(taken, i) &&
+		(best < 0 || set_ord(support[i]) > set_ord(support[best])))
+		best = i;
+	if (best < 0)
+	    break;
+
+	c = clusters + (*nclusters)++;
+	c->out = ALLOC(int, size);
+	c->nout = 0;
+	(void) set_copy(vars, support[best]);
+	do {
+	    set_insert(taken, best);
+	    c->out[c->nout++] = best;
+	    (void) set_or(vars, vars, support[best]);
+	    best = -1;
+	    best_score = 0;
+	    for(i = 0; i < n && c->nout < size; i++) {
+		if (is_in_set(taken, i))
+		    continue;
+		shared = set_dist(vars, support[i]);
+		score = 2 * shared - set_ord(support[i]);  /* shared - new */
+		if (best < 0 || score > best_score) {
+		    best = i;
+		    best_score = score;
+		}
+	    }
+	} while (best >= 0);
+
+	/* the inputs in the order of the function: binary ones first */
+	c->var = ALLOC(int, cube.output + 1);
+	c->nvar = 0;
+	for(i = 0; i < cube.output; i++)
+	    if (is_in_set(vars, i))
+		c->var[c->nvar++] = i;
+	if (c->nvar == 0)		/* a constant still needs a cube */
+	    c->var[c->nvar++] = 0;
+    }
+    set_free(vars);
+    set_free(taken);
+    return clusters;
+}
+
+
+/* cluster_setup -- the context of a cluster, and its map of the parts */
+static void
+cluster_setup(c)
+register cluster_t *c;
+{
+    register int i, j, k, part;
+    int *part_size, num_binary_vars;
+
+    part_size = cube.part_size;
+    num_binary_vars = cube.num_binary_vars;
+    c->part = ALLOC(int, cube.size);
+    c->rest = set_save(cube.fullset);
+    j = 0;
+    for(i = 0; i < c->nvar; i++)
+	for(part = cube.first_part[c->var[i]];
+	    part <= cube.last_part[c->var[i]]; part++) {
+	    set_remove(c->rest, part);
+	    c->part[j++] = part;
+	}
+    for(k = 0; k < c->nout; k++)
+	c->part[j++] = cube.first_part[cube.output] + c->out[k];
+    (void) set_diff(c->rest, c->rest, cube.var_mask[cube.output]);
+
+    c->ctx = new_ctx();
+    activate_ctx(c->ctx);
+    cube.num_vars = c->nvar + 1;
+    cube.num_binary_vars = 0;
+    cube.part_size = ALLOC(int, cube.num_vars);
+    for(i = 0; i < c->nvar; i++) {
+	cube.part_size[i] = part_size[c->var[i]];
+	if (c->var[i] < num_binary_vars)
+	    cube.num_binary_vars++;
+    }
+    cube.part_size[c->nvar] = c->nout;
+    cube_setup();
+    c->size = cube.size;
+    deactivate_ctx(c->ctx);
+}
+
+
+/* cluster_cover -- the cubes of T for the outputs of c, in c's context */
+static pcover
+cluster_cover(c, T)
+register cluster_t *c;
+pcover T;
+{
+    register pcube p, q, last;
+    register int j, k;
+    pcover S;
+
+    S = new_cover(T->count);
+    foreach_set(T, last, p) {
+	for(k = cube.first_part[cube.output]; k < cube.size; k++)
+	    if (is_in_set(p, c->part[k]))
+		break;
+	if (k == cube.size)
+	    continue;
+	q = GETSET(S, S->count++);
+	(void) set_clear(q, cube.size);
+	for(j = 0; j < cube.size; j++)
+	    if (is_in_set(p, c->part[j]))
+		set_insert(q, j);
+    }
+    return S;
+}
+
+
+/* cluster_minimize -- espresso() over one cluster of F (with D) */
+static void
+cluster_minimize(c, F, D)
+register cluster_t *c;
+pcover F, D;
+{
+    pcover R;
+
+    activate_ctx(c->ctx);
+    F = cluster_cover(c, F);
+    D = cluster_cover(c, D);
+    R = complement(cube2list(F, D));
+    c->result = espresso(F, D, R);
+    free_cover(D);
+    free_cover(R);
+    deactivate_ctx(c->ctx);
+}
+
+
+/* cluster_collect -- add the cover of c to F, as cubes of the function */
+static pcover
+cluster_collect(c, F)
+register cluster_t *c;
+pcover F;
+{
+    register pcube p, q, last;
+    register int j;
+
+    p = new_cube();
+    foreach_set(c->result, last, q) {
+	(void) set_copy(p, c->rest);
+	for(j = 0; j < c->size; j++)
+	    if (is_in_set(q, j))
+		set_insert(p, c->part[j]);
+	F = sf_addset(F, p);
+    }
+    free_cube(p);
+    activate_ctx(c->ctx);
+    free_cover(c->result);
+    deactivate_ctx(c->ctx);
+    free_ctx(c->ctx);
+    FREE(c->part);
+    set_free(c->rest);
+    FREE(c->var);
+    FREE(c->out);
+    return F;
+}
+
+
+/* cluster_compare -- order cubes by their inputs only */
+static int
+cluster_compare(a, b)
+pcube *a, *b;
+{
+    register pcube p = *a, q = *b, mask = cluster_mask;
+    register int i;
+    register unsigned int x, y;
+
+    for(i = LOOP(p); i > 0; i--) {
+	x = p[i] & mask[i], y = q[i] & mask[i];
+	if (x != y)
+	    return x < y ? -1 : 1;
+    }
+    return 0;
+}
+
+
+/* merge_outputs -- one cube for the outputs of cubes with equal inputs */
+static pcover
+merge_outputs(F)
+pcover F;
+{
+    pcube *list, *p, last;
+    pcover R;
+
+    cluster_mask = set_diff(new_cube(), cube.fullset,
+			    cube.var_mask[cube.output]);
+    list = sf_list(F);
+    qsort((char *) list, F->count, sizeof(pcube), cluster_compare);
+    R = new_cover(F->count);
+    last = NULL;
+    for(p = list; *p != NULL; p++) {
+	if (last != NULL && cluster_compare(&last, p) == 0) {
+	    (void) set_or(last, last, *p);
+	} else {
+	    last = GETSET(R, R->count++);
+	    (void) set_copy(last, *p);
+	}
+    }
+    FREE(list);
+    free_cube(cluster_mask);
+    free_cover(F);
+    return R;
+}
+
+
+/*
+    cluster_espresso -- minimize F (which is disposed of) with don't
+    cares D, "size" outputs at a time
+*/
+pcover
+cluster_espresso(F, D, size)
+pcover F, D;
+int size;
+{
+    cluster_t *clusters;
+    pset *support;
+    pcover F1;
+    int i, n, nclusters;
+
+    if (size < 1)
+	size = 1;
+    if (cube.output == -1 || cube.part_size[cube.output] <= size) {
+	return espresso(F, D, complement(cube2list(F, D)));
+    }
+
+    n = cube.part_size[cube.output];
+    support = output_support(F, D);
+    clusters = make_clusters(support, size, &nclusters);
+    for(i = 0; i < n; i++)
+	set_free(support[i]);
+    FREE(support);
+
+    F1 = new_cover(F->count);
+    for(i = 0; i < nclusters; i++) {
+	cluster_setup(&clusters[i]);
+	cluster_minimize(&clusters[i], F, D);
+	F1 = cluster_collect(&clusters[i], F1);
+    }
+    FREE(clusters);
+    free_cover(F);
+
+    return irredundant(merge_outputs(F1), D);
+}
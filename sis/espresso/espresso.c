@@ -45,6 +45,7 @@ pcover F, D1, R;
     pcover E, D, Fsave;
     pset last, p;
     cost_t cost, best_cost;
+    bool unwrap = unwrap_onset;		/* private copy: the option is shared */
 
 begin:
     Fsave = sf_save(F);		/* save original function */
@@ -57,7 +58,7 @@ begin:
 	F = E;
     }
     cover_cost(F, &cost);
-    if (unwrap_onset && (cube.part_size[cube.num_vars - 1] > 1)
+    if (unwrap && (cube.part_size[cube.num_vars - 1] > 1)
       && (cost.out != cost.cubes*cube.part_size[cube.num_vars-1])
       && (cost.out < 5000))
 	EXEC(F = sf_contain(unravel(F, cube.num_vars - 1)), "SETUP      ", F);
@@ -121,7 +122,7 @@ begin:
     if (Fsave->count < F->count) {
 	free_cover(F);
 	F = Fsave;
-	unwrap_onset = FALSE;
+	unwrap = FALSE;
 	goto begin;
     } else {
 	free_cover(Fsave);
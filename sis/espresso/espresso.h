@@ -18,6 +18,22 @@
 #define NO_INLINE
 #define BPI 16
 #endif
+
+/*
+ *  Storage class for the state of the minimizer which must be private to
+ *  each thread (the cube structure, cdata and the statistics).  Compilers
+ *  without thread-local storage fall back to ordinary globals, which is
+ *  correct as long as only one thread minimizes at a time.
+ */
+#ifndef ESPRESSO_TLS
+#if defined(__GNUC__) || defined(__clang__)
+#define ESPRESSO_TLS __thread
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define ESPRESSO_TLS _Thread_local
+#else
+#define ESPRESSO_TLS
+#endif
+#endif
 
 /*-----THIS USED TO BE set.h----- */
 
@@ -221,7 +237,10 @@ typedef struct set_family {
 
 #endif	/* NO_INLINE */
 
-#if BPI == 32
+/* Count the elements of one set word, in hardware where possible */
+#if defined(__GNUC__) || defined(__clang__)
+#define count_ones(v)	__builtin_popcount(v)
+#elif BPI == 32
 #define count_ones(v)\
     (bit_count[v & 255] + bit_count[(v >> 8) & 255]\
     + bit_count[(v >> 16) & 255] + bit_count[(v >> 24) & 255])
@@ -229,7 +248,7 @@ typedef struct set_family {
 #define count_ones(v)   (bit_count[v & 255] + bit_count[(v >> 8) & 255])
 #endif
 
-/* Table for efficient bit counting */
+/* Table for bit counting without a popcount builtin */
 extern int bit_count[256];
 /*----- END OF set.h ----- */
 
@@ -329,11 +348,37 @@ typedef struct {
 #define KISS_type	128		/* output format kiss */
 #define CONSTRAINTS_type	256	/* output the constraints (numeric) */
 #define SYMBOLIC_CONSTRAINTS_type 512	/* output the constraints (symbolic) */
+#define BINARY_type	1024		/* output format binary covers */
 #define FD_type (F_type | D_type)
 #define FR_type (F_type | R_type)
 #define DR_type (D_type | R_type)
 #define FDR_type (F_type | D_type | R_type)
 
+/*
+ *  The binary cover format (write_pla -b) starts with this header.
+ *  part_size[num_vars] and the label table (for each part an int length,
+ *  -1 for no label, and the characters) follow, each padded to a multiple
+ *  of 8 bytes, and then the sets of F, D and R exactly as they are kept
+ *  in memory.  read_pla() recognizes the format by its first byte.  The
+ *  format is the one of espresso -o binary.
+ */
+#define PLA_BINARY_MAGIC	"\211ESP\r\n\032\n"
+#define PLA_BINARY_VERSION	1
+#define PLA_BINARY_ORDER	0x01020304
+
+typedef struct {
+    char magic[8];			/* PLA_BINARY_MAGIC */
+    int version;			/* PLA_BINARY_VERSION */
+    int byte_order;			/* PLA_BINARY_ORDER as written */
+    int word_bits;			/* BPI of the writer */
+    int covers;				/* F_type | D_type | R_type written */
+    int num_vars, num_binary_vars;
+    int wsize;				/* words per set */
+    int count[3];			/* sets in F, D and R */
+    int label_bytes;			/* size of the label table */
+    int unused;
+} pla_binary_t;
+
 /* Definitions for the debug variable */
 #define COMPL           0x0001
 #define ESSEN           0x0002
@@ -416,8 +461,8 @@ typedef struct {
 extern unsigned int debug;              /* debug parameter */
 extern bool verbose_debug;              /* -v:  whether to print a lot */
 extern char *total_name[TIME_COUNT];    /* basic function names */
-extern long total_time[TIME_COUNT];     /* time spent in basic fcts */
-extern int total_calls[TIME_COUNT];     /* # calls to each fct */
+extern ESPRESSO_TLS long total_time[TIME_COUNT]; /* time spent in basic fcts */
+extern ESPRESSO_TLS int total_calls[TIME_COUNT];  /* # calls to each fct */
 
 extern bool echo_comments;		/* turned off by -eat option */
 extern bool echo_unknown_commands;	/* always true ?? */
@@ -488,9 +533,33 @@ struct cdata_struct {
 };
 
 
+
+/*
+ *  An espresso_ctx_t is a complete, independent minimizer state: the cube
+ *  geometry, the cdata scratch area and the statistics.  The espresso core
+ *  always works on the thread's current "cube" and "cdata"; activate_ctx()
+ *  makes a context current (saving what was there before) and
+ *  deactivate_ctx() stores the context back and restores the previous
+ *  state.  Calls may nest, but must be properly bracketed.
+ *
+ *  Since cube and cdata are thread-local, each thread may minimize a
+ *  different problem at the same time.
+ */
+typedef struct espresso_ctx_struct {
+    struct cube_struct cube;		/* cube geometry */
+    struct cdata_struct cdata;		/* unate recursion scratch */
+    long total_time[TIME_COUNT];	/* statistics */
+    int total_calls[TIME_COUNT];
+    bool active;			/* context is current */
+    struct cube_struct save_cube;	/* state before activate_ctx */
+    struct cdata_struct save_cdata;
+    long save_time[TIME_COUNT];
+    int save_calls[TIME_COUNT];
+} espresso_ctx_t, *pctx;
+
 extern struct pla_types_struct pla_types[];
-extern struct cube_struct cube, temp_cube_save;
-extern struct cdata_struct cdata, temp_cdata_save;
+extern ESPRESSO_TLS struct cube_struct cube, temp_cube_save;
+extern ESPRESSO_TLS struct cdata_struct cdata, temp_cdata_save;
 
 #ifdef lint
 #define DISJOINT 0x5555
@@ -539,7 +608,11 @@ typedef int (*ESP_PFI)();
 /* contain.c */	EXTERN pset_family sf_rev_contain ARGS((pset_family));
 /* contain.c */	EXTERN pset_family sf_union ARGS((pset_family, pset_family));
 /* contain.c */	EXTERN pset_family sf_unlist ARGS((pset *, int, int));
+/* cubestr.c */	EXTERN pctx new_ctx ARGS(());
+/* cubestr.c */	EXTERN void activate_ctx ARGS((pctx));
 /* cubestr.c */	EXTERN void cube_setup ARGS(());
+/* cubestr.c */	EXTERN void deactivate_ctx ARGS((pctx));
+/* cubestr.c */	EXTERN void free_ctx ARGS((pctx));
 /* cubestr.c */	EXTERN void restore_cube_struct ARGS(());
 /* cubestr.c */	EXTERN void save_cube_struct ARGS(());
 /* cubestr.c */	EXTERN void setdown_cube ARGS(());
@@ -595,6 +668,7 @@ typedef int (*ESP_PFI)();
 /* cvrout.c */	EXTERN void debug1_print ARGS((pcover, char *, int));
 /* cvrout.c */	EXTERN void sf_debug_print ARGS((pcube *, char *, int));
 /* cvrout.c */	EXTERN void eqn_output ARGS((pPLA));
+/* cvrout.c */	EXTERN void fpr_binary ARGS((FILE *, pPLA, int));
 /* cvrout.c */	EXTERN void fpr_header ARGS((FILE *, pPLA, int));
 /* cvrout.c */	EXTERN void fprint_pla ARGS((FILE *, pPLA, int));
 /* cvrout.c */	EXTERN void pls_group ARGS((pPLA, FILE *));
@@ -605,6 +679,7 @@ typedef int (*ESP_PFI)();
 /* cvrout.c */	EXTERN void debug_print ARGS((pcube *, char *, int));
 /* equiv.c */	EXTERN int  find_equiv_outputs ARGS((pPLA));
 /* equiv.c */	EXTERN int check_equiv ARGS((pcover, pcover));
+/* esp_cluster.c */	EXTERN pcover cluster_espresso ARGS((pcover, pcover, int));
 /* espresso.c */	EXTERN pcover espresso ARGS((pcover, pcover, pcover));
 /* essen.c */	EXTERN bool essen_cube ARGS((pcover, pcover, pcube));
 /* essen.c */	EXTERN pcover cb_consensus ARGS((pcover, pcube));
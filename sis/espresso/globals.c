@@ -8,8 +8,8 @@
 unsigned int debug;              /* debug parameter */
 bool verbose_debug;              /* -v:  whether to print a lot */
 char *total_name[TIME_COUNT];    /* basic function names */
-long total_time[TIME_COUNT];     /* time spent in basic fcts */
-int total_calls[TIME_COUNT];     /* # calls to each fct */
+ESPRESSO_TLS long total_time[TIME_COUNT]; /* time spent in basic fcts */
+ESPRESSO_TLS int total_calls[TIME_COUNT]; /* # calls to each fct */
 
 bool echo_comments;		 /* turned off by -eat option */
 bool echo_unknown_commands;	 /* always true ?? */
@@ -49,12 +49,17 @@ struct pla_types_struct pla_types[] = {
     "-kiss", KISS_type,
     "-cons", CONSTRAINTS_type,
     "-scons", SYMBOLIC_CONSTRAINTS_type,
+    "-binary", BINARY_type | F_type,
+    "-binaryfd", BINARY_type | FD_type,
+    "-binaryfr", BINARY_type | FR_type,
+    "-binaryfdr", BINARY_type | FDR_type,
     0, 0
 };
 
 
-struct cube_struct cube, temp_cube_save;
-struct cdata_struct cdata, temp_cdata_save;
+/* per-thread minimizer state (see activate_ctx() in cubestr.c) */
+ESPRESSO_TLS struct cube_struct cube, temp_cube_save;
+ESPRESSO_TLS struct cdata_struct cdata, temp_cdata_save;
 
 int bit_count[256] = {
   0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4,1,2,2,3,2,3,3,4,2,3,3,4,3,4,4,5,
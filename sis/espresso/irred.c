@@ -6,7 +6,7 @@ static void ftautology();
 static bool ftaut_special_cases();
 
 
-static int Rp_current;
+static ESPRESSO_TLS int Rp_current;
 
 /*
  *   irredundant -- Return a minimal subset of F
@@ -208,7 +208,7 @@ pcube *T;         /* T will be disposed of */
 {
     register pcube cl, cr;
     register int best, result;
-    static int taut_level = 0;
+    static ESPRESSO_TLS int taut_level = 0;
 
     if (debug & TAUT) {
 	debug_print(T, "TAUTOLOGY", taut_level++);
@@ -337,7 +337,7 @@ sm_matrix *table;
 {
     register pcube cl, cr;
     register int best;
-    static int ftaut_level = 0;
+    static ESPRESSO_TLS int ftaut_level = 0;
 
     if (debug & TAUT) {
 	debug_print(T, "FIND_TAUTOLOGY", ftaut_level++);
@@ -10,7 +10,7 @@
 
 #include "espresso.h"
 
-static bool toggle = TRUE;
+static ESPRESSO_TLS bool toggle = TRUE;
 
 
 /*
@@ -104,7 +104,7 @@ INOUT pcube *T;         /* T will be disposed of */
     pcube r;
     register pcube cl, cr;
     register int best;
-    static int sccc_level = 0;
+    static ESPRESSO_TLS int sccc_level = 0;
 
     if (debug & REDUCE1) {
 	debug_print(T, "SCCC", sccc_level++);
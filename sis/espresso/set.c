@@ -6,7 +6,7 @@
 /* LINTLIBRARY */
 
 #include "espresso.h"
-static pset_family set_family_garbage = NULL;
+static ESPRESSO_TLS pset_family set_family_garbage = NULL;
 
 static int intcpy(d, s, n)
 register unsigned int *d, *s;
@@ -500,7 +500,7 @@ FILE *fp;
 
 /* ps1 -- convert a set into a printable string */
 #define largest_string 120
-static char s1[largest_string];
+static ESPRESSO_TLS char s1[largest_string];
 char *ps1(a)
 register pset a;
 {
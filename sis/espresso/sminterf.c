@@ -10,19 +10,36 @@ pset_family A;
     sm_row *sparse_cover;
     sm_element *pe;
     pset cover;
-    register int i, base, rownum;
+    register int i, base, rownum, n;
     register unsigned val;
     register pset last, p;
+    int *row, *col;
 
-    M = sm_alloc();
-    rownum = 0;
+    /* the coordinates by row and column, for sm_insert_sorted() */
+    n = 0;
+    foreach_set(A, last, p) {
+	n += set_ord(p);
+    }
+    row = ALLOC(int, n + 1);
+    col = ALLOC(int, n + 1);
+    n = rownum = 0;
     foreach_set(A, last, p) {
-	foreach_set_element(p, i, val, base) {
-	    (void) sm_insert(M, rownum, base);
+	for(i = 1; i <= LOOP(p); i++) {
+	    for(val = p[i], base = (i - 1) << LOGBPI; val != 0; base++, val >>= 1) {
+		if (val & 1) {
+		    row[n] = rownum;
+		    col[n++] = base;
+		}
+	    }
 	}
 	rownum++;
     }
 
+    M = sm_alloc();
+    sm_insert_sorted(M, n, row, col);
+    FREE(row);
+    FREE(col);
+
     sparse_cover = sm_minimum_cover(M, NIL(int), 1, 0);
     sm_free(M);
 
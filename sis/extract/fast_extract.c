@@ -7,42 +7,71 @@
 static int debugging = 1;
 static void sd_modify();
 
-/* Map a network node to a sparse matrix representation. */
+static int *fx_sort_index;
+
+static int
+fx_fanin_cmp(a, b)
+char *a, *b;
+{
+    return fx_sort_index[*(int *) a] - fx_sort_index[*(int *) b];
+}
+
+
+/*
+ *  Map a network node to a sparse matrix representation: a row for each
+ *  cube, appended after the rows of M.  The fanins are visited in the
+ *  order of their columns, so the rows go in with sm_insert_sorted().
+ */
 void
 fx_node_to_sm(node, M)
 register node_t *node;
 register sm_matrix *M;
 {
     register pset last, p;
-    register int i, row;
-    int *fanin_index;
+    register int i, k, row, n, start;
+    int *fanin_index, *order, *rows, *cols;
     node_t *fanin;
-    sm_element *pelement;
 
-    foreach_set(node->F, last, p) {
-	row = M->nrows;
-
-	fanin_index = ALLOC(int, node->nin);
-	foreach_fanin(node, i, fanin) {
-	    fanin_index[i] = 2 * nodeindex_indexof(global_node_index, fanin);
-	}
+    fanin_index = ALLOC(int, node->nin);
+    order = ALLOC(int, node->nin);
+    foreach_fanin(node, i, fanin) {
+	fanin_index[i] = 2 * nodeindex_indexof(global_node_index, fanin);
+	order[i] = i;
+    }
+    fx_sort_index = fanin_index;
+    qsort((char *) order, node->nin, sizeof(int), fx_fanin_cmp);
 
-	foreach_fanin(node, i, fanin) {
+    rows = ALLOC(int, node->F->count * node->nin + 1);
+    cols = ALLOC(int, node->F->count * node->nin + 1);
+    n = 0;
+    row = M->nrows;
+    foreach_set(node->F, last, p) {
+	start = n;
+	for(k = 0; k < node->nin; k++) {
+	    i = order[k];
 	    switch (GETINPUT(p, i)) {
 	    case ZERO:
-		pelement = sm_insert(M, row, fanin_index[i] + 1);
+		rows[n] = row;
+		cols[n++] = fanin_index[i] + 1;
 		break;
 	    case ONE:
-		pelement = sm_insert(M, row, fanin_index[i]);
+		rows[n] = row;
+		cols[n++] = fanin_index[i];
 		break;
 	    case TWO:
-		pelement = NIL(sm_element);
 		break;
 	    }
 	}
-
-	FREE(fanin_index);
+	if (n > start) {
+	    row++;		/* a cube without literals has no row */
+	}
     }
+    sm_insert_sorted(M, n, rows, cols);
+
+    FREE(fanin_index);
+    FREE(order);
+    FREE(rows);
+    FREE(cols);
 }
 
 
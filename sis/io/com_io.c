@@ -144,14 +144,15 @@ network_t **network;
 int argc;
 char **argv;
 {
-    int c, short_name, net_list, status, delays_flag, wslif;
+    int c, short_name, net_list, status, delays_flag, wslif, binary;
     FILE *fp;
     network_t *dc_network;
 
     short_name = 0;
     net_list = 0;
+    binary = 0;
     util_getopt_reset();
-    while ((c = util_getopt(argc, argv, "snd")) != EOF) {
+    while ((c = util_getopt(argc, argv, "sndb")) != EOF) {
 	switch(c) {
 	case 's':
 	    short_name = 1;
@@ -162,6 +163,9 @@ char **argv;
 	case 'd':
 	    delays_flag = 1;
 	    break;
+	case 'b':
+	    binary = 1;
+	    break;
 	default:
 	    goto usage;
 	}
@@ -240,7 +244,7 @@ char **argv;
 	    (void) fprintf(sisout, "Warning: only combinational portion is being written.\n");
 	}
 #endif /* SIS */
-	write_pla(fp, *network);
+	write_pla(fp, *network, binary);
 	status = 1;
     }
     else if (strcmp(argv[0], "write_bdnet") == 0) {
@@ -277,6 +281,9 @@ usage:
         (void) fprintf(siserr,
 		"    -d\t\tprint the slif-format delay information\n");
     }
+    if (strcmp(argv[0], "write_pla") == 0) {
+	(void) fprintf(siserr, "    -b\t\twrite the binary cover format\n");
+    }
     return(1);
 }
 
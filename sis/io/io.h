@@ -3,7 +3,7 @@
 #define IO_H
 
 EXTERN void write_blif ARGS((FILE *, network_t *, int, int));
-EXTERN void write_pla ARGS((FILE *, network_t *));
+EXTERN void write_pla ARGS((FILE *, network_t *, int));
 EXTERN void write_eqn ARGS((FILE *, network_t *, int));
 
 #ifdef SIS
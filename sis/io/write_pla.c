@@ -4,9 +4,10 @@
 
 
 void 
-write_pla(fp, network)
+write_pla(fp, network, binary)
 FILE *fp;
 network_t *network;
+int binary;
 {
     pPLA PLA;
 
@@ -15,10 +16,10 @@ network_t *network;
 
     /* Let espresso do the dirty work */
     if (PLA->D) {
-	fprint_pla(fp, PLA, FD_type);
+	fprint_pla(fp, PLA, binary ? BINARY_type | FD_type : FD_type);
     }
     else {
-	fprint_pla(fp, PLA, F_type);
+	fprint_pla(fp, PLA, binary ? BINARY_type | F_type : F_type);
     }
     discard_pla(PLA);
 }
@@ -12,6 +12,7 @@ static int select_column();
 static void select_essential();
 static int verify_cover();
 
+long sm_mincov_time_limit = 0;
 
 
 sm_row *
@@ -44,6 +45,10 @@ int debug_level;	/* how deep in the recursion to provide info */
     stats.gimpel = stats.gimpel_count = 0;
     stats.no_branching = heuristic != 0;
     stats.lower_bound = -1;
+    stats.deadline = 0;
+    if (sm_mincov_time_limit > 0) {
+	stats.deadline = stats.start_time + sm_mincov_time_limit;
+    }
 
     /* Check the matrix sparsity */
     nelem = 0;
@@ -237,6 +242,11 @@ stats_t *stats;
 	    return best1;
 	}
 
+	/* Out of time -- keep the best solution found so far */
+	if (stats->deadline != 0 && util_cpu_time() >= stats->deadline) {
+	    return best1;
+	}
+
         /* Now assume we cannot have that column */
 	A2 = sm_dup(A);
 	select2 = solution_dup(select);
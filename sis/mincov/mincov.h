@@ -1,6 +1,7 @@
 
 /* exported */
 EXTERN sm_row *sm_minimum_cover ARGS((sm_matrix *, int *, int, int));
+EXTERN long sm_mincov_time_limit;	/* ms of cpu time, 0 for no limit */
 
 EXTERN sm_row *sm_mat_bin_minimum_cover ARGS((sm_matrix *, int *, int, int, int, int, int (*)()
 ));
@@ -14,6 +14,7 @@ struct stats_struct {
     long start_time;		/* cpu time when the covering started */
     int no_branching;
     int lower_bound;
+    long deadline;		/* stop branching at this time (0 for never) */
 };
 
 typedef struct solution_struct solution_t;
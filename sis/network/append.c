@@ -46,6 +46,7 @@ network_t *network2_copy;
     /* reset_io */
     foreach_node(network1, gen, node) {
 	foreach_fanin(node, i, fanin) {
+	    if (fanin->copy != fanin) network_journal_touch(node);
 	    node->fanin[i] = fanin->copy;
 	}
     }
@@ -54,6 +55,7 @@ network_t *network2_copy;
     foreach_node(network1, gen, node1) {
 	foreach_fanin(node1, i, fanin) {
 	    if (fanin->type == PRIMARY_OUTPUT) {
+		network_journal_touch(node1);
 		node1->fanin[i] = fanin->fanin[0];
 	    }
 	}
@@ -67,8 +69,7 @@ network_t *network2_copy;
 
     /* reset the fanout pointers */
     foreach_node(network1, gen, node1) {
-	LS_ASSERT(lsDestroy(node1->fanout, free));
-	node1->fanout = lsCreate();
+	node_clear_fanout(node1);
     }
     foreach_node(network1, gen, node1) {
 	fanin_add_fanout(node1);
@@ -67,7 +67,6 @@ char **argv;
 }
 
 
-/* ARGSUSED */
 static int
 com_espresso(network, argc, argv)
 network_t **network;
@@ -75,12 +74,23 @@ int argc;
 char **argv;
 {
     network_t *new_net;
+    int c, size;
 
-    if (argc != 1) {
-    (void) fprintf(miserr, "usage: espresso\n");
-    return 1;
+    size = 0;
+    util_getopt_reset();
+    while ((c = util_getopt(argc, argv, "c:")) != EOF) {
+    switch(c) {
+    case 'c':
+        size = atoi(util_optarg);
+        if (size < 1) goto usage;
+        break;
+    default:
+        goto usage;
+    }
     }
-    new_net = network_espresso(*network);
+    if (argc != util_optind) goto usage;
+
+    new_net = network_espresso_cluster(*network, size);
     if (new_net == 0) {        /* well, happens for some weird cases */
     return 0;
     } else {
@@ -88,6 +98,11 @@ char **argv;
     *network = new_net;
     }
     return 0;
+
+usage:
+    (void) fprintf(miserr, "usage: espresso [-c size]\n");
+    (void) fprintf(miserr, "    -c size\tminimize the outputs size at a time\n");
+    return 1;
 }
 
 static int
@@ -7,22 +7,27 @@
  *  the outputs (all fanin's appear in the list before each node)
  *
  *  Crash and burn if a cycle is detected in the network.
+ *
+ *  The network keeps the order until it changes (network_dfs_changed()),
+ *  and the level of each node (network_levels()) until the fanin of the
+ *  node or of one of its transitive fanins changes.
  */
 
 static int network_dfs_recur();
 
-array_t *
-network_dfs(network)
+static array_t *
+dfs_order(network)
 network_t *network;
 {
   int i;
-  st_table *visited;
+  char *mark;
   array_t *roots;
   array_t *node_vec;
   node_t *node;
   lsGen gen;
 
-  visited = st_init_table(st_ptrcmp, st_ptrhash);
+  mark = ALLOC(char, network_num_ids(network) + 1);
+  (void) memset(mark, 0, network_num_ids(network) + 1);
   node_vec = array_alloc(node_t *, 0);
   roots = array_alloc(node_t *, 0);
 
@@ -37,15 +42,155 @@ network_t *network;
   }
   for (i = 0; i < array_n(roots); i++) {
     node = array_fetch(node_t *, roots, i);
-    if (! network_dfs_recur(node, node_vec, visited, 1, INFINITY)) {
+    if (! network_dfs_recur(node, node_vec, NIL(st_table), mark,
+								1, INFINITY)) {
       fail("network_dfs: network contains a cycle\n");
     }
   }
-  st_free_table(visited);
+  FREE(mark);
   array_free(roots);
   return node_vec;
 }
 
+array_t *
+network_dfs(network)
+network_t *network;
+{
+  if (network->dfs == NIL(array_t)) {
+    network->dfs = dfs_order(network);
+  }
+  return array_dup(network->dfs);
+}
+
+
+/* the level of 'node', found again if it is marked in 'mark' */
+static int
+level_recur(node, level, mark)
+node_t *node;
+int *level;
+char *mark;
+{
+    int i, l;
+    node_t *fanin;
+
+    assert(node->id >= 0 && node->id < node->network->num_ids);
+    if (mark[node->id] != 0) {
+	mark[node->id] = 0;
+	l = 0;
+	if (node->type != PRIMARY_INPUT) {
+	    foreach_fanin(node, i, fanin) {
+		l = MAX(l, level_recur(fanin, level, mark));
+	    }
+	    l++;
+	}
+	level[node->id] = l;
+    }
+    return level[node->id];
+}
+
+
+int *
+network_levels(network)
+network_t *network;
+{
+    int i, n, all;
+    char *mark;
+    array_t *stack;
+    node_t *node, *fanout;
+    lsGen gen;
+
+    n = network_num_ids(network);
+    all = network->level == NIL(int);
+    if (all) {
+	network->level_dirty = array_alloc(int, 0);
+    }
+    if (network->level_n < n || all) {
+	network->level = REALLOC(int, network->level, n + 1);
+	for(i = network->level_n; i < n; i++) {
+	    network->level[i] = -1;
+	    array_insert_last(int, network->level_dirty, i);
+	}
+	network->level_n = n;
+    }
+    if (array_n(network->level_dirty) == 0) {
+	return network->level;
+    }
+
+    /* the nodes marked, and their transitive fanout, get new levels */
+    mark = ALLOC(char, n + 1);
+    (void) memset(mark, 0, n + 1);
+    stack = array_alloc(node_t *, 0);
+    for(i = 0; i < array_n(network->level_dirty); i++) {
+	node = network_node_by_id(network,
+				array_fetch(int, network->level_dirty, i));
+	if (node != NIL(node_t) && ! mark[node->id]) {
+	    mark[node->id] = 1;
+	    array_insert_last(node_t *, stack, node);
+	}
+    }
+    while (! all && array_n(stack) > 0) {
+	node = array_fetch_last(node_t *, stack);
+	stack->num--;
+	foreach_fanout(node, gen, fanout) {
+	    assert(fanout->id >= 0 && fanout->id < network->num_ids);
+	    if (! mark[fanout->id]) {
+		mark[fanout->id] = 1;
+		array_insert_last(node_t *, stack, fanout);
+	    }
+	}
+    }
+    for(i = 0; i < n; i++) {
+	if (mark[i] && (node = network_node_by_id(network, i)) != 0) {
+	    (void) level_recur(node, network->level, mark);
+	}
+    }
+    array_free(stack);
+    FREE(mark);
+    network->level_dirty->num = 0;
+    return network->level;
+}
+
+
+/*
+ *  network_dfs_changed -- the fanin or the type of 'node' (or, if 0,
+ *  the node list of 'network') changes
+ */
+void
+network_dfs_changed(network, node)
+network_t *network;
+node_t *node;
+{
+    if (network == NIL(network_t)) {
+	return;
+    }
+    if (network->dfs != NIL(array_t)) {
+	array_free(network->dfs);
+	network->dfs = NIL(array_t);
+    }
+    if (node != NIL(node_t) && network->level != NIL(int) &&
+	    node->id < network->level_n && network->level[node->id] != -1) {
+	network->level[node->id] = -1;
+	array_insert_last(int, network->level_dirty, node->id);
+    }
+}
+
+
+void
+network_dfs_reset(network)
+network_t *network;
+{
+    if (network->dfs != NIL(array_t)) {
+	array_free(network->dfs);
+	network->dfs = NIL(array_t);
+    }
+    if (network->level != NIL(int)) {
+	FREE(network->level);
+	array_free(network->level_dirty);
+	network->level_dirty = NIL(array_t);
+	network->level_n = 0;
+    }
+}
+
 #ifdef SIS
 /* Make sure that the vector returned has all the control po nodes
    BEFORE the latch output nodes.  This is so that the arrivals of the
@@ -57,13 +202,14 @@ network_special_dfs(network)
 network_t *network;
 {
   int i;
-  st_table *visited;
+  char *mark;
   array_t *roots;
   array_t *node_vec;
   node_t *node;
   lsGen gen;
 
-  visited = st_init_table(st_ptrcmp, st_ptrhash);
+  mark = ALLOC(char, network_num_ids(network) + 1);
+  (void) memset(mark, 0, network_num_ids(network) + 1);
   node_vec = array_alloc(node_t *, 0);
   roots = array_alloc(node_t *, 0);
 
@@ -85,11 +231,12 @@ network_t *network;
   }
   for (i = 0; i < array_n(roots); i++) {
     node = array_fetch(node_t *, roots, i);
-    if (! network_dfs_recur(node, node_vec, visited, 1, INFINITY)) {
+    if (! network_dfs_recur(node, node_vec, NIL(st_table), mark,
+								1, INFINITY)) {
       fail("network_dfs: network contains a cycle\n");
     }
   }
-  st_free_table(visited);
+  FREE(mark);
   array_free(roots);
   return node_vec;
 }
@@ -101,13 +248,14 @@ network_dfs_from_input(network)
 network_t *network;
 {
   int i;
-  st_table *visited;
+  char *mark;
   array_t *node_vec;
   array_t *roots;
   node_t *node;
   lsGen gen;
 
-  visited = st_init_table(st_ptrcmp, st_ptrhash);
+  mark = ALLOC(char, network_num_ids(network) + 1);
+  (void) memset(mark, 0, network_num_ids(network) + 1);
   node_vec = array_alloc(node_t *, 0);
   roots = array_alloc(node_t *, 0);
 
@@ -122,11 +270,12 @@ network_t *network;
   }
   for (i = 0; i < array_n(roots); i++) {
     node = array_fetch(node_t *, roots, i);
-    if (! network_dfs_recur(node, node_vec, visited, 0, INFINITY)) {
+    if (! network_dfs_recur(node, node_vec, NIL(st_table), mark,
+								0, INFINITY)) {
       fail("network_dfs_from_input: network contains a cycle\n");
     }
   }
-  st_free_table(visited);
+  FREE(mark);
   array_free(roots);
   return node_vec;
 }
@@ -145,7 +294,7 @@ int level;
     node_vec = array_alloc(node_t *, 0);
 
     foreach_fanin(node, i, fanin) {
-	if (! network_dfs_recur(fanin, node_vec, visited, 1, level)) {
+	if (! network_dfs_recur(fanin, node_vec, visited, NIL(char), 1, level)) {
 	    fail("network_tfi: network contains a cycle\n");
 	}
     }
@@ -169,7 +318,7 @@ int level;
     node_vec = array_alloc(node_t *, 0);
 
     foreach_fanout(node, gen, fanout) {
-	if (! network_dfs_recur(fanout, node_vec, visited, 0, level)) {
+	if (! network_dfs_recur(fanout, node_vec, visited, NIL(char), 0, level)) {
 	    fail("network_tfo: network contains a cycle\n");
 	}
     }
@@ -178,11 +327,17 @@ int level;
     return node_vec;
 }
 
+/*
+ *  The searches over the whole network mark the nodes in 'mark', by id
+ *  (0: not visited, 1: on the active path, 2: done); the others, which
+ *  stop at a level, keep the nodes they visit in 'visited'.
+ */
 static int 
-network_dfs_recur(node, node_vec, visited, dir, level)
+network_dfs_recur(node, node_vec, visited, mark, dir, level)
 node_t *node;
 array_t *node_vec;
 st_table *visited;
+char *mark;
 int dir;		/* 1 == visit inputs, 0 == visit outputs */ 
 int level;
 {
@@ -193,27 +348,34 @@ int level;
 
     if (level > 0) {
 
-	if (st_lookup(visited, (char *) node, &value)) {
-	    return value == 0;		/* if value is 1, then a cycle */
+	assert(mark == NIL(char) ||
+		(node->id >= 0 && node->id < node->network->num_ids));
+	if (mark != NIL(char) ? mark[node->id] != 0 :
+		st_lookup(visited, (char *) node, &value)) {
+	    /* if it is on the active path, then a cycle */
+	    return mark != NIL(char) ? mark[node->id] == 2 : value == 0;
 
 	} else {
 	    /* add this node to the active path */
-	    value = (char *) 1;
-	    (void) st_insert(visited, (char *) node, value);
+	    if (mark != NIL(char)) {
+		mark[node->id] = 1;
+	    } else {
+		(void) st_insert(visited, (char *) node, (char *) 1);
+	    }
 
 	    /* avoid recursion if level-1 wouldn't add anything anyways */
 	    if (level > 1) {
 		if (dir) {
 		    foreach_fanin(node, i, fanin) {
 			if (! network_dfs_recur(fanin, node_vec, 
-						    visited, dir, level-1)) {
+					    visited, mark, dir, level-1)) {
 			    return 0;
 			}
 		    }
 		} else {
 		    foreach_fanout(node, gen, fanout) {
 			if (! network_dfs_recur(fanout, node_vec, 
-						    visited, dir, level-1)) {
+					    visited, mark, dir, level-1)) {
 			    return 0;
 			}
 		    }
@@ -221,8 +383,11 @@ int level;
 	    }
 
 	    /* take this node off of the active path */
-	    value = (char *) 0;
-	    (void) st_insert(visited, (char *) node, value);
+	    if (mark != NIL(char)) {
+		mark[node->id] = 2;
+	    } else {
+		(void) st_insert(visited, (char *) node, (char *) 0);
+	    }
 
 	    /* add node to list */
 	    array_insert_last(node_t *, node_vec, node);
@@ -8,6 +8,20 @@ static void save_latch_info();
 network_t *
 network_espresso(network)
 network_t *network;
+{
+    return network_espresso_cluster(network, 0);
+}
+
+
+/*
+ *  network_espresso_cluster -- as network_espresso(), but with size > 0
+ *  the outputs are minimized "size" at a time (see cluster_espresso()),
+ *  which never computes the offset of the whole network
+ */
+network_t *
+network_espresso_cluster(network, size)
+network_t *network;
+int size;
 {
     network_t *new_net;
     pPLA PLA;
@@ -16,14 +30,17 @@ network_t *network;
     if (PLA == 0) return 0;
 
     if (PLA->R != 0) sf_free(PLA->R);
-    if (PLA->D != 0) {
-      PLA->R = complement(cube2list(PLA->F,PLA->D));
-    } else {
+    PLA->R = 0;
+    if (PLA->D == 0) {
       PLA->D = new_cover(0);
-      PLA->R = complement(cube1list(PLA->F));
     }
 
-    PLA->F = espresso(PLA->F, PLA->D, PLA->R);
+    if (size > 0) {
+      PLA->F = cluster_espresso(PLA->F, PLA->D, size);
+    } else {
+      PLA->R = complement(cube2list(PLA->F,PLA->D));
+      PLA->F = espresso(PLA->F, PLA->D, PLA->R);
+    }
     new_net = pla_to_network(PLA);
     network_set_name(new_net, network_name(network));
     delay_network_dup(new_net, network);
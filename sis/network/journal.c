@@ -0,0 +1,515 @@
+
+#include "sis.h"
+
+/*
+ *  The change journal behind 'undo'.
+ *
+ *  Rather than copying the whole network before a command which changes
+ *  it, the command interpreter starts a journal on the network.  The
+ *  node and network routines which change a node call
+ *  network_journal_touch() first; the first time a node of the network
+ *  is touched a copy of it (the 'image') is put aside.  The fanout of a
+ *  node is put aside the same way (network_journal_fanout()) the first
+ *  time a fanout is added or removed.  The first time a
+ *  node is added to or deleted from the network the node lists are put
+ *  aside, and a node of the network which is deleted is kept (out of the
+ *  network) rather than freed.  The names, delay and clock information
+ *  of the network itself are copied when the journal starts.
+ *
+ *  network_journal_undo() then swaps every touched node with its image,
+ *  every changed fanout with the saved one (so that the fanouts come back
+ *  in their order), and the network with its saved lists and
+ *  information: the network is
+ *  back as it was, and the journal now holds the state after the command
+ *  (so a second undo redoes it).
+ *
+ *  A network with a don't care network, latches or state transition
+ *  graphs is not journaled (network_journal_begin() returns 0), as the
+ *  routines which change those are not hooked; the caller copies it.
+ */
+
+typedef struct journal_struct journal_t;
+struct journal_struct {
+    network_t *network;		/* the network being journaled */
+    int first_id;		/* nodes with a larger sis_id are new */
+    st_table *touched;		/* touched node -> its other contents */
+    st_table *fanouts;		/* node -> its other fanout (fanout_save_t) */
+    array_t *nodes;		/* the other node lists (0: unchanged) */
+    array_t *pi;
+    array_t *po;
+    network_t *other;		/* the other name, delay, clock, ... */
+    int retired;		/* network_free() was called on 'network' */
+};
+
+typedef struct fanout_save_struct fanout_save_t;
+struct fanout_save_struct {
+    fanout_t *fanout;
+    int used;
+    int size;
+    int nfanout;
+};
+
+static journal_t *journal = 0;
+
+extern int node_next_id();
+extern void network_rehash_names();
+
+
+static array_t *
+list_to_array(list)
+lsList list;
+{
+    array_t *array;
+    lsGen gen;
+    node_t *node;
+
+    array = array_alloc(node_t *, lsLength(list));
+    lsForeachItem(list, gen, node) {
+	array_insert_last(node_t *, array, node);
+    }
+    return array;
+}
+
+
+static lsList
+array_to_list(array)
+array_t *array;
+{
+    lsList list;
+    int i;
+
+    list = lsCreate();
+    for(i = 0; i < array_n(array); i++) {
+	LS_ASSERT(lsNewEnd(list, (lsGeneric) array_fetch(node_t *, array, i),
+								LS_NH));
+    }
+    return list;
+}
+
+
+/*
+ *  swap everything but the identity and the place in the network of two
+ *  nodes; the fanouts are rebuilt by the caller
+ */
+static void
+node_swap_contents(a, b)
+node_t *a, *b;
+{
+    node_t temp;
+
+    temp = *a;
+
+    a->name = b->name;
+    a->short_name = b->short_name;
+    a->type = b->type;
+    a->is_dup_free = b->is_dup_free;
+    a->is_min_base = b->is_min_base;
+    a->is_scc_minimal = b->is_scc_minimal;
+    a->nin = b->nin;
+    a->fanin = b->fanin;
+    a->F = b->F;
+    a->D = b->D;
+    a->R = b->R;
+    a->simulation = b->simulation;
+    a->factored = b->factored;
+    a->delay = b->delay;
+    a->map = b->map;
+    a->bdd = b->bdd;
+    a->pld = b->pld;
+    a->ite = b->ite;
+    a->buf = b->buf;
+    a->bin = b->bin;
+    a->atpg = b->atpg;
+    a->undef1 = b->undef1;
+
+    b->name = temp.name;
+    b->short_name = temp.short_name;
+    b->type = temp.type;
+    b->is_dup_free = temp.is_dup_free;
+    b->is_min_base = temp.is_min_base;
+    b->is_scc_minimal = temp.is_scc_minimal;
+    b->nin = temp.nin;
+    b->fanin = temp.fanin;
+    b->F = temp.F;
+    b->D = temp.D;
+    b->R = temp.R;
+    b->simulation = temp.simulation;
+    b->factored = temp.factored;
+    b->delay = temp.delay;
+    b->map = temp.map;
+    b->bdd = temp.bdd;
+    b->pld = temp.pld;
+    b->ite = temp.ite;
+    b->buf = temp.buf;
+    b->bin = temp.bin;
+    b->atpg = temp.atpg;
+    b->undef1 = temp.undef1;
+}
+
+
+/* swap the fanout of a node with a saved one */
+static void
+fanout_swap(node, save)
+node_t *node;
+fanout_save_t *save;
+{
+    fanout_save_t temp;
+
+    temp = *save;
+    save->fanout = node->fanout;
+    save->used = node->fanout_used;
+    save->size = node->fanout_size;
+    save->nfanout = node->nfanout;
+    node->fanout = temp.fanout;
+    node->fanout_used = temp.used;
+    node->fanout_size = temp.size;
+    node->nfanout = temp.nfanout;
+    node->fanout_gens = 0;
+}
+
+
+/* put the nodes of a list in 'network' (their ids stay theirs) or out */
+static void
+set_network(list, network, in)
+lsList list;
+network_t *network;
+int in;
+{
+    lsGen gen;
+    lsHandle handle;
+    node_t *node;
+
+    gen = lsStart(list);
+    while (lsNext(gen, (lsGeneric *) &node, &handle) == LS_OK) {
+	node->network = in ? network : NIL(network_t);
+	node->net_handle = in ? handle : 0;
+	network->node_array[node->id] = in ? node : NIL(node_t);
+    }
+    LS_ASSERT(lsFinish(gen));
+}
+
+
+/* swap the network with the other state held by the journal */
+static void
+journal_swap(j)
+journal_t *j;
+{
+    network_t *network = j->network, *other = j->other;
+    st_generator *sgen;
+    lsGen gen;
+    node_t *node, *image;
+    fanout_save_t *save;
+    fanout_t *rec;
+    array_t *nodes, *pi, *po;
+    char *temp;
+    int i;
+    double area;
+    int area_given;
+    network_t *dc_network;
+#ifdef SIS
+    st_table *latch_table;
+    lsList latch;
+    graph_t *stg;
+    astg_t *astg;
+#endif /* SIS */
+
+    set_network(network->nodes, network, 0);
+
+    st_foreach_item(j->touched, sgen, (char **) &node, (char **) &image) {
+	node_swap_contents(node, image);
+	FREE(node->fanin_fanout);
+    }
+    st_foreach_item(j->fanouts, sgen, (char **) &node, (char **) &save) {
+	fanout_swap(node, save);
+    }
+
+    if (j->nodes != 0) {
+	nodes = list_to_array(network->nodes);
+	pi = list_to_array(network->pi);
+	po = list_to_array(network->po);
+	LS_ASSERT(lsDestroy(network->nodes, (void (*)()) 0));
+	LS_ASSERT(lsDestroy(network->pi, (void (*)()) 0));
+	LS_ASSERT(lsDestroy(network->po, (void (*)()) 0));
+	network->nodes = array_to_list(j->nodes);
+	network->pi = array_to_list(j->pi);
+	network->po = array_to_list(j->po);
+	array_free(j->nodes);
+	array_free(j->pi);
+	array_free(j->po);
+	j->nodes = nodes;
+	j->pi = pi;
+	j->po = po;
+    }
+    set_network(network->nodes, network, 1);
+    network_dfs_reset(network);
+
+    /* point every node at its place in the fanout of its fanins */
+    foreach_node(network, gen, node) {
+	if (node->fanin_fanout == 0) {
+	    node->fanin_fanout = ALLOC(int, node->nin + 1);
+	}
+    }
+    foreach_node(network, gen, node) {
+	for(i = 0; i < node->fanout_used; i++) {
+	    rec = node->fanout + i;
+	    if (rec->fanout != 0) {
+		rec->fanout->fanin_fanout[rec->pin] = i;
+	    }
+	}
+    }
+    network_rehash_names(network, /* long */ 1, /* short */ 1);
+
+    temp = network->net_name;
+    network->net_name = other->net_name;
+    other->net_name = temp;
+    area = network->area;
+    network->area = other->area;
+    other->area = area;
+    area_given = network->area_given;
+    network->area_given = other->area_given;
+    other->area_given = area_given;
+    temp = network->default_delay;
+    network->default_delay = other->default_delay;
+    other->default_delay = temp;
+    dc_network = network->dc_network;
+    network->dc_network = other->dc_network;
+    other->dc_network = dc_network;
+#ifdef SIS
+    temp = network->clock;
+    network->clock = other->clock;
+    other->clock = temp;
+    latch_table = network->latch_table;
+    network->latch_table = other->latch_table;
+    other->latch_table = latch_table;
+    latch = network->latch;
+    network->latch = other->latch;
+    other->latch = latch;
+    stg = network->stg;
+    network->stg = other->stg;
+    other->stg = stg;
+    astg = network->astg;
+    network->astg = other->astg;
+    other->astg = astg;
+#endif /* SIS */
+}
+
+
+/*
+ *  network_journal_begin -- journal the changes to 'network' (ending the
+ *  journal of the previous command); 0 if it cannot be journaled
+ */
+int
+network_journal_begin(network)
+network_t *network;
+{
+    journal_t *j;
+
+    network_journal_end();
+    if (network == NIL(network_t) || network->dc_network != NIL(network_t)) {
+	return 0;
+    }
+#ifdef SIS
+    if (lsLength(network->latch) != 0 || network->stg != NIL(graph_t) ||
+	    network->astg != NIL(astg_t)) {
+	return 0;
+    }
+#endif /* SIS */
+
+    j = ALLOC(journal_t, 1);
+    j->network = network;
+    j->first_id = node_next_id();
+    j->touched = st_init_table(st_ptrcmp, st_ptrhash);
+    j->fanouts = st_init_table(st_ptrcmp, st_ptrhash);
+    j->nodes = j->pi = j->po = 0;
+    j->retired = 0;
+    j->other = network_alloc();
+    if (network->net_name != NIL(char)) {
+	j->other->net_name = util_strsav(network->net_name);
+    }
+    j->other->area = network->area;
+    j->other->area_given = network->area_given;
+    delay_network_dup(j->other, network);
+#ifdef SIS
+    network_clock_dup(network, j->other);
+#endif /* SIS */
+    journal = j;
+    return 1;
+}
+
+
+/*
+ *  network_journal_end -- forget the journal, and free the state it holds
+ *  (the network itself too if the command freed it)
+ */
+void
+network_journal_end()
+{
+    journal_t *j = journal;
+    st_generator *sgen;
+    node_t *node, *image;
+    fanout_save_t *save;
+    int i;
+
+    if (j == 0) return;
+    journal = 0;
+
+    st_foreach_item(j->touched, sgen, (char **) &node, (char **) &image) {
+	node_free(image);
+    }
+    st_free_table(j->touched);
+    st_foreach_item(j->fanouts, sgen, (char **) &node, (char **) &save) {
+	FREE(save->fanout);
+	FREE(save);
+    }
+    st_free_table(j->fanouts);
+    if (j->nodes != 0) {
+	for(i = 0; i < array_n(j->nodes); i++) {
+	    node = array_fetch(node_t *, j->nodes, i);
+	    if (node->network != j->network) {
+		node_free(node);
+	    }
+	}
+	array_free(j->nodes);
+	array_free(j->pi);
+	array_free(j->po);
+    }
+    network_free(j->other);
+    if (j->retired) {
+	network_free(j->network);
+    }
+    FREE(j);
+}
+
+
+/*
+ *  network_journal_undo -- put *network back as it was before the last
+ *  command; 0 if there is no journal.  If the command replaced the
+ *  network, the journal ends and *replaced is set to the network the
+ *  command made (or to 0).
+ */
+int
+network_journal_undo(network, replaced)
+network_t **network;
+network_t **replaced;
+{
+    journal_t *j = journal;
+
+    *replaced = NIL(network_t);
+    if (j == 0) return 0;
+    journal = 0;		/* no journaling of the undo itself */
+    journal_swap(j);
+
+    if (*network == j->network) {
+	journal = j;		/* undo again to redo */
+	return 1;
+    }
+
+    *replaced = *network;
+    *network = j->network;
+    j->retired = 0;
+    journal = j;
+    network_journal_end();
+    return 1;
+}
+
+
+/*
+ *  network_journal_touch -- 'node' is about to change; keep a copy of it
+ *  the first time
+ */
+void
+network_journal_touch(node)
+node_t *node;
+{
+    journal_t *j = journal;
+    char **slot;
+
+    if (j == 0 || node->network != j->network || node->sis_id >= j->first_id) {
+	return;
+    }
+    if (! st_find_or_add(j->touched, (char *) node, &slot)) {
+	*slot = (char *) node_dup(node);
+    }
+}
+
+
+/*
+ *  network_journal_fanout -- a fanout is about to be added to or removed
+ *  from 'node'; keep a copy of its fanout the first time
+ */
+void
+network_journal_fanout(node)
+node_t *node;
+{
+    journal_t *j = journal;
+    fanout_save_t *save;
+    char **slot;
+    int i;
+
+    if (j == 0 || node->network != j->network || node->sis_id >= j->first_id) {
+	return;
+    }
+    if (! st_find_or_add(j->fanouts, (char *) node, &slot)) {
+	save = ALLOC(fanout_save_t, 1);
+	save->fanout = ALLOC(fanout_t, node->fanout_used + 1);
+	for(i = 0; i < node->fanout_used; i++) {
+	    save->fanout[i] = node->fanout[i];
+	}
+	save->used = node->fanout_used;
+	save->size = node->fanout_used + 1;
+	save->nfanout = node->nfanout;
+	*slot = (char *) save;
+    }
+}
+
+
+/*
+ *  network_journal_lists -- a node is about to be added to or removed
+ *  from 'network'; keep its node lists the first time
+ */
+void
+network_journal_lists(network)
+network_t *network;
+{
+    journal_t *j = journal;
+
+    if (j == 0 || network != j->network || j->nodes != 0) {
+	return;
+    }
+    j->nodes = list_to_array(network->nodes);
+    j->pi = list_to_array(network->pi);
+    j->po = list_to_array(network->po);
+}
+
+
+/*
+ *  network_journal_keep -- TRUE if 'node', which has just been taken out
+ *  of 'network', is to be kept for undo rather than freed
+ */
+int
+network_journal_keep(network, node)
+network_t *network;
+node_t *node;
+{
+    journal_t *j = journal;
+
+    return j != 0 && network == j->network && node->sis_id < j->first_id;
+}
+
+
+/*
+ *  network_journal_retire -- TRUE if 'network' is journaled, in which case
+ *  network_free() leaves it to the journal
+ */
+int
+network_journal_retire(network)
+network_t *network;
+{
+    journal_t *j = journal;
+
+    if (j == 0 || network != j->network) {
+	return 0;
+    }
+    j->retired = 1;
+    return 1;
+}
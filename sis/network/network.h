@@ -19,6 +19,16 @@ struct network_struct {
     lsList nodes;		/* list of all nodes */
     lsList pi;			/* list of just primary inputs */
     lsList po;			/* list of just primary outputs */
+    node_t **node_array;	/* node of each id (0: deleted) */
+    int num_ids;		/* ids given out (the used part of node_array) */
+    int node_array_size;	/* size of node_array */
+    char **side;		/* the node data of each side table (side.c) */
+    int *side_n;		/* the number of nodes in each of those */
+    int num_side;		/* the number of side tables allocated */
+    array_t *dfs;		/* network_dfs() order, until a change (dfs.c) */
+    int *level;			/* level of each id, for network_levels() */
+    int level_n;		/* the number of ids 'level' has room for */
+    array_t *level_dirty;	/* ids whose fanin changed since (level -1) */
     network_t *original;	/* UNUSED: pointer to original network */
     double area;		/* HACK: support area keyword */
     int area_given;		/* HACK: support area keyword */
@@ -57,6 +67,19 @@ EXTERN network_t *network_dup ARGS((network_t *));
 EXTERN network_t *network_create_from_node ARGS((node_t *));
 EXTERN network_t *network_from_nodevec ARGS((array_t *));
 
+EXTERN int network_num_ids ARGS((network_t *));
+EXTERN void network_give_id ARGS((network_t *, node_t *));
+EXTERN node_t *network_node_by_id ARGS((network_t *, int));
+EXTERN int network_side_register ARGS((int, void (*)(), void (*)()));
+EXTERN char *network_side ARGS((node_t *, int));
+EXTERN char *network_side_lookup ARGS((node_t *, int));
+EXTERN void network_side_release ARGS((network_t *, int));
+EXTERN void network_side_delete ARGS((network_t *, node_t *));
+EXTERN void network_side_free ARGS((network_t *));
+EXTERN int *network_levels ARGS((network_t *));
+EXTERN void network_dfs_changed ARGS((network_t *, node_t *));
+EXTERN void network_dfs_reset ARGS((network_t *));
+
 EXTERN char *network_name ARGS((network_t *));
 EXTERN void network_set_name ARGS((network_t *, char *));
 EXTERN int network_num_pi ARGS((network_t *));
@@ -82,6 +105,7 @@ EXTERN int network_csweep ARGS((network_t *));
 EXTERN int network_cleanup ARGS((network_t *));
 EXTERN int network_ccleanup ARGS((network_t *));
 EXTERN network_t *network_espresso ARGS((network_t *));
+EXTERN network_t *network_espresso_cluster ARGS((network_t *, int));
 
 EXTERN array_t *network_dfs ARGS((network_t *));
 #ifdef SIS
@@ -138,4 +162,13 @@ EXTERN st_table *attach_dcnetwork_to_network ARGS((network_t *));
 EXTERN node_t *find_ex_dc ARGS((node_t *, st_table *));
 EXTERN network_t *or_net_dcnet ARGS((network_t *));
 
+EXTERN int network_journal_begin ARGS((network_t *));
+EXTERN void network_journal_end ARGS((void));
+EXTERN int network_journal_undo ARGS((network_t **, network_t **));
+EXTERN void network_journal_touch ARGS((node_t *));
+EXTERN void network_journal_fanout ARGS((node_t *));
+EXTERN void network_journal_lists ARGS((network_t *));
+EXTERN int network_journal_keep ARGS((network_t *, node_t *));
+EXTERN int network_journal_retire ARGS((network_t *));
+
 #endif
@@ -5,8 +5,8 @@ typedef struct cpexdc_struct{
     node_t  *node;
 } cpexdc_type_t;
 
-#define OBS cspf
-#define CPEXDC(node)  ((cpexdc_type_t *) (node)->OBS)
+static int cpexdc_side = -1;	/* side table for or_net_dcnet() */
+#define CPEXDC(node)  ((cpexdc_type_t *) network_side(node, cpexdc_side))
 
 static void duplicate_list(); 
 static void copy_list(); 
@@ -14,19 +14,19 @@ static void reset_io();
 
 extern void network_rehash_names(); 
 
-static void
-cpexdc_alloc(node)
-node_t    *node;
-{
-	node->OBS = (char *)  ALLOC(cpexdc_type_t, 1);
-	CPEXDC(node)->node= NIL(node_t);
-}
-
-static void
-cpexdc_free(node)
-node_t    *node;
+/* give 'node', just added to 'network', the next id of the network */
+void
+network_give_id(network, node)
+network_t *network;
+node_t *node;
 {
-  FREE(node->OBS);
+    if (network->num_ids == network->node_array_size) {
+	network->node_array_size = 2 * network->node_array_size + 64;
+	network->node_array = REALLOC(node_t *, network->node_array,
+					network->node_array_size);
+    }
+    node->id = network->num_ids++;
+    network->node_array[node->id] = node;
 }
 
 
@@ -42,6 +42,16 @@ network_alloc()
     net->nodes = lsCreate();
     net->pi = lsCreate();
     net->po = lsCreate();
+    net->node_array = NIL(node_t *);
+    net->num_ids = 0;
+    net->node_array_size = 0;
+    net->side = NIL(char *);
+    net->side_n = NIL(int);
+    net->num_side = 0;
+    net->dfs = NIL(array_t);
+    net->level = NIL(int);
+    net->level_n = 0;
+    net->level_dirty = NIL(array_t);
     net->original = NIL(network_t);
     net->dc_network = NIL(network_t);
     net->area_given = 0;
@@ -64,12 +74,18 @@ network_free(net)
 network_t *net;
 {
     if (net != NIL(network_t)) {
+	if (network_journal_retire(net)) {
+	    return;		/* the journal frees it, unless undone */
+	}
 	FREE(net->net_name);
 	st_free_table(net->name_table);
 	st_free_table(net->short_name_table);
 	LS_ASSERT(lsDestroy(net->pi, (void (*)()) 0));
 	LS_ASSERT(lsDestroy(net->po, (void (*)()) 0));
 	LS_ASSERT(lsDestroy(net->nodes, node_free));
+	network_dfs_reset(net);
+	network_side_free(net);
+	FREE(net->node_array);
 	network_free(net->original);
 	network_free(net->dc_network);
         LS_ASSERT(lsDestroy(net->bdd_list, (void (*)()) 0));
@@ -152,6 +168,27 @@ network_t *network;
 }
 
 
+/* ids run from 0 to network_num_ids() - 1 (with gaps for deleted nodes) */
+int
+network_num_ids(network)
+network_t *network;
+{
+    return network->num_ids;
+}
+
+
+node_t *
+network_node_by_id(network, id)
+network_t *network;
+int id;
+{
+    if (id < 0 || id >= network->num_ids) {
+	return NIL(node_t);
+    }
+    return network->node_array[id];
+}
+
+
 node_t *
 network_get_pi(network, index)
 network_t *network;
@@ -196,6 +233,7 @@ network_add_primary_input(network, node)
 network_t *network;
 node_t *node;
 {
+    network_journal_touch(node);
     node->type = PRIMARY_INPUT;
     node->nin = 0;
     FREE(node->fanin);
@@ -268,6 +306,7 @@ node_t *node;
     }
 
 
+    network_journal_lists(network);
     if (node->type == PRIMARY_INPUT) {
 	LS_ASSERT(lsNewEnd(network->pi, (lsGeneric) node, LS_NH));
     }
@@ -277,6 +316,8 @@ node_t *node;
     LS_ASSERT(lsNewEnd(network->nodes, (lsGeneric) node, &handle));
     node->network = network;
     node->net_handle = handle;
+    network_give_id(network, node);
+    network_dfs_changed(network, node);
 
     /* patch the fanout lists for our fanin's */
     fanin_add_fanout(node);
@@ -310,7 +351,9 @@ lsGen gen;
     node_t *node;
 
     /* Unlink from the node list */
+    network_journal_lists(network);
     LS_ASSERT(lsDelBefore(gen, (lsGeneric *) &node));
+    network_dfs_changed(network, NIL(node_t));
 
     /* force deletion from PI/PO lists */
     network_change_node_type(network, node, INTERNAL);
@@ -330,9 +373,13 @@ lsGen gen;
     /* patch the fanout lists for our fanins */
     fanin_remove_fanout(node);
 
+    network_side_delete(network, node);
     node->network = 0;		/* avoid recursion ... */
     node->net_handle = 0;
-    node_free(node);
+    network->node_array[node->id] = 0;	/* the node keeps its id */
+    if (! network_journal_keep(network, node)) {
+	node_free(node);
+    }
 }
 
 node_t *
@@ -375,6 +422,9 @@ network_t *network;
 node_t *node;
 node_type_t new_type;
 {
+    network_journal_lists(network);
+    network_journal_touch(node);
+    network_dfs_changed(network, node);
     if (node->type == PRIMARY_INPUT) {
 	if (! delete_from_list(network->pi, node)) {
 	    fail("network_change_node_type: PI node not in PI list");
@@ -459,6 +509,7 @@ network_t *newnetwork;
 	LS_ASSERT(lsNewEnd(newlist, (lsGeneric) newnode, &handle));
 	newnode->network = newnetwork;
 	newnode->net_handle = handle;
+	network_give_id(newnetwork, newnode);
     }
 }
 
@@ -504,6 +555,7 @@ char *new_name;
 {
     char *key;
 
+    network_journal_touch(node);
     key = node->name;
     if (! st_delete(network->name_table, &key, NIL(char *))) {
 	fail("network_change_name: node not found in name table");
@@ -527,6 +579,7 @@ char *new_name;
 {
     char *key;
 
+    network_journal_touch(node);
     key = node->short_name;
     if (! st_delete(network->short_name_table, &key, NIL(char *))) {
 	fail("change_short_name: node not found in name table");
@@ -547,6 +600,8 @@ node_t *node2;
 {
     char *key;
 
+    network_journal_touch(node1);
+    network_journal_touch(node2);
     key = node1->name;
     assert(st_delete(network->name_table, &key, NIL(char *)));
     key = node2->name;
@@ -656,10 +711,12 @@ network_t *network;
     node_exdc_table = attach_dcnetwork_to_network(net);
     DC_network = network_dc_network(net);
 
+    if (cpexdc_side < 0) {
+        cpexdc_side = network_side_register(sizeof(cpexdc_type_t), 0, 0);
+    }
     dc_list= network_dfs(DC_network);
     for(i=0 ; i< array_n(dc_list); i++){
         dcnode = array_fetch(node_t *, dc_list, i);
-        cpexdc_alloc(dcnode);
         if (node_function(dcnode) == NODE_PI){
 		   assert(st_lookup(node_exdc_table, (char *) dcnode, &dummy));
 		   node= (node_t *) dummy;
@@ -721,10 +778,7 @@ network_t *network;
         network_add_node(net, n3);
         node_patch_fanin(po, n2, n3);
     }
-    for(i=0 ; i< array_n(dc_list); i++){
-        dcnode = array_fetch(node_t *, dc_list, i);
-        cpexdc_free(dcnode);
-    }
+    network_side_release(DC_network, cpexdc_side);
     st_free_table(node_exdc_table);
     array_free(dc_list);
     return(net);
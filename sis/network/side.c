@@ -0,0 +1,180 @@
+
+#include "sis.h"
+
+/*
+ *  Side tables: node data which a package keeps for the nodes of a
+ *  network, in one array per package and per network, indexed by the id
+ *  of the node (see network_num_ids()), rather than in a slot of every
+ *  node_t.  A package registers its side table once, giving the size of
+ *  the data of a node, and gets the data of a node with network_side().
+ *  The array of a network is allocated the first time the package asks
+ *  for the data of one of its nodes, and grows with the network; it is
+ *  freed all at once, by network_side_release() or network_free().
+ */
+
+typedef struct side_struct side_t;
+struct side_struct {
+    int size;			/* bytes of data per node */
+    void (*init)();		/* init(data) of a node, or 0: zero-filled */
+    void (*free)();		/* free(data) of a node, or 0 */
+};
+
+static side_t *sides = 0;
+static int num_sides = 0;
+
+
+/* (re)initialize n entries of a side table, from 'data' on */
+static void
+side_init(side, data, n)
+side_t *side;
+char *data;
+int n;
+{
+    int i;
+
+    (void) memset(data, 0, n * side->size);
+    if (side->init != 0) {
+	for(i = 0; i < n; i++) {
+	    (*side->init)(data + i * side->size);
+	}
+    }
+}
+
+
+/*
+ *  network_side_register -- a new side table, with 'size' bytes of data
+ *  per node; returns its number
+ */
+int
+network_side_register(size, init_func, free_func)
+int size;
+void (*init_func)();
+void (*free_func)();
+{
+    sides = REALLOC(side_t, sides, num_sides + 1);
+    sides[num_sides].size = size;
+    sides[num_sides].init = init_func;
+    sides[num_sides].free = free_func;
+    return num_sides++;
+}
+
+
+/*
+ *  network_side -- the data of 'node' (which must be in a network) in
+ *  side table s
+ */
+char *
+network_side(node, s)
+node_t *node;
+int s;
+{
+    network_t *network = node->network;
+    side_t *side = sides + s;
+    int i, n;
+
+    if (network == NIL(network_t)) {
+	fail("network_side: node is not in a network");
+    }
+    if (s >= network->num_side) {
+	network->side = REALLOC(char *, network->side, num_sides);
+	network->side_n = REALLOC(int, network->side_n, num_sides);
+	for(i = network->num_side; i < num_sides; i++) {
+	    network->side[i] = NIL(char);
+	    network->side_n[i] = 0;
+	}
+	network->num_side = num_sides;
+    }
+    assert(node->id >= 0 && node->id < network->num_ids);
+    if (node->id >= network->side_n[s]) {
+	n = network->node_array_size;
+	network->side[s] = REALLOC(char, network->side[s], n * side->size);
+	side_init(side, network->side[s] + network->side_n[s] * side->size,
+						    n - network->side_n[s]);
+	network->side_n[s] = n;
+    }
+    return network->side[s] + node->id * side->size;
+}
+
+
+/*
+ *  network_side_lookup -- the data of 'node' in side table s, or 0
+ *  if the network has none for it yet (does not allocate)
+ */
+char *
+network_side_lookup(node, s)
+node_t *node;
+int s;
+{
+    network_t *network = node->network;
+
+    if (network == NIL(network_t) || s >= network->num_side ||
+	    node->id >= network->side_n[s]) {
+	return NIL(char);
+    }
+    assert(node->id >= 0 && node->id < network->num_ids);
+    return network->side[s] + node->id * sides[s].size;
+}
+
+
+/*
+ *  network_side_release -- free the data of all of the nodes of 'network'
+ *  in side table s
+ */
+void
+network_side_release(network, s)
+network_t *network;
+int s;
+{
+    side_t *side = sides + s;
+    int i;
+
+    if (s >= network->num_side || network->side[s] == NIL(char)) {
+	return;
+    }
+    if (side->free != 0) {
+	for(i = 0; i < network->side_n[s]; i++) {
+	    (*side->free)(network->side[s] + i * side->size);
+	}
+    }
+    FREE(network->side[s]);
+    network->side_n[s] = 0;
+}
+
+
+/* for network_delete_node(): the data of 'node' goes back to its start */
+void
+network_side_delete(network, node)
+network_t *network;
+node_t *node;
+{
+    side_t *side;
+    char *data;
+    int s;
+
+    for(s = 0; s < network->num_side; s++) {
+	if (node->id < network->side_n[s]) {
+	    side = sides + s;
+	    data = network->side[s] + node->id * side->size;
+	    if (side->free != 0) {
+		(*side->free)(data);
+	    }
+	    side_init(side, data, 1);
+	}
+    }
+}
+
+
+/* for network_free(): free all of the side tables of 'network' */
+void
+network_side_free(network)
+network_t *network;
+{
+    int s;
+
+    for(s = 0; s < network->num_side; s++) {
+	network_side_release(network, s);
+    }
+    FREE(network->side);
+    FREE(network->side_n);
+    network->num_side = 0;
+}
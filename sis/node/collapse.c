@@ -95,6 +95,7 @@ register int bad_value;
     index2p1 = 2*index + 1;
     delcnt = 0;
 
+    network_journal_touch(f);
     foreach_set(f->F, last, p) {
 	SET(p, ACTIVE);
     }
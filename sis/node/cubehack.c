@@ -38,7 +38,7 @@ define_cube_size(n)
 int n;
 {
     register int q, i;
-    static int called_before = 0;
+    static ESPRESSO_TLS int called_before = 0;	/* cube is per-thread */
 
     /* check if the cube is already just the right size */
     if (cube.fullset != 0 && cube.num_binary_vars == n && cube.num_vars == n)
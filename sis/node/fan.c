@@ -3,15 +3,57 @@
 #include "node_int.h"
 
 
+/*
+ *  The fanout of a node is a vector of fanout_t records, in the order
+ *  the fanouts were added.  Removing a fanout leaves a hole (a record
+ *  with a 0 fanout) so that the other records keep their place, and
+ *  fanin_fanout[i] of a node stays the index of its record in the
+ *  fanout of its i-th fanin.  The holes are squeezed out when the
+ *  vector is full, unless a fanout generator is open on the node.
+ */
+
+typedef struct fanout_gen_struct fanout_gen_t;
+struct fanout_gen_struct {
+    node_t *node;
+    int index;
+};
+
+
+static void
+fanout_compact(node)
+node_t *node;
+{
+    register fanout_t *rec;
+    register int i, j;
+
+    j = 0;
+    for(i = 0; i < node->fanout_used; i++) {
+	rec = node->fanout + i;
+	if (rec->fanout != 0) {
+	    rec->fanout->fanin_fanout[rec->pin] = j;
+	    node->fanout[j++] = *rec;
+	}
+    }
+    node->fanout_used = j;
+}
+
+
 static void
 fanin_remove_single_fanout(node, i)
 node_t *node;
 int i;
 {
-    char *data;
+    node_t *fanin;
 
-    LS_ASSERT(lsRemoveItem(node->fanin_fanout[i], &data));
-    FREE(data);
+    fanin = node->fanin[i];
+    network_journal_fanout(fanin);
+    network_dfs_changed(node->network, node);
+    fanin->fanout[node->fanin_fanout[i]].fanout = 0;
+    fanin->nfanout--;
+    while (fanin->fanout_used > 0 &&
+		fanin->fanout[fanin->fanout_used-1].fanout == 0) {
+	fanin->fanout_used--;
+    }
     /*node->fanin[i]->fanout_changed = 1;*/
 }
 
@@ -21,30 +63,37 @@ fanin_remove_fanout(node)
 node_t *node;
 {
     register int i;
-    char *data;
 
     for(i = node->nin-1; i >= 0; i--) {
-	LS_ASSERT(lsRemoveItem(node->fanin_fanout[i], &data));
-	FREE(data);
+	fanin_remove_single_fanout(node, i);
 /*	node->fanin[i]->fanout_changed = 1;*/
     }
 }
-
+
 static void
 fanin_replace_single_fanout(node, i)
 node_t *node;
 int i;
 {
-    lsHandle handle; 
     register fanout_t *fanout_rec;
     node_t *fanin;
 
     fanin = node->fanin[i];
-    fanout_rec = ALLOC(fanout_t, 1);
+    network_journal_fanout(fanin);
+    network_dfs_changed(node->network, node);
+    if (fanin->fanout_used == fanin->fanout_size) {
+	if (fanin->fanout_gens == 0 && fanin->nfanout < fanin->fanout_used/2) {
+	    fanout_compact(fanin);
+	} else {
+	    fanin->fanout_size = 2 * fanin->fanout_size + 2;
+	    fanin->fanout = REALLOC(fanout_t, fanin->fanout, fanin->fanout_size);
+	}
+    }
+    fanout_rec = fanin->fanout + fanin->fanout_used;
     fanout_rec->fanout = node;
     fanout_rec->pin = i;
-    LS_ASSERT(lsNewEnd(fanin->fanout, (char *) fanout_rec, &handle));
-    node->fanin_fanout[i] = handle;
+    node->fanin_fanout[i] = fanin->fanout_used++;
+    fanin->nfanout++;
 /*    fanin->fanout_changed = 1;*/
 }
 
@@ -56,25 +105,46 @@ node_t *node;
     register int i;
 
     FREE(node->fanin_fanout);
-    node->fanin_fanout = ALLOC(lsHandle, node->nin);
+    node->fanin_fanout = ALLOC(int, node->nin);
     for(i = node->nin-1; i >= 0; i--) {
 	fanin_replace_single_fanout(node, i);
     }
 }
-
+
+
+/*
+ *  node_clear_fanout -- forget the fanout of 'node', and where 'node' is
+ *  in the fanout of its fanins; the caller rebuilds both with
+ *  fanin_add_fanout() for every node of the network
+ */
+void
+node_clear_fanout(node)
+node_t *node;
+{
+    network_journal_fanout(node);
+    node->fanout_used = 0;
+    node->nfanout = 0;
+    node->fanout_gens = 0;
+    FREE(node->fanin_fanout);
+}
+
+
 lsGen
 node_fanout_init_gen(node)
 node_t *node;
 {
-    lsGen gen;
+    fanout_gen_t *gen;
 
     if (node->network == 0) {
 	fail("foreach_fanout: node is not in a network, fanout undefined");
 	/* NOTREACHED */
     } 
-    gen = lsStart(node->fanout);
-    assert(gen != 0);
-    return gen;
+    /* freed by node_fanout_gen(), or lsFinish() if the loop is left */
+    gen = ALLOC(fanout_gen_t, 1);
+    gen->node = node;
+    gen->index = 0;
+    node->fanout_gens++;
+    return (lsGen) gen;
 }
 
 
@@ -83,18 +153,22 @@ node_fanout_gen(gen, pin)
 lsGen gen;
 int *pin;
 {
-    char *data;
-    fanout_t *fanout_rec;
+    register fanout_gen_t *fgen = (fanout_gen_t *) gen;
+    register node_t *node = fgen->node;
+    register fanout_t *fanout_rec;
 
-    if (lsNext(gen, &data, LS_NH) != LS_OK) {
-	(void) lsFinish(gen);
-	return 0;
+    while (fgen->index < node->fanout_used) {
+	fanout_rec = node->fanout + fgen->index++;
+	if (fanout_rec->fanout != 0) {
+	    if (pin != 0) *pin = fanout_rec->pin;
+	    return fanout_rec->fanout;
+	}
     }
-    fanout_rec = (fanout_t *) data;
-    if (pin != 0) *pin = fanout_rec->pin;
-    return fanout_rec->fanout;
+    node->fanout_gens--;
+    FREE(fgen);
+    return 0;
 }
-
+
 node_t *
 node_get_fanin(node, i)
 node_t *node;
@@ -112,26 +186,20 @@ node_get_fanout(node, i)
 node_t *node;
 int i;
 {
-    int cnt;
-    fanout_t *fanout_rec;
-    lsGen gen;
-    char *data;
+    register int j;
 
     if (i < 0 || i >= node_num_fanout(node)) {
 	fail("node_get_fanout: bad fanout index");
     }
 
-    /* painful */
-    fanout_rec = 0;
-    cnt = 0;
-    lsForeachItem(node->fanout, gen, data) {
-	if (cnt++ == i) {
-	    fanout_rec = (fanout_t *) data;
-	    LS_ASSERT(lsFinish(gen));
-	    break;
+    if (node->nfanout == node->fanout_used) {
+	return node->fanout[i].fanout;		/* no holes */
+    }
+    for(j = 0; ; j++) {
+	if (node->fanout[j].fanout != 0 && i-- == 0) {
+	    return node->fanout[j].fanout;
 	}
     }
-    return fanout_rec->fanout;
 }
 
 
@@ -166,7 +234,7 @@ node_t *node;
 	fail("node_num_fanout: node is not in a network, fanout undefined");
 	/* NOTREACHED */
     }
-    return lsLength(node->fanout);
+    return node->nfanout;
 }
 
 int 
@@ -180,6 +248,7 @@ node_t *new_fanin;
     /* Patch fanin list of node, entry 'fanin' to 'new_fanin' */
     for(i = 0; i < node->nin; i++) {
 	if (node->fanin[i] == fanin) {
+	    network_journal_touch(node);
 	    fanin_remove_single_fanout(node, i);
 	    node->fanin[i] = new_fanin;
 	    fanin_replace_single_fanout(node, i);
@@ -210,6 +279,7 @@ node_t *new_fanin;
     }
       
     /* Patch fanin list of node, entry 'fanin_index' to 'new_fanin' */
+    network_journal_touch(node);
     fanin_remove_single_fanout(node, fanin_index);
     node->fanin[fanin_index] = new_fanin;
     fanin_replace_single_fanout(node, fanin_index);
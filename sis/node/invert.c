@@ -22,6 +22,7 @@ node_t *node;
 	fail("node_invert: node does not have a function");
     }
 
+    network_journal_touch(node);
     if (node->R != 0) {
         sf_free(node->R);
         node->R = 0;
@@ -38,6 +39,7 @@ node_t *node;
     if (node->network != 0) {
 	foreach_fanout_pin(node, gen, fanout, pin) {
 	    if (fanout->type == INTERNAL) {
+		network_journal_touch(fanout);	/* its cubes change in place */
 		foreach_set(fanout->F, last, p) {
 		    pin2 = 2 * pin;
 		    switch(GETINPUT(p, pin)) {
@@ -43,6 +43,7 @@ node_assign_name(node)
 node_t *node;
 {
 	static char buf[80];
+    network_journal_touch(node);
     if (node->name != NIL(char)) FREE(node->name);
     (void) sprintf(buf, "[%d]", long_name_index);
     node->name = ALLOC(char, strlen(buf) + 1);
@@ -57,6 +58,7 @@ node_t *node;
 {
     int i, c;
 
+    network_journal_touch(node);
     c = "abcdefghijklmnopqrstuvwxyz"[short_name_index % 26];
     i = short_name_index / 26;
 
@@ -662,6 +662,7 @@ node_t *f;
 
     int nin, i, lit_count;
 
+    network_journal_touch(f);
     nin = node_num_fanin(f);
     define_cube_size(nin);
 
@@ -68,8 +68,12 @@ struct node_struct {
     int nin;			/* number of inputs */
     node_t **fanin;
 
-    lsList fanout;		/* list of 'fanout_t' structures */
-    lsHandle *fanin_fanout;	/* handles of our fanin's fanout_t structure */
+    fanout_t *fanout;		/* fanout records, in order (0 fanout: hole) */
+    int fanout_used;		/* records in use, holes included */
+    int fanout_size;		/* records allocated */
+    int nfanout;		/* number of fanouts */
+    int fanout_gens;		/* fanout generators open on the node */
+    int *fanin_fanout;		/* index of our record in our fanin's fanout */
 
     pset_family F;		/* on-set */
     pset_family D;		/* dc-set -- currently unused */
@@ -79,17 +83,17 @@ struct node_struct {
 
     network_t *network;		/* network this node belongs to */
     lsHandle net_handle;	/* handle inside of network nodelist */
+    int id;			/* index in the network's node array, or -1 */
 
+    /* package data; see also the side tables, network_side() */
     char *simulation;		/* reserved for simulation package */
     char *factored;		/* reserved for factoring package */
     char *delay;		/* reserved for delay package */
     char *map;			/* reserved for mapping package */
-    char *simplify;		/* reserved for simplify package */
     char *bdd;			/* reserved for bdd package */
     char *pld;			/* reserved for pld package */
     char *ite;			/* reserved for pld package */
     char *buf;			/* reserved for buffer package */
-    char *cspf;			/* reserved for cspf (simplify) package */
     char *bin;			/* reserved for binning (mapping) package */
     char *atpg;			/* reserved for atpg package */
     char *undef1;		/* undefined 1 */
@@ -193,10 +197,11 @@ EXTERN void node_assign_short_name ARGS((node_t *));
 EXTERN int node_is_madeup_name ARGS((char *, int *));
 EXTERN void fanin_remove_fanout ARGS((node_t *));
 EXTERN void fanin_add_fanout ARGS((node_t *));
+EXTERN void node_clear_fanout ARGS((node_t *));
 
 					/* exported for use in macros	*/
 EXTERN int node_error ARGS((int));
-EXTERN node_t *node_fanout_gen ARGS((lsList, int *));
+EXTERN node_t *node_fanout_gen ARGS((lsGen, int *));
 EXTERN lsGen node_fanout_init_gen ARGS((node_t *));
 
 #endif
@@ -239,12 +239,14 @@ node_t *node;
 
     /* bail out for 0, 1 functions ... */
     if (node->nin == 0) {
+	network_journal_touch(node);
 	node->F->count = (node->F->count > 0);	/* make it 0 or 1 */
 	return;
     }
 
     /* make sure it is scc-minimal */
     if (! node->is_scc_minimal) {
+	network_journal_touch(node);
 	node->F = sf_contain(node->F);
     }
 
@@ -301,6 +303,8 @@ node_t **fanin;
 int nin;
 pset_family F;
 {
+    network_journal_touch(f);
+
     /* hack -- allow assignment of a logic function to a PI */
     if (f->type == PRIMARY_INPUT) {
 	if (f->network != 0) {
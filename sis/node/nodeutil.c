@@ -6,6 +6,14 @@ static daemon_t *daemon_func[4];
 static global_sis_id = 0;
 
 
+/* the sis_id of the next node to be allocated */
+int
+node_next_id()
+{
+    return global_sis_id;
+}
+
+
 node_t *
 node_alloc()
 {
@@ -28,7 +36,11 @@ node_alloc()
     node->nin = 0;
     node->fanin = NIL(node_t *);
 
-    node->fanout = lsCreate();
+    node->fanout = NIL(fanout_t);
+    node->fanout_used = 0;
+    node->fanout_size = 0;
+    node->nfanout = 0;
+    node->fanout_gens = 0;
     node->fanin_fanout = 0;
 
     node->F = NIL(set_family_t);
@@ -39,6 +51,7 @@ node_alloc()
 
     node->network = NIL(network_t);
     node->net_handle = 0;
+    node->id = -1;
 
     node->simulation = 0;
     node->factored = 0;
@@ -48,7 +61,6 @@ node_alloc()
     node->pld = 0;
     node->ite = 0;
     node->bin = 0;
-    node->cspf = 0;
     node->atpg = 0;
     node->undef1 = 0;
 
@@ -72,7 +84,7 @@ node_t *node;
 
     FREE(node->fanin);
 
-    LS_ASSERT(lsDestroy(node->fanout, free));
+    FREE(node->fanout);
     FREE(node->fanin_fanout);
 
     if (node->F != 0) sf_free(node->F);
@@ -128,6 +140,7 @@ register node_t *old;
 
     /* do NOT copy old->network ... */
     /* do NOT copy old->net_handle ... */
+    /* do NOT copy old->id ... */
 
     for(d = daemon_func[(int) DAEMON_DUP]; d != 0; d = d->next) {
 	(*d->func)(old, new);
@@ -27,9 +27,10 @@ init_simplify()
     simp_trace = FALSE;
     simp_debug = FALSE;
 
-    node_register_daemon(DAEMON_FREE, simp_free);
-    node_register_daemon(DAEMON_ALLOC, simp_alloc);
-    node_register_daemon(DAEMON_DUP, simp_dup);
+    simp_flag_side = network_side_register(sizeof(sim_flag_t),
+						simp_flag_init, 0);
+    simp_cspf_side = network_side_register(sizeof(cspf_type_t), 0, 0);
+    simp_odc_side = network_side_register(sizeof(odc_type_t), 0, 0);
     node_register_daemon(DAEMON_INVALID, simp_invalid);
 
     com_add_command("simplify", com_simplify, 1);
@@ -351,31 +352,17 @@ st_table *find_node_level(network)
 network_t *network;
 {
    st_table *node_level_table;
-   array_t *nodevec;
-   int i,j;
-   node_t *np, *fanin;
-   int level,tmp;
-   char *dummy;
+   int *level;
+   node_t *np;
+   lsGen gen;
     
    node_level_table = st_init_table(st_ptrcmp, st_ptrhash);
-   nodevec= network_dfs(network);
-   for(i = 0; i < array_n(nodevec); i++) {
-      np = array_fetch(node_t *, nodevec, i); 
+   level= network_levels(network);
+   foreach_node(network, gen, np) {
       if (node_function(np) == NODE_PI)
          continue;
-      level = 0;
-      foreach_fanin(np, j, fanin){
-         if(st_lookup(node_level_table, (char *) fanin, &dummy))
-            tmp= (int) dummy;
-         else
-            tmp= 0;
-         if (level < tmp)
-            level=tmp;
-      }
-      level++;
-      st_insert(node_level_table, (char *) np, (char *) level);
+      st_insert(node_level_table, (char *) np, (char *) level[np->id]);
    }
-   array_free(nodevec);
    return(node_level_table);
 }
 
@@ -516,10 +503,7 @@ char **argv;
                 (void) st_insert(leaves, (char *) node, (char *) j++);
             }
         }
-        for(i= 0 ; i < array_n(network_node_list) ; i++){
-            node= array_fetch(node_t *, network_node_list, i);
-            odc_free(node);
-        }
+        network_side_release(*network, simp_odc_side);
         array_free(odc_order_list);
         array_free(network_node_list);
     }else{
@@ -627,9 +611,9 @@ char **argv;
                 node_free(CSPF(node)->node);
             if (CSPF(node)->set != NIL (var_set_t))
                 var_set_free(CSPF(node)->set);
-            cspf_free(node);
         }
     }
+    network_side_release(*network, simp_cspf_side);
                                                                                 
     free_dcnetwork_copy(*network);
     
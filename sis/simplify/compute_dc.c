@@ -9,11 +9,9 @@ static node_t *cube_to_node();
 void simplify_without_odc();
 void simplify_with_odc();
 void cspf_alloc();
-void cspf_free();
 bdd_t *cspf_bdd_dc();
 static void update_cspf_of_fanins();
 void odc_alloc();
-void odc_free();
 int level_node_cmp1();
 int level_node_cmp2();
 int level_node_cmp3();
@@ -329,13 +327,12 @@ st_table *leaves;
 }
 
 /* 
- * allocate space for CSPFs.
+ * initialize the CSPF of a node (network_side_release() frees them all).
  */
 void 
 cspf_alloc(node)
 node_t    *node;
 {
-    node->OBS = (char *)  ALLOC(cspf_type_t, 1);
     CSPF(node)->level= 0;
     CSPF(node)->node= NIL (node_t);
     CSPF(node)->list= NIL (array_t);
@@ -343,17 +340,6 @@ node_t    *node;
     CSPF(node)->set= NIL (var_set_t);
 }
 
-
-/* free space allocated for CSPFs.
- *
- */
-void 
-cspf_free(node)
-node_t    *node;
-{
-    FREE(node->OBS);
-}
-
 
 /* compute maximum set of permissible functions for an edge.
  *
@@ -592,7 +578,6 @@ int il, ol;
 void odc_alloc(node)
 node_t    *node;
 {
-    node->OBS = (char *)  ALLOC(odc_type_t, 1);
     ODC(node)->order= 0;
     ODC(node)->level= 0;
     ODC(node)->value= 0;
@@ -602,16 +587,6 @@ node_t    *node;
 }
 
 
-/*
- *
- */
-void 
-odc_free(node)
-node_t    *node;
-{
-    FREE(node->OBS);
-}
-
 void find_odc_level(network)
 network_t *network;
 {
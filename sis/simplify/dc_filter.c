@@ -290,6 +290,7 @@ node_t *f;
     nin = node_num_fanin(f);
     define_cube_size(nin);
 
+    network_journal_touch(f);
     old_litcount = node_num_literal(f);
     do {
     lit_count = node_num_literal(f);
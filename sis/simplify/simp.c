@@ -120,9 +120,7 @@ st_table *level_table;
     simp_accept(f, newf, accept);
 
     /* save update the sim_flag */ 
-    SIM_FLAG(f)->method = method;
-    SIM_FLAG(f)->accept = accept;
-    SIM_FLAG(f)->dctype = dctype;
+    simp_set_flag(f, method, accept, dctype);
 }
 
 static void
@@ -265,9 +263,7 @@ st_table *leaves;
     simp_accept(f, newf, accept);
 
     /* save update the sim_flag */ 
-    SIM_FLAG(f)->method = method;
-    SIM_FLAG(f)->accept = accept;
-    SIM_FLAG(f)->dctype = dctype;
+    simp_set_flag(f, method, accept, dctype);
 }
 
 static node_t *local_dc(f, mg, leaves, filter, level_table)
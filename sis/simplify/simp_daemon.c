@@ -2,22 +2,34 @@
 #include "sis.h"
 #include "simp_int.h"
 
+int simp_flag_side;		/* the side tables of the package */
+int simp_cspf_side;
+int simp_odc_side;
+
 
 void
-simp_free(f)
-node_t *f;
+simp_flag_init(flag)
+sim_flag_t *flag;
 {
-    FREE(f->SIM_SLOT);
+    flag->method = SIM_METHOD_UNKNOWN;
+    flag->accept = SIM_ACCEPT_UNKNOWN;
+    flag->dctype = SIM_DCTYPE_UNKNOWN;
 }
 
+
 void
-simp_alloc(f)
+simp_set_flag(f, method, accept, dctype)
 node_t *f;
+sim_method_t method;
+sim_accept_t accept;
+sim_dctype_t dctype;
 {
-    f->SIM_SLOT = (char *) ALLOC(sim_flag_t, 1);
-    SIM_FLAG(f)->method = SIM_METHOD_UNKNOWN;
-    SIM_FLAG(f)->accept = SIM_ACCEPT_UNKNOWN;
-    SIM_FLAG(f)->dctype = SIM_DCTYPE_UNKNOWN;
+    if (f->network == NIL(network_t)) {
+	return;
+    }
+    SIM_FLAG(f)->method = method;
+    SIM_FLAG(f)->accept = accept;
+    SIM_FLAG(f)->dctype = dctype;
 }
 
 
@@ -25,17 +37,10 @@ void
 simp_invalid(f)
 node_t *f;
 {
-    SIM_FLAG(f)->method = SIM_METHOD_UNKNOWN;
-    SIM_FLAG(f)->accept = SIM_ACCEPT_UNKNOWN;
-    SIM_FLAG(f)->dctype = SIM_DCTYPE_UNKNOWN;
-}
+    sim_flag_t *flag;
 
-
-void
-simp_dup(old, new)
-node_t *old, *new;
-{
-    SIM_FLAG(new)->method = SIM_FLAG(old)->method;
-    SIM_FLAG(new)->accept = SIM_FLAG(old)->accept;
-    SIM_FLAG(new)->dctype = SIM_FLAG(old)->dctype;
+    flag = (sim_flag_t *) network_side_lookup(f, simp_flag_side);
+    if (flag != NIL(sim_flag_t)) {
+	simp_flag_init(flag);
+    }
 }
@@ -5,8 +5,10 @@ typedef struct sim_flag_struct {
     sim_dctype_t dctype;
 } sim_flag_t;
 
-#define SIM_SLOT		 simplify
-#define SIM_FLAG(node)		 ((sim_flag_t *) ((node)->SIM_SLOT))
+/* the node data of the package are kept in side tables (network_side()) */
+extern int simp_flag_side, simp_cspf_side, simp_odc_side;
+
+#define SIM_FLAG(node)		 ((sim_flag_t *) network_side(node, simp_flag_side))
 
 typedef struct cspf_struct{
     node_t  *node;
@@ -32,9 +34,8 @@ typedef struct double_node_struct{
 	node_t *neg;
 } double_node_t;
 
-#define OBS cspf
-#define CSPF(node)  ((cspf_type_t *) (node)->OBS)
-#define ODC(node)  ((odc_type_t *) (node)->OBS)
+#define CSPF(node)  ((cspf_type_t *) network_side(node, simp_cspf_side))
+#define ODC(node)  ((odc_type_t *) network_side(node, simp_odc_side))
 
 /* constants for filtering */
 #define F_SET 1
@@ -63,10 +64,9 @@ extern node_t *simp_level_dc();
 extern node_t *simp_dc_filter();
 
 /* simp_daemon.c */
-extern void   simp_alloc();
-extern void   simp_free();
+extern void   simp_flag_init();
+extern void   simp_set_flag();
 extern void   simp_invalid();
-extern void   simp_dup();
 
 /* filter_util.c */
 extern void	 fdc_sm_bp_1();
@@ -92,9 +92,7 @@ extern bdd_t *cspf_bdd_dc();
 extern int odc_value();
 extern void find_odc_level();
 extern void cspf_alloc();
-extern void cspf_free();
 extern void odc_alloc();
-extern void odc_free();
 extern int level_node_cmp1();
 extern int level_node_cmp2();
 extern int level_node_cmp3();
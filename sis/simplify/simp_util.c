@@ -128,19 +128,15 @@ network_t *network;
     dc_list= network_dfs(DC_network);
     for(i=0 ; i< array_n(dc_list); i++){
         dcnode = array_fetch(node_t *, dc_list, i);
-        if (node_function(dcnode) == NODE_PO){
-            (void) cspf_free(dcnode);
-            continue;
-        }
-        if (node_function(dcnode) == NODE_PI){
-            cspf_free(dcnode);
+        if (node_function(dcnode) == NODE_PO ||
+                node_function(dcnode) == NODE_PI){
             continue;
         }
         ntbdd_free_at_node(CSPF(dcnode)->node);
         node_free(CSPF(dcnode)->node);
-        cspf_free(dcnode);
     }
     array_free(dc_list);
+    network_side_release(DC_network, simp_cspf_side);
 }
 
 array_t *order_nodes_elim(network)
@@ -165,10 +161,7 @@ network_t *network;
     }
     (void) find_odc_level(network);
     array_sort(odc_order_list, level_elim_cmp);
-    for(i= 0 ; i < array_n(network_node_list) ; i++){
-      node= array_fetch(node_t *, network_node_list, i);
-      odc_free(node);
-    }
+    network_side_release(network, simp_odc_side);
 	array_free(network_node_list);
     return(odc_order_list);
 }
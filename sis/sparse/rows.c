@@ -11,13 +11,8 @@ sm_row_alloc()
 {
     register sm_row *prow;
 
-#ifdef FAST_AND_LOOSE
-    if (sm_row_freelist == NIL(sm_row)) {
-	prow = ALLOC(sm_row, 1);
-    } else {
-	prow = sm_row_freelist;
-	sm_row_freelist = prow->next_row;
-    }
+#ifndef SM_NO_POOL
+    sm_pool_get(sm_row, prow, sm_row_freelist, next_row);
 #else
     prow = ALLOC(sm_row, 1);
 #endif
@@ -33,16 +28,14 @@ sm_row_alloc()
 
 
 /*
- *  free a row vector -- for FAST_AND_LOOSE, this is real cheap for rows;
- *  however, freeing a column must still walk down the column discarding
- *  the elements one-by-one; that is the only use for the extra '-DCOLS'
- *  compile flag ...
+ *  free a row vector -- with the pools, the elements go back to the free
+ *  list all at once (they are linked by next_col)
  */
 void
 sm_row_free(prow)
 register sm_row *prow;
 {
-#if defined(FAST_AND_LOOSE) && ! defined(COLS)
+#ifndef SM_NO_POOL
     if (prow->first_col != NIL(sm_element)) {
 	/* Add the linked list of row items to the free list */
 	prow->last_col->next_col = sm_element_freelist;
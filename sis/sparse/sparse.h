@@ -113,6 +113,7 @@ EXTERN void sm_free_space ARGS((sm_matrix *));
 EXTERN sm_matrix *sm_dup ARGS((sm_matrix *));
 EXTERN void sm_resize ARGS((sm_matrix *, int, int));
 EXTERN sm_element *sm_insert ARGS((sm_matrix *, int, int));
+EXTERN void sm_insert_sorted ARGS((sm_matrix *, int, int *, int *));
 EXTERN sm_element *sm_find ARGS((sm_matrix *, int, int));
 EXTERN void sm_remove ARGS((sm_matrix *, int, int));
 EXTERN void sm_remove_element ARGS((sm_matrix *, sm_element *));
@@ -77,20 +77,37 @@
 }
 
 
-#ifdef FAST_AND_LOOSE
+/*
+ *  Elements, rows and columns come from pools: they are allocated
+ *  SM_POOL at a time by sm_pool_alloc(), and freeing one puts it back on
+ *  the free list of its kind, so building and freeing matrices does not
+ *  call malloc() for each element.  Define SM_NO_POOL to allocate (and
+ *  free) every object on its own, e.g. for a memory checker.
+ */
+#ifndef SM_NO_POOL
+#define SM_POOL 512
+
 extern sm_element *sm_element_freelist;
 extern sm_row *sm_row_freelist;
 extern sm_col *sm_col_freelist;
-
-#define sm_element_alloc(newobj) \
-    if (sm_element_freelist == NIL(sm_element)) { \
-	newobj = ALLOC(sm_element, 1); \
-    } else { \
-	newobj = sm_element_freelist; \
-	sm_element_freelist = sm_element_freelist->next_col; \
+extern char *sm_pool_alloc();
+
+/* take newobj from the free list, linked by the field next */
+#define sm_pool_get(type, newobj, freelist, next) { \
+    if (freelist == NIL(type)) { \
+	register int i_; \
+	freelist = (type *) sm_pool_alloc(sizeof(type)); \
+	for(i_ = 0; i_ < SM_POOL - 1; i_++) \
+	    freelist[i_].next = &freelist[i_ + 1]; \
+	freelist[SM_POOL - 1].next = NIL(type); \
     } \
-    newobj->user_word = NIL(char); \
+    newobj = freelist; \
+    freelist = newobj->next; \
+}
 
+#define sm_element_alloc(newobj) \
+    sm_pool_get(sm_element, newobj, sm_element_freelist, next_col); \
+    newobj->user_word = NIL(char);
 #define sm_element_free(e) \
     (e->next_col = sm_element_freelist, sm_element_freelist = e)
 
@@ -1954,6 +1954,7 @@ network_t *newnetwork;
 	LS_ASSERT(lsNewEnd(newlist, (lsGeneric) newnode, &handle));
 	newnode->network = newnetwork;
 	newnode->net_handle = handle;
+	network_give_id(newnetwork, newnode);
     }
 }
 
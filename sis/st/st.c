@@ -1,8 +1,31 @@
-
 #include <stdio.h>
 #include "util.h"
 #include "st.h"
 
+/*
+ *  The entries of a table are kept in one array of slots, and ctrl[i]
+ *  tells what slot i holds: ST_EMPTY, ST_DELETED (an entry was deleted,
+ *  so a key may be further on), or the top 7 bits of the hash of the key
+ *  of the entry in it, which pass over most of the keys that do not
+ *  match without calling the compare function.  A key is looked for from
+ *  the slot the low bits of its hash pick, one slot at a time, until an
+ *  empty slot.  Tables whose keys are compared by value (st_ptrcmp or
+ *  st_numcmp, with st_ptrhash or st_numhash) hash the keys themselves
+ *  and compare them in line.
+ *
+ *  The table is rehashed when more than 3/4 of its slots are in use or
+ *  deleted; it grows unless it only has to get rid of deleted slots.
+ */
+
+#define ST_EMPTY	0x80
+#define ST_DELETED	0x81
+#define ST_FULL(c)	((c) < 0x80)
+#define ST_FRAG(h)	((unsigned char) ((h) >> 25))
+#define ST_TOO_FULL(table, n)	(4 * (n) > 3 * (table)->num_bins)
+
+/* the modulus hash functions other than st's own are called with */
+#define ST_HASH_MODULUS	16777213	/* the largest prime below 2^24 */
+
 #define ST_NUMCMP(x,y) ((x) != (y))
 #define ST_NUMHASH(x,size) (ABS((int)x)%(size))
 #define ST_PTRHASH(x,size) ((int)((unsigned)(x)>>2)%size)
@@ -10,14 +33,61 @@
     ((((func) == st_numcmp) || ((func) == st_ptrcmp)) ?\
       (ST_NUMCMP((x),(y)) == 0) : ((*func)((x), (y)) == 0))
 
+static void rehash();
+int st_numhash(), st_ptrhash(), st_numcmp(), st_ptrcmp();
 
-#define do_hash(key, table)\
-    ((table->hash == st_ptrhash) ? ST_PTRHASH((key),(table)->num_bins) :\
-     (table->hash == st_numhash) ? ST_NUMHASH((key), (table)->num_bins) :\
-     (*table->hash)((key), (table)->num_bins))
 
-static rehash();
-int st_numhash(), st_ptrhash(), st_numcmp(), st_ptrcmp();
+/* spread the bits of a key (or of the hash of one) over all of the bits */
+static unsigned int
+st_mix(x)
+register unsigned long x;
+{
+    register unsigned int h;
+
+    h = (unsigned int) (x ^ (x >> 16 >> 16));
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    return h;
+}
+
+static unsigned int
+do_hash(table, key)
+register st_table *table;
+register char *key;
+{
+    register unsigned int val;
+    register int c;
+
+    if (table->hash == st_ptrhash || table->hash == st_numhash) {
+	return st_mix((unsigned long) key);
+    }
+    if (table->hash == st_strhash) {
+	val = 0;
+	while ((c = *key++) != '\0') {
+	    val = val*997 + c;
+	}
+	return st_mix((unsigned long) val);
+    }
+    val = (unsigned int) (*table->hash)(key, ST_HASH_MODULUS);
+    return st_mix((unsigned long) val);
+}
+
+
+/* allocate n (a power of 2) empty slots for 'table', ctrl bytes and all */
+static void
+alloc_bins(table, n)
+st_table *table;
+int n;
+{
+    table->num_bins = n;
+    table->bins = (st_table_entry *) ALLOC(char, n * (sizeof(st_table_entry) + 1));
+    table->ctrl = (unsigned char *) (table->bins + n);
+    (void) memset((char *) table->ctrl, ST_EMPTY, n);
+    table->num_deleted = 0;
+}
 
 st_table *st_init_table_with_params(compare, hash, size, density, grow_factor,
 				    reorder_flag)
@@ -28,24 +98,20 @@ int density;
 double grow_factor;
 int reorder_flag;
 {
-    int i;
     st_table *new;
+    int n;
 
     new = ALLOC(st_table, 1);
     new->compare = compare;
     new->hash = hash;
+    new->by_value = (compare == st_ptrcmp || compare == st_numcmp) &&
+			(hash == st_ptrhash || hash == st_numhash);
     new->num_entries = 0;
     new->max_density = density;
     new->grow_factor = grow_factor;
     new->reorder_flag = reorder_flag;
-    if (size <= 0) {
-	size = 1;
-    }
-    new->num_bins = size;
-    new->bins = ALLOC(st_table_entry *, size);
-    for(i = 0; i < size; i++) {
-	new->bins[i] = 0;
-    }
+    for(n = 8; n < size; n *= 2) ;
+    alloc_bins(new, n);
     return new;
 }
 
@@ -58,57 +124,109 @@ int (*hash)();
 				     ST_DEFAULT_GROW_FACTOR,
 				     ST_DEFAULT_REORDER_FLAG);
 }
-			    
+
 void
 st_free_table(table)
 st_table *table;
 {
-    register st_table_entry *ptr, *next;
-    int i;
+    FREE(table->bins);		/* and the ctrl bytes */
+    FREE(table);
+}
 
-    for(i = 0; i < table->num_bins ; i++) {
-	ptr = table->bins[i];
-	while (ptr != NIL(st_table_entry)) {
-	    next = ptr->next;
-	    FREE(ptr);
-	    ptr = next;
+
+/* the slot of 'key' (with hash h) in 'table', or -1 */
+static int
+find_slot(table, key, h)
+register st_table *table;
+register char *key;
+unsigned int h;
+{
+    register int i, mask = table->num_bins - 1;
+    register unsigned char c, frag = ST_FRAG(h);
+    register unsigned char *ctrl = table->ctrl;
+    register st_table_entry *bins = table->bins;
+
+    i = h & mask;
+    if (table->by_value) {
+	while ((c = ctrl[i]) != ST_EMPTY) {
+	    if (c == frag && bins[i].key == key) {
+		return i;
+	    }
+	    i = (i + 1) & mask;
+	}
+    } else {
+	while ((c = ctrl[i]) != ST_EMPTY) {
+	    if (c == frag && EQUAL(table->compare, key, bins[i].key)) {
+		return i;
+	    }
+	    i = (i + 1) & mask;
 	}
     }
-    FREE(table->bins);
-    FREE(table);
+    return -1;
 }
 
-#define PTR_NOT_EQUAL(table, ptr, user_key)\
-(ptr != NIL(st_table_entry) && !EQUAL(table->compare, user_key, (ptr)->key))
-
-#define FIND_ENTRY(table, hash_val, key, ptr, last) \
-    (last) = &(table)->bins[hash_val];\
-    (ptr) = *(last);\
-    while (PTR_NOT_EQUAL((table), (ptr), (key))) {\
-	(last) = &(ptr)->next; (ptr) = *(last);\
-    }\
-    if ((ptr) != NIL(st_table_entry) && (table)->reorder_flag) {\
-	*(last) = (ptr)->next;\
-	(ptr)->next = (table)->bins[hash_val];\
-	(table)->bins[hash_val] = (ptr);\
+
+/* put a new entry in 'table', without looking for 'key'; returns its slot */
+static int
+add_slot(table, key, value, h)
+register st_table *table;
+char *key;
+char *value;
+unsigned int h;
+{
+    register int i, mask;
+
+    if (ST_TOO_FULL(table, table->num_entries + table->num_deleted + 1)) {
+	rehash(table);
+    }
+    mask = table->num_bins - 1;
+    for(i = h & mask; ST_FULL(table->ctrl[i]); i = (i + 1) & mask) ;
+    if (table->ctrl[i] == ST_DELETED) {
+	table->num_deleted--;
+    }
+    table->ctrl[i] = ST_FRAG(h);
+    table->bins[i].key = key;
+    table->bins[i].record = value;
+    table->num_entries++;
+    return i;
+}
+
+
+/* empty slot i of 'table' */
+static void
+delete_slot(table, i)
+register st_table *table;
+register int i;
+{
+    register int mask = table->num_bins - 1;
+
+    table->num_entries--;
+    if (table->ctrl[(i + 1) & mask] != ST_EMPTY) {
+	table->ctrl[i] = ST_DELETED;
+	table->num_deleted++;
+	return;
+    }
+    /* no search goes past slot i: it, and deleted slots before it, are free */
+    table->ctrl[i] = ST_EMPTY;
+    for(i = (i + mask) & mask; table->ctrl[i] == ST_DELETED;
+						i = (i + mask) & mask) {
+	table->ctrl[i] = ST_EMPTY;
+	table->num_deleted--;
     }
+}
 
 st_lookup(table, key, value)
 st_table *table;
 register char *key;
 char **value;
 {
-    int hash_val;
-    register st_table_entry *ptr, **last;
-
-    hash_val = do_hash(key, table);
+    int i;
 
-    FIND_ENTRY(table, hash_val, key, ptr, last);
-    
-    if (ptr == NIL(st_table_entry)) {
+    i = find_slot(table, key, do_hash(table, key));
+    if (i < 0) {
 	return 0;
     } else {
-	if (value != NIL(char *))  *value = ptr->record; 
+	if (value != NIL(char *))  *value = table->bins[i].record;
 	return 1;
     }
 }
@@ -118,57 +236,34 @@ st_table *table;
 register char *key;
 int *value;
 {
-    int hash_val;
-    register st_table_entry *ptr, **last;
-
-    hash_val = do_hash(key, table);
+    int i;
 
-    FIND_ENTRY(table, hash_val, key, ptr, last);
-    
-    if (ptr == NIL(st_table_entry)) {
+    i = find_slot(table, key, do_hash(table, key));
+    if (i < 0) {
 	return 0;
     } else {
 	if (value != NIL(int)) {
-	    *value = (int) ptr->record;
+	    *value = (int) table->bins[i].record;
 	}
 	return 1;
     }
 }
 
-#define ADD_DIRECT(table, key, value, hash_val, new)\
-{\
-    if (table->num_entries/table->num_bins >= table->max_density) {\
-	rehash(table);\
-	hash_val = do_hash(key,table);\
-    }\
-    \
-    new = ALLOC(st_table_entry, 1);\
-    \
-    new->key = key;\
-    new->record = value;\
-    new->next = table->bins[hash_val];\
-    table->bins[hash_val] = new;\
-    table->num_entries++;\
-}
-
 st_insert(table, key, value)
 register st_table *table;
 register char *key;
 char *value;
 {
-    int hash_val;
-    st_table_entry *new;
-    register st_table_entry *ptr, **last;
-
-    hash_val = do_hash(key, table);
-
-    FIND_ENTRY(table, hash_val, key, ptr, last);
+    unsigned int h;
+    int i;
 
-    if (ptr == NIL(st_table_entry)) {
-	ADD_DIRECT(table,key,value,hash_val,new);
+    h = do_hash(table, key);
+    i = find_slot(table, key, h);
+    if (i < 0) {
+	(void) add_slot(table, key, value, h);
 	return 0;
     } else {
-	ptr->record = value;
+	table->bins[i].record = value;
 	return 1;
     }
 }
@@ -178,31 +273,27 @@ st_table *table;
 char *key;
 char *value;
 {
-    int hash_val;
-    st_table_entry *new;
-    
-    hash_val = do_hash(key, table);
-    ADD_DIRECT(table, key, value, hash_val, new);
+    (void) add_slot(table, key, value, do_hash(table, key));
+    return 0;
 }
 
+/* the slot pointer stays good until an entry is added to the table */
 st_find_or_add(table, key, slot)
 st_table *table;
 char *key;
 char ***slot;
 {
-    int hash_val;
-    st_table_entry *new, *ptr, **last;
-
-    hash_val = do_hash(key, table);
-
-    FIND_ENTRY(table, hash_val, key, ptr, last);
+    unsigned int h;
+    int i;
 
-    if (ptr == NIL(st_table_entry)) {
-	ADD_DIRECT(table, key, (char *)0, hash_val, new)
-	if (slot != NIL(char **)) *slot = &new->record;
+    h = do_hash(table, key);
+    i = find_slot(table, key, h);
+    if (i < 0) {
+	i = add_slot(table, key, NIL(char), h);
+	if (slot != NIL(char **)) *slot = &table->bins[i].record;
 	return 0;
     } else {
-	if (slot != NIL(char **)) *slot = &ptr->record;
+	if (slot != NIL(char **)) *slot = &table->bins[i].record;
 	return 1;
     }
 }
@@ -212,48 +303,42 @@ st_table *table;
 char *key;
 char ***slot;
 {
-    int hash_val;
-    st_table_entry *ptr, **last;
-
-    hash_val = do_hash(key, table);
-
-    FIND_ENTRY(table, hash_val, key, ptr, last);
+    int i;
 
-    if (ptr == NIL(st_table_entry)) {
+    i = find_slot(table, key, do_hash(table, key));
+    if (i < 0) {
 	return 0;
     } else {
-	if (slot != NIL(char **)) *slot = &ptr->record;
+	if (slot != NIL(char **)) *slot = &table->bins[i].record;
 	return 1;
     }
 }
 
-static rehash(table)
+static void
+rehash(table)
 register st_table *table;
 {
-    register st_table_entry *ptr, *next, **old_bins = table->bins;
-    int i, old_num_bins = table->num_bins, hash_val;
-
-    table->num_bins = table->grow_factor*old_num_bins;
-    
-    if (table->num_bins%2 == 0) {
-	table->num_bins += 1;
-    }
-    
-    table->num_entries = 0;
-    table->bins = ALLOC(st_table_entry *, table->num_bins);
-    for(i = 0; i < table->num_bins; i++) {
-	table->bins[i] = 0;
+    register st_table_entry *old_bins = table->bins;
+    register unsigned char *old_ctrl = table->ctrl;
+    int i, old_num_bins = table->num_bins, n, mask, j;
+    unsigned int h;
+
+    /* grow, unless getting rid of the deleted slots leaves enough room */
+    n = old_num_bins;
+    if (ST_TOO_FULL(table, 2 * (table->num_entries + 1))) {
+	do {
+	    n *= 2;
+	} while (n < old_num_bins * table->grow_factor);
     }
-
-    for(i = 0; i < old_num_bins ; i++) {
-	ptr = old_bins[i];
-	while (ptr != NIL(st_table_entry)) {
-	    next = ptr->next;
-	    hash_val = do_hash(ptr->key, table);
-	    ptr->next = table->bins[hash_val];
-	    table->bins[hash_val] = ptr;
-	    table->num_entries++;
-	    ptr = next;
+    alloc_bins(table, n);
+    mask = n - 1;
+
+    for(i = 0; i < old_num_bins; i++) {
+	if (ST_FULL(old_ctrl[i])) {
+	    h = do_hash(table, old_bins[i].key);
+	    for(j = h & mask; table->ctrl[j] != ST_EMPTY; j = (j + 1) & mask) ;
+	    table->ctrl[j] = ST_FRAG(h);
+	    table->bins[j] = old_bins[i];
 	}
     }
     FREE(old_bins);
@@ -263,38 +348,22 @@ st_table *st_copy(old_table)
 st_table *old_table;
 {
     st_table *new_table;
-    st_table_entry *ptr, *new;
-    int i, num_bins = old_table->num_bins;
+    int size = old_table->num_bins * (sizeof(st_table_entry) + 1);
 
     new_table = ALLOC(st_table, 1);
     if (new_table == NIL(st_table)) {
 	return NIL(st_table);
     }
-    
+
     *new_table = *old_table;
-    new_table->bins = ALLOC(st_table_entry *, num_bins);
-    
-    if (new_table->bins == NIL(st_table_entry *)) {
+    new_table->bins = (st_table_entry *) ALLOC(char, size);
+
+    if (new_table->bins == NIL(st_table_entry)) {
 	FREE(new_table);
 	return NIL(st_table);
     }
-
-    for(i = 0; i < num_bins ; i++) {
-	new_table->bins[i] = NIL(st_table_entry);
-	ptr = old_table->bins[i];
-	while (ptr != NIL(st_table_entry)) {
-	    new = ALLOC(st_table_entry, 1);
-	    if (new == NIL(st_table_entry)) {
-		FREE(new_table->bins);
-		FREE(new_table);
-		return NIL(st_table);
-	    }
-	    *new = *ptr;
-	    new->next = new_table->bins[i];
-	    new_table->bins[i] = new;
-	    ptr = ptr->next;
-	}
-    }
+    (void) memcpy((char *) new_table->bins, (char *) old_table->bins, size);
+    new_table->ctrl = (unsigned char *) (new_table->bins + new_table->num_bins);
     return new_table;
 }
 
@@ -303,23 +372,17 @@ register st_table *table;
 register char **keyp;
 char **value;
 {
-    int hash_val;
     char *key = *keyp;
-    register st_table_entry *ptr, **last;
-
-    hash_val = do_hash(key, table);
+    int i;
 
-    FIND_ENTRY(table, hash_val, key, ptr ,last);
-    
-    if (ptr == NIL(st_table_entry)) {
+    i = find_slot(table, key, do_hash(table, key));
+    if (i < 0) {
 	return 0;
     }
 
-    *last = ptr->next;
-    if (value != NIL(char *)) *value = ptr->record;
-    *keyp = ptr->key;
-    FREE(ptr);
-    table->num_entries--;
+    if (value != NIL(char *)) *value = table->bins[i].record;
+    *keyp = table->bins[i].key;
+    delete_slot(table, i);
     return 1;
 }
 
@@ -328,23 +391,17 @@ register st_table *table;
 register int *keyp;
 char **value;
 {
-    int hash_val;
     char *key = (char *) *keyp;
-    register st_table_entry *ptr, **last;
-
-    hash_val = do_hash(key, table);
-
-    FIND_ENTRY(table, hash_val, key, ptr ,last);
+    int i;
 
-    if (ptr == NIL(st_table_entry)) {
+    i = find_slot(table, key, do_hash(table, key));
+    if (i < 0) {
         return 0;
     }
 
-    *last = ptr->next;
-    if (value != NIL(char *)) *value = ptr->record;
-    *keyp = (int) ptr->key;
-    FREE(ptr);
-    table->num_entries--;
+    if (value != NIL(char *)) *value = table->bins[i].record;
+    *keyp = (int) table->bins[i].key;
+    delete_slot(table, i);
     return 1;
 }
 
@@ -354,26 +411,24 @@ st_table *table;
 enum st_retval (*func)();
 char *arg;
 {
-    st_table_entry *ptr, **last;
+    st_table_entry *ptr;
     enum st_retval retval;
     int i;
 
     for(i = 0; i < table->num_bins; i++) {
-	last = &table->bins[i]; ptr = *last;
-	while (ptr != NIL(st_table_entry)) {
-	    retval = (*func)(ptr->key, ptr->record, arg);
-	    switch (retval) {
-	    case ST_CONTINUE:
-		last = &ptr->next; ptr = *last;
-		break;
-	    case ST_STOP:
-		return 0;
-	    case ST_DELETE:
-		*last = ptr->next;
-		table->num_entries--;	/* cstevens@ic */
-		FREE(ptr);
-		ptr = *last;
-	    }
+	if (! ST_FULL(table->ctrl[i])) {
+	    continue;
+	}
+	ptr = table->bins + i;
+	retval = (*func)(ptr->key, ptr->record, arg);
+	switch (retval) {
+	case ST_CONTINUE:
+	    break;
+	case ST_STOP:
+	    return 0;
+	case ST_DELETE:
+	    delete_slot(table, i);	/* moves no other entry */
+	    break;
 	}
     }
     return 1;
@@ -385,7 +440,7 @@ int modulus;
 {
     register int val = 0;
     register int c;
-    
+
     while ((c = *string++) != '\0') {
 	val = val*997 + c;
     }
@@ -420,7 +475,7 @@ char *y;
 {
     return ST_NUMCMP(x, y);
 }
-
+
 st_generator *
 st_init_gen(table)
 st_table *table;
@@ -429,67 +484,52 @@ st_table *table;
 
     gen = ALLOC(st_generator, 1);
     gen->table = table;
-    gen->entry = NIL(st_table_entry);
     gen->index = 0;
     return gen;
 }
 
 
-int 
+int
 st_gen(gen, key_p, value_p)
 st_generator *gen;
 char **key_p;
 char **value_p;
 {
+    register st_table *table = gen->table;
     register int i;
 
-    if (gen->entry == NIL(st_table_entry)) {
-	/* try to find next entry */
-	for(i = gen->index; i < gen->table->num_bins; i++) {
-	    if (gen->table->bins[i] != NIL(st_table_entry)) {
-		gen->index = i+1;
-		gen->entry = gen->table->bins[i];
-		break;
-	    }
-	}
-	if (gen->entry == NIL(st_table_entry)) {
-	    return 0;		/* that's all folks ! */
+    while (gen->index < table->num_bins) {
+	i = gen->index++;
+	if (ST_FULL(table->ctrl[i])) {
+	    *key_p = table->bins[i].key;
+	    if (value_p != 0) *value_p = table->bins[i].record;
+	    return 1;
 	}
     }
-    *key_p = gen->entry->key;
-    if (value_p != 0) *value_p = gen->entry->record;
-    gen->entry = gen->entry->next;
-    return 1;
+    return 0;		/* that's all folks ! */
 }
 
 
-int 
+int
 st_gen_int(gen, key_p, value_p)
 st_generator *gen;
 char **key_p;
 int *value_p;
 {
+    register st_table *table = gen->table;
     register int i;
 
-    if (gen->entry == NIL(st_table_entry)) {
-	/* try to find next entry */
-	for(i = gen->index; i < gen->table->num_bins; i++) {
-	    if (gen->table->bins[i] != NIL(st_table_entry)) {
-		gen->index = i+1;
-		gen->entry = gen->table->bins[i];
-		break;
+    while (gen->index < table->num_bins) {
+	i = gen->index++;
+	if (ST_FULL(table->ctrl[i])) {
+	    *key_p = table->bins[i].key;
+	    if (value_p != NIL(int)) {
+		*value_p = (int) table->bins[i].record;
 	    }
+	    return 1;
 	}
-	if (gen->entry == NIL(st_table_entry)) {
-	    return 0;		/* that's all folks ! */
-	}
-    }
-    *key_p = gen->entry->key;
-    if (value_p != NIL(int)) {
-   	*value_p = (int) gen->entry->record;
     }
-    gen->entry = gen->entry->next;
-    return 1;
+    return 0;		/* that's all folks ! */
 }
 
 
@@ -1,33 +1,39 @@
-
 /* LINTLIBRARY */
 
 
 #ifndef ST_INCLUDED
 #define ST_INCLUDED
 
+/*
+ *  The table is open-addressed: the entries are kept in one array of
+ *  slots, probed linearly from the slot the hash of a key picks, and a
+ *  byte per slot (ctrl) tells whether the slot is empty, deleted, or
+ *  holds an entry whose hash has the bits kept in the byte.
+ */
 typedef struct st_table_entry st_table_entry;
 struct st_table_entry {
     char *key;
     char *record;
-    st_table_entry *next;
 };
 
 typedef struct st_table st_table;
 struct st_table {
     int (*compare)();
     int (*hash)();
-    int num_bins;
+    int num_bins;		/* number of slots, a power of 2 */
     int num_entries;
-    int max_density;
-    int reorder_flag;
+    int num_deleted;		/* slots of deleted entries */
+    int max_density;		/* unused, see st_init_table_with_params() */
+    int reorder_flag;		/* unused, see st_init_table_with_params() */
+    int by_value;		/* keys hashed and compared by their value */
     double grow_factor;
-    st_table_entry **bins;
+    st_table_entry *bins;	/* the slots */
+    unsigned char *ctrl;	/* state of each slot */
 };
 
 typedef struct st_generator st_generator;
 struct st_generator {
     st_table *table;
-    st_table_entry *entry;
     int index;
 };
 
@@ -56,7 +62,7 @@ EXTERN int st_numhash ARGS((char *, int));
 EXTERN int st_ptrhash ARGS((char *, int));
 EXTERN int st_numcmp ARGS((char *, char *));
 EXTERN int st_ptrcmp ARGS((char *, char *));
-EXTERN st_table *st_init_table ARGS((ST_PFI, ST_PFI)); 
+EXTERN st_table *st_init_table ARGS((ST_PFI, ST_PFI));
 EXTERN st_table *st_init_table_with_params ARGS((ST_PFI, ST_PFI, int, int, double, int));
 EXTERN st_table *st_copy ARGS((st_table *));
 EXTERN st_generator *st_init_gen ARGS((st_table *));
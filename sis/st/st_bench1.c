@@ -1,66 +1,370 @@
-
 #include <stdio.h>
 #include "array.h"
 #include "st.h"
 #include "util.h"
 
+/*
+ *  st_bench1 [-n count] [-r rounds] [words]
+ *
+ *  Times st_insert() and st_lookup() (for keys in the table and keys
+ *  not in it) with pointer, integer and string keys, for st and for the
+ *  chained table st used to be (old_ below, a copy of its insert and
+ *  lookup).  The string keys are the lines of 'words' if it is given,
+ *  made up otherwise; all of the keys are used in a random order.
+ *  Prints millions of operations per cpu second.
+ */
+
 #define MAX_WORD	1024
 
 extern long random();
 
+
+/* the old chained table, with its default parameters */
+
+typedef struct old_entry old_entry;
+struct old_entry {
+    char *key;
+    char *record;
+    old_entry *next;
+};
+
+typedef struct {
+    int (*compare)();
+    int (*hash)();
+    int num_bins;
+    int num_entries;
+    old_entry **bins;
+} old_table;
+
+#define OLD_NUMHASH(x,size) (ABS((int)x)%(size))
+#define OLD_PTRHASH(x,size) ((int)((unsigned)(x)>>2)%size)
+#define OLD_EQUAL(func, x, y) \
+    ((((func) == st_numcmp) || ((func) == st_ptrcmp)) ?\
+      ((x) == (y)) : ((*func)((x), (y)) == 0))
+#define old_hash(key, table)\
+    ((table->hash == st_ptrhash) ? OLD_PTRHASH((key),(table)->num_bins) :\
+     (table->hash == st_numhash) ? OLD_NUMHASH((key), (table)->num_bins) :\
+     (*table->hash)((key), (table)->num_bins))
+
+static old_table *
+old_init_table(compare, hash)
+int (*compare)();
+int (*hash)();
+{
+    old_table *new;
+    int i;
+
+    new = ALLOC(old_table, 1);
+    new->compare = compare;
+    new->hash = hash;
+    new->num_entries = 0;
+    new->num_bins = ST_DEFAULT_INIT_TABLE_SIZE;
+    new->bins = ALLOC(old_entry *, new->num_bins);
+    for(i = 0; i < new->num_bins; i++) {
+	new->bins[i] = 0;
+    }
+    return new;
+}
+
+static void
+old_free_table(table)
+old_table *table;
+{
+    old_entry *ptr, *next;
+    int i;
+
+    for(i = 0; i < table->num_bins; i++) {
+	for(ptr = table->bins[i]; ptr != 0; ptr = next) {
+	    next = ptr->next;
+	    FREE(ptr);
+	}
+    }
+    FREE(table->bins);
+    FREE(table);
+}
+
+static void
+old_rehash(table)
+old_table *table;
+{
+    old_entry *ptr, *next, **old_bins = table->bins;
+    int i, old_num_bins = table->num_bins, hash_val;
+
+    table->num_bins = ST_DEFAULT_GROW_FACTOR * old_num_bins;
+    if (table->num_bins % 2 == 0) {
+	table->num_bins += 1;
+    }
+    table->bins = ALLOC(old_entry *, table->num_bins);
+    for(i = 0; i < table->num_bins; i++) {
+	table->bins[i] = 0;
+    }
+    for(i = 0; i < old_num_bins; i++) {
+	for(ptr = old_bins[i]; ptr != 0; ptr = next) {
+	    next = ptr->next;
+	    hash_val = old_hash(ptr->key, table);
+	    ptr->next = table->bins[hash_val];
+	    table->bins[hash_val] = ptr;
+	}
+    }
+    FREE(old_bins);
+}
+
+static int
+old_lookup(table, key, value)
+old_table *table;
+char *key;
+char **value;
+{
+    old_entry *ptr;
+
+    ptr = table->bins[old_hash(key, table)];
+    while (ptr != 0 && ! OLD_EQUAL(table->compare, key, ptr->key)) {
+	ptr = ptr->next;
+    }
+    if (ptr == 0) {
+	return 0;
+    }
+    if (value != NIL(char *)) *value = ptr->record;
+    return 1;
+}
+
+static int
+old_insert(table, key, value)
+old_table *table;
+char *key;
+char *value;
+{
+    old_entry *ptr;
+    int hash_val;
+
+    hash_val = old_hash(key, table);
+    ptr = table->bins[hash_val];
+    while (ptr != 0 && ! OLD_EQUAL(table->compare, key, ptr->key)) {
+	ptr = ptr->next;
+    }
+    if (ptr != 0) {
+	ptr->record = value;
+	return 1;
+    }
+    if (table->num_entries/table->num_bins >= ST_DEFAULT_MAX_DENSITY) {
+	old_rehash(table);
+	hash_val = old_hash(key, table);
+    }
+    ptr = ALLOC(old_entry, 1);
+    ptr->key = key;
+    ptr->record = value;
+    ptr->next = table->bins[hash_val];
+    table->bins[hash_val] = ptr;
+    table->num_entries++;
+    return 0;
+}
+
+
+static int
+word_compare(p1, p2)
+char **p1, **p2;
+{
+    return strcmp(*p1, *p2);
+}
+
+static void
+word_free(p)
+char **p;
+{
+    FREE(*p);
+}
+
+/* put keys[0..n-1] in a random order */
+static void
+scramble(keys, n)
+char **keys;
+int n;
+{
+    char *temp;
+    int i, j;
+
+    for(i = n-1; i >= 1; i--) {
+	j = random() % i;
+	temp = keys[i];
+	keys[i] = keys[j];
+	keys[j] = temp;
+    }
+}
+
+static double
+rate(n, time)
+int n;
+long time;
+{
+    return time > 0 ? n / (1000.0 * time) : 0.0;
+}
+
+/*
+ *  bench -- insert keys[0..n-1], look them up 'rounds' times, and look
+ *  up keys[n..2n-1] (not in the table) 'rounds' times, with both tables
+ */
+static void
+bench(name, keys, n, rounds, compare, hash)
+char *name;
+char **keys;
+int n, rounds;
+int (*compare)();
+int (*hash)();
+{
+    st_table *table;
+    old_table *otable;
+    char *value;
+    long time, t_insert[2], t_hit[2], t_miss[2];
+    int i, r, found[2], missed[2];
+
+    /* once untimed, so that neither gets memory from the system first */
+    table = st_init_table(compare, hash);
+    otable = old_init_table(compare, hash);
+    for(i = 0; i < n; i++) {
+	(void) st_insert(table, keys[i], NIL(char));
+	(void) old_insert(otable, keys[i], NIL(char));
+    }
+    st_free_table(table);
+    old_free_table(otable);
+
+    time = util_cpu_time();
+    table = st_init_table(compare, hash);
+    for(i = 0; i < n; i++) {
+	(void) st_insert(table, keys[i], (char *) (long) i);
+    }
+    t_insert[0] = util_cpu_time() - time;
+    time = util_cpu_time();
+    found[0] = 0;
+    for(r = 0; r < rounds; r++) {
+	for(i = 0; i < n; i++) {
+	    if (st_lookup(table, keys[i], &value) && value == (char *) (long) i) {
+		found[0]++;
+	    }
+	}
+    }
+    t_hit[0] = util_cpu_time() - time;
+    time = util_cpu_time();
+    missed[0] = 0;
+    for(r = 0; r < rounds; r++) {
+	for(i = n; i < 2 * n; i++) {
+	    missed[0] += ! st_is_member(table, keys[i]);
+	}
+    }
+    t_miss[0] = util_cpu_time() - time;
+    st_free_table(table);
+
+    time = util_cpu_time();
+    otable = old_init_table(compare, hash);
+    for(i = 0; i < n; i++) {
+	(void) old_insert(otable, keys[i], (char *) (long) i);
+    }
+    t_insert[1] = util_cpu_time() - time;
+    time = util_cpu_time();
+    found[1] = 0;
+    for(r = 0; r < rounds; r++) {
+	for(i = 0; i < n; i++) {
+	    if (old_lookup(otable, keys[i], &value) && value == (char *) (long) i) {
+		found[1]++;
+	    }
+	}
+    }
+    t_hit[1] = util_cpu_time() - time;
+    time = util_cpu_time();
+    missed[1] = 0;
+    for(r = 0; r < rounds; r++) {
+	for(i = n; i < 2 * n; i++) {
+	    missed[1] += ! old_lookup(otable, keys[i], NIL(char *));
+	}
+    }
+    t_miss[1] = util_cpu_time() - time;
+    old_free_table(otable);
+
+    for(i = 0; i < 2; i++) {
+	(void) printf("%-8s %-4s %10.2f %10.2f %10.2f%s\n", name,
+	    i == 0 ? "st" : "old", rate(n, t_insert[i]),
+	    rate(n * rounds, t_hit[i]), rate(n * rounds, t_miss[i]),
+	    found[i] == n * rounds && missed[i] == n * rounds ? "" : "  WRONG");
+    }
+}
+
 /* ARGSUSED */
 main(argc, argv)
-char *argv;
+int argc;
+char **argv;
 {
     array_t *words;
-    st_table *table;
-    char word[MAX_WORD], *tempi, *tempj;
-    register int i, j;
-    long time;
-#ifdef TEST
-    st_generator *gen;
-    char *key;
-#endif
+    char **keys, word[MAX_WORD], *temp, *p;
+    int i, n, rounds;
+    FILE *fp;
 
-    /* read the words */
-    words = array_alloc(char *, 1000);
-    while (gets(word) != NIL(char)) {
-	array_insert_last(char *, words, util_strsav(word));
-#ifdef TEST
-	if (array_n(words) == 25) break;
-#endif
+    n = 100000;
+    rounds = 10;
+    while ((i = util_getopt(argc, argv, "n:r:")) != EOF) {
+	switch (i) {
+	case 'n':
+	    n = atoi(util_optarg);
+	    break;
+	case 'r':
+	    rounds = atoi(util_optarg);
+	    break;
+	default:
+	    (void) fprintf(stderr, "usage: st_bench1 [-n count] [-r rounds] [words]\n");
+	    exit(2);
+	}
     }
+    keys = ALLOC(char *, 2 * n);
+    (void) printf("%d keys, %d lookups each: millions per second\n", n, rounds);
+    (void) printf("%-8s %-4s %10s %10s %10s\n", "keys", "", "insert", "hit", "miss");
 
-    /* scramble them */
-    for(i = array_n(words)-1; i >= 1; i--) {
-	j = random() % i;
-	tempi = array_fetch(char *, words, i);
-	tempj = array_fetch(char *, words, j);
-	array_insert(char *, words, i, tempj);
-	array_insert(char *, words, j, tempi);
+    /* pointers */
+    for(i = 0; i < 2 * n; i++) {
+	keys[i] = ALLOC(char, 24);
+    }
+    scramble(keys, 2 * n);
+    bench("pointer", keys, n, rounds, st_ptrcmp, st_ptrhash);
+    for(i = 0; i < 2 * n; i++) {
+	FREE(keys[i]);
     }
 
-#ifdef TEST
-    (void) printf("Initial data is\n");
-    for(i = array_n(words)-1; i >= 0; i--) {
-	(void) printf("%s\n", array_fetch(char *, words, i));
+    /* integers: the first n, and every other one of the next 2n missing */
+    for(i = 0; i < n; i++) {
+	keys[i] = (char *) (long) i;
+	keys[n + i] = (char *) (long) (n + 2 * i + 1);
     }
-#endif
+    scramble(keys, n);
+    scramble(keys + n, n);
+    bench("integer", keys, n, rounds, st_numcmp, st_numhash);
 
-    /* time putting them into an st tree */
-    time = util_cpu_time();
-    table = st_init_table(strcmp, st_strhash);
-    for(i = array_n(words)-1; i >= 0; i--) {
-	(void) st_insert(table, array_fetch(char *, words, i), NIL(char));
+    /* strings: the words given (or made up), scrambled */
+    words = array_alloc(char *, 1000);
+    if (util_optind < argc) {
+	if ((fp = fopen(argv[util_optind], "r")) == NULL) {
+	    perror(argv[util_optind]);
+	    exit(1);
+	}
+	while (array_n(words) < 2 * n && fgets(word, MAX_WORD, fp) != NULL) {
+	    if ((p = strchr(word, '\n')) != NULL) *p = '\0';
+	    array_insert_last(char *, words, util_strsav(word));
+	}
+	(void) fclose(fp);
+	array_sort(words, word_compare);
+	array_uniq(words, word_compare, word_free);
+    }
+    for(i = 0; array_n(words) < 2 * n; i++) {
+	(void) sprintf(word, "n%d_%lx", i, random());
+	array_insert_last(char *, words, util_strsav(word));
+    }
+    for(i = 0; i < 2 * n; i++) {
+	keys[i] = array_fetch(char *, words, i);
     }
-    (void) printf("Elapsed time for insert of %d objects was %s\n",
-	array_n(words), util_print_time(util_cpu_time() - time));
+    scramble(keys, 2 * n);
+    bench("string", keys, n, rounds, strcmp, st_strhash);
 
-#ifdef TEST
-    (void) printf("st data is\n");
-    st_foreach_item(table, gen, &key, NIL(char *)) {
-	(void) printf("%s\n", key);
+    for(i = 0; i < array_n(words); i++) {
+	temp = array_fetch(char *, words, i);
+	FREE(temp);
     }
-#endif
+    array_free(words);
+    FREE(keys);
     return 0;
 }